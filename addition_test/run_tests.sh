@@ -0,0 +1,196 @@
+#!/bin/bash
+
+# Run the assembly cases in addition_test/ under the option sets that matter for them
+# and check the final memory against the values listed in each .S header.
+#
+# Usage (after make):
+#   ./addition_test/run_tests.sh
+
+set -u
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+SIM="$SCRIPT_DIR/../build/tomasulo"
+FAILED=0
+
+# Print the final memory as "int ADDR VALUE" / "fp ADDR VALUE" lines
+final_memory() {
+    "$SIM" --quiet "$@" | awk '
+        /memory int data/ { cls = "int"; next }
+        /memory fp data/  { cls = "fp"; next }
+        /statistics/      { cls = "" }
+        cls != "" {
+            n = split($0, parts, "}")
+            for (i = 1; i <= n; i++) {
+                if (match(parts[i], /[-0-9.e+]+ : [-0-9.e+a-z]+/)) {
+                    split(substr(parts[i], RSTART, RLENGTH), kv, " : ")
+                    print cls, kv[1], kv[2]
+                }
+            }
+        }'
+}
+
+# check PROGRAM "OPTIONS" "CLASS ADDR VALUE"...
+check() {
+    local prog="$1" opts="$2"
+    shift 2
+    local mem
+    # shellcheck disable=SC2086
+    if ! mem=$(final_memory $opts "$SCRIPT_DIR/$prog"); then
+        echo "FAIL $prog [$opts]: simulator error"
+        FAILED=1
+        return
+    fi
+    for want in "$@"; do
+        if ! grep -qxF "$want" <<< "$mem"; then
+            echo "FAIL $prog [$opts]: expected $want"
+            FAILED=1
+            return
+        fi
+    done
+    echo "ok   $prog [$opts]"
+}
+
+# check_cdbs PROGRAM "OPTIONS" N: no cycle lists more than N CDB broadcasts
+check_cdbs() {
+    local prog="$1" opts="$2" limit="$3" most
+    # shellcheck disable=SC2086
+    most=$("$SIM" $opts "$SCRIPT_DIR/$prog" | awk '
+        /CYCLE/ { if (n > m) m = n; n = 0; in_cdb = 0 }
+        /CDB Broadcasts:/ { in_cdb = 1; next }
+        in_cdb && /->/ { n++ }
+        END { if (n > m) m = n; print m + 0 }')
+    if [ "$most" -gt "$limit" ]; then
+        echo "FAIL $prog [$opts]: $most CDB broadcasts in one cycle, limit $limit"
+        FAILED=1
+        return
+    fi
+    echo "ok   $prog [$opts] cdb <= $limit"
+}
+
+# check_trace PROGRAM "OPTIONS": capture the committed stream with --trace_out,
+# replay it with --trace under the same options; cycles and IPC must match
+check_trace() {
+    local prog="$1" opts="$2" trace direct replay
+    trace=$(mktemp)
+    # shellcheck disable=SC2086
+    direct=$("$SIM" --quiet $opts --trace_out="$trace" "$SCRIPT_DIR/$prog" | grep -m2 -E '^(cycles|IPC) ')
+    # shellcheck disable=SC2086
+    replay=$("$SIM" --quiet $opts --trace="$trace" | grep -m2 -E '^(cycles|IPC) ')
+    rm -f "$trace"
+    if [ -z "$direct" ] || [ "$direct" != "$replay" ]; then
+        echo "FAIL $prog [$opts]: trace replay gave" $replay "instead of" $direct
+        FAILED=1
+        return
+    fi
+    echo "ok   $prog [$opts] trace replay"
+}
+
+# Expected final memory, copied from the header of each .S
+VEC_EPILOGUE=("fp 4096 24" "int 4192 4618441417868443648")
+LOOP_SUM=("int 216 1" "int 272 8" "int 280 36" "int 288 4")
+WORD_OPS=("int 328 17179869177" "int 336 18446743979245438458" "int 344 536870911" "int 352 384")
+SUBWORD_MERGE=("int 4416 1234605616436521864" "int 4424 287454020" "int 4432 12321849316357863304"
+    "int 4440 26283" "int 4448 18446744072283488427" "int 4456 8613134287346073600"
+    "int 4464 21862" "int 4472 1073741824" "fp 4384 2")
+MEM_DEP_ALIAS=("int 4352 4616189618054758400" "int 4360 4616189618054758400"
+    "int 4384 4611686018427387904" "fp 4368 8" "fp 4376 2")
+MOVE_ELIM_CDB=("int 4352 42" "int 4360 48" "int 4368 49" "int 4376 13")
+FUSION_PAIRS=("int 4352 305419896" "int 4360 305419897" "int 4368 305419901" "int 4376 68"
+    "int 4384 7" "int 4392 5")
+
+check vec_epilogue.bin "" "${VEC_EPILOGUE[@]}"
+check loop_sum.bin "" "${LOOP_SUM[@]}"
+check word_ops.bin "" "${WORD_OPS[@]}"
+
+for opts in "" "--store_buffer=4" "--mem_dep=conservative"; do
+    check subword_merge.bin "$opts" "${SUBWORD_MERGE[@]}"
+done
+
+for mode in store_set conservative; do
+    check mem_dep_alias.bin "--mem_dep=$mode" "${MEM_DEP_ALIAS[@]}"
+done
+
+# Prefetchers only change timing: the final memory must not change
+for pf in stride stream; do
+    for opts in "--prefetcher=$pf" "--prefetcher=$pf --dram=on --mshrs=4"; do
+        check loop_sum.bin "$opts" "${LOOP_SUM[@]}"
+        check vec_epilogue.bin "$opts" "${VEC_EPILOGUE[@]}"
+        check subword_merge.bin "$opts" "${SUBWORD_MERGE[@]}"
+    done
+done
+
+# Physical register file with one or two free registers per class, so rename
+# stalls on nearly every instruction and registers are recycled constantly
+for size in 33 34; do
+    for opts in "--rename=prf --prf_int_size=$size --prf_fp_size=$size" \
+                "--rename=prf --prf_int_size=$size --prf_fp_size=$size --move_elim=on --fetch_width=4"; do
+        check loop_sum.bin "$opts" "${LOOP_SUM[@]}"
+        check word_ops.bin "$opts" "${WORD_OPS[@]}"
+        check vec_epilogue.bin "$opts" "${VEC_EPILOGUE[@]}"
+        check mem_dep_alias.bin "$opts" "${MEM_DEP_ALIAS[@]}"
+        check subword_merge.bin "$opts" "${SUBWORD_MERGE[@]}"
+        check move_elim_cdb.bin "$opts" "${MOVE_ELIM_CDB[@]}"
+    done
+done
+
+# Macro-op fusion pairs instructions within a fetch group, so it needs a fetch width above 1
+check fusion_pairs.bin "" "${FUSION_PAIRS[@]}"
+for width in 2 4; do
+    for opts in "--fusion=all --fetch_width=$width" "--fusion=all --fetch_width=$width --rename=prf"; do
+        check fusion_pairs.bin "$opts" "${FUSION_PAIRS[@]}"
+        check loop_sum.bin "$opts" "${LOOP_SUM[@]}"
+        check word_ops.bin "$opts" "${WORD_OPS[@]}"
+        check subword_merge.bin "$opts" "${SUBWORD_MERGE[@]}"
+    done
+done
+
+# Post-commit store buffer: loads read pending bytes from it, and stores to a
+# line that is still buffered (more often with the L1D on, where draining
+# waits for misses) coalesce into it, including sub-word stores
+for opts in "--store_buffer=1" "--store_buffer=2 --sb_drain=2 --dcache=on" \
+            "--store_buffer=8 --dcache=on --dram=on" "--store_buffer=2 --rename=prf --fetch_width=4"; do
+    check loop_sum.bin "$opts" "${LOOP_SUM[@]}"
+    check word_ops.bin "$opts" "${WORD_OPS[@]}"
+    check vec_epilogue.bin "$opts" "${VEC_EPILOGUE[@]}"
+    check mem_dep_alias.bin "$opts" "${MEM_DEP_ALIAS[@]}"
+    check subword_merge.bin "$opts" "${SUBWORD_MERGE[@]}"
+    check fusion_pairs.bin "$opts" "${FUSION_PAIRS[@]}"
+done
+
+# Loop buffer: 8 entries is too small for either loop, 16 and 64 capture it and
+# replay it until the loop exits
+for n in 8 16 64; do
+    for opts in "--loop_buffer=$n" "--loop_buffer=$n --fetch_width=4" \
+                "--loop_buffer=$n --rename=prf --fusion=all --fetch_width=2 --store_buffer=2"; do
+        check loop_sum.bin "$opts" "${LOOP_SUM[@]}"
+        check word_ops.bin "$opts" "${WORD_OPS[@]}"
+    done
+done
+
+# Trace-driven mode replays the committed stream with the captured addresses
+for prog in loop_sum.bin word_ops.bin vec_epilogue.bin mem_dep_alias.bin subword_merge.bin fusion_pairs.bin; do
+    for opts in "" "--fetch_width=4 --dcache=on"; do
+        check_trace "$prog" "$opts"
+    done
+done
+
+# Capturing a trace must not change the run itself, and the capture must hold
+# enough to reproduce the timing under the rename, store buffer, fusion,
+# loop buffer and memory hierarchy options
+TRACE_TMP=$(mktemp)
+check loop_sum.bin "--trace_out=$TRACE_TMP" "${LOOP_SUM[@]}"
+check subword_merge.bin "--trace_out=$TRACE_TMP --store_buffer=4" "${SUBWORD_MERGE[@]}"
+rm -f "$TRACE_TMP"
+for prog in loop_sum.bin word_ops.bin subword_merge.bin fusion_pairs.bin move_elim_cdb.bin; do
+    for opts in "--rename=prf --store_buffer=4 --move_elim=on" "--fusion=all --fetch_width=2 --loop_buffer=16" \
+                "--dcache=on --dram=on --prefetcher=stride --mshrs=4"; do
+        check_trace "$prog" "$opts"
+    done
+done
+
+for opts in "--cdbs=1" "--cdbs=1 --fetch_width=4"; do
+    check move_elim_cdb.bin "$opts" "${MOVE_ELIM_CDB[@]}"
+    check_cdbs move_elim_cdb.bin "$opts" 1
+done
+
+exit $FAILED
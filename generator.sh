@@ -1,6 +1,6 @@
 #!/bin/bash
 
-# Generate a complete tests/src/ directory with 6 Tomasulo test cases in C
+# Generate a complete tests/src/ directory with the Tomasulo test cases in C
 
 set -e
 
@@ -133,5 +133,65 @@ void _start(void) {
 }
 EOF
 
+# 8. loop_sum.c
+cat > "$SRC_DIR/loop_sum.c" << 'EOF'
+// tests/src/loop_sum.c
+// .data is not loaded into simulator memory, so the input array is filled in code.
+// Expected final memory: data[0..7] = 1..8, sum = 36, count_big = 4
+// Variable addresses depend on the build; build.sh lists them in tests/bin/loop_sum.sym
+long data[8];
+long sum;
+long count_big;
+
+void _start(void) {
+    for (long i = 0; i < 8; i++)
+        data[i] = i + 1;
+    long s = 0;
+    long big = 0;
+    for (long i = 0; i < 8; i++) {   // backward BLT/BGE loop branch
+        s += data[i];
+        if (data[i] > 4)             // forward conditional branch
+            big++;
+    }
+    sum = s;
+    count_big = big;
+}
+EOF
+
+# 9. word_ops.c
+cat > "$SRC_DIR/word_ops.c" << 'EOF'
+// tests/src/word_ops.c
+// .data is not loaded into simulator memory, so the inputs are stored in code.
+// mix() is defined after _start because execution starts at the first instruction.
+// Expected final memory: wq = -22 (stored as 4294967274), wr = 536870911, bsum = 384
+// Variable addresses depend on the build; build.sh lists them in tests/bin/word_ops.sym
+int wa;
+int wb;
+unsigned char bytes[4];
+int wq, wr;
+long bsum;
+
+static int mix(int x, int y);
+
+void _start(void) {
+    wa = -7;
+    wb = 3;
+    bytes[0] = 250;                  // SB
+    bytes[1] = 5;
+    bytes[2] = 128;
+    bytes[3] = 1;
+    wq = mix(wa, wb);                // MULW / DIVW / REMW / ADDW / SUBW
+    wr = (unsigned)wa >> 3;          // SRLIW
+    long s = 0;
+    for (int i = 0; i < 4; i++)
+        s += bytes[i];               // LBU in a loop
+    bsum = s;
+}
+
+static int mix(int x, int y) {       // JAL / JALR call and return
+    return (x * y) + (x / y) - (x % y);
+}
+EOF
+
 echo " Successfully generated:"
 ls -1 "$SRC_DIR"
\ No newline at end of file
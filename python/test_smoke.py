@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+"""Smoke test for the Python bindings.
+
+Run through `make python-test`, which builds the module first and skips the
+test when pybind11 / NumPy are not installed. Covers loading a program,
+running it to completion, snapshots of the ROB / LSQ mid-run, that the
+stats() arrays stay valid and live across a second load + run, and that an
+invalid configure() call leaves the configuration untouched.
+"""
+
+import gc
+import os
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, os.path.join(ROOT, "build"))
+
+import numpy as np  # noqa: E402
+import tomasulo  # noqa: E402
+
+PROGRAM = os.path.join(ROOT, "tests", "bin", "comprehensive.bin")
+
+
+def run_to_completion():
+    tomasulo.load(PROGRAM)
+    tomasulo.run(0)
+    assert tomasulo.finished(), "run(0) returned before the program finished"
+
+
+def check_snapshots():
+    tomasulo.load(PROGRAM)
+    tomasulo.run(20)
+    rob = tomasulo.rob_snapshot()
+    lsq = tomasulo.lsq_snapshot()
+    n = len(rob["index"])
+    assert 0 < n <= tomasulo.ROB_SIZE, n
+    assert all(len(rob[k]) == n for k in ("op", "state", "pc", "is_load", "is_store"))
+    assert np.all((rob["index"] >= 0) & (rob["index"] < tomasulo.ROB_SIZE))
+    assert np.all((rob["state"] >= 0) & (rob["state"] <= 2))
+    m = len(lsq["index"])
+    assert m <= tomasulo.LSQ_SIZE, m
+    assert np.all((lsq["index"] >= 0) & (lsq["index"] < tomasulo.LSQ_SIZE))
+    # Every LSQ entry belongs to an instruction that is still in the ROB
+    assert set(lsq["rob_idx"].tolist()) <= set(rob["index"].tolist())
+
+
+def check_live_counters():
+    fields = tomasulo.stat_fields()["core"]
+    core = tomasulo.stats()["core"]
+    assert core.dtype == np.uint64 and not core.flags.owndata
+    run_to_completion()
+    cycles = int(core[fields.index("cycles")])
+    committed = int(core[fields.index("committed")])
+    assert cycles > 0 and committed > 0
+
+    # The array keeps aliasing the counters after the dict it came from is gone
+    # and after the machine is reset by another load
+    gc.collect()
+    tomasulo.load(PROGRAM)
+    assert int(core[fields.index("cycles")]) == 0
+    tomasulo.run(0)
+    assert int(core[fields.index("cycles")]) == cycles
+    assert int(core[fields.index("committed")]) == committed
+    return cycles
+
+
+def check_configure_is_atomic(default_cycles):
+    tomasulo.reset_config()
+    try:
+        tomasulo.configure(dcache=True, dcache_sets=0)
+    except ValueError:
+        pass
+    else:
+        raise AssertionError("configure accepted dcache_sets=0")
+    # dcache=True was valid but must not have been applied
+    run_to_completion()
+    cycles = int(tomasulo.stats()["core"][tomasulo.stat_fields()["core"].index("cycles")])
+    assert cycles == default_cycles, (cycles, default_cycles)
+
+    tomasulo.configure(dcache=True)
+    run_to_completion()
+    cycles = int(tomasulo.stats()["core"][tomasulo.stat_fields()["core"].index("cycles")])
+    assert cycles != default_cycles, "dcache=True had no effect"
+    tomasulo.reset_config()
+
+
+def main():
+    tomasulo.reset_config()
+    check_snapshots()
+    default_cycles = check_live_counters()
+    check_configure_is_atomic(default_cycles)
+    mem_int, mem_fp = tomasulo.memory()
+    assert mem_int or mem_fp
+    assert "cycles" in tomasulo.report()
+    print("python smoke test: ok")
+
+
+if __name__ == "__main__":
+    main()
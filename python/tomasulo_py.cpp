@@ -0,0 +1,117 @@
+// python/tomasulo_py.cpp
+// Python 绑定：make python 生成 build/tomasulo<EXT_SUFFIX>，需要 pybind11 与 NumPy
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+#include "sim_api.h"
+#include "sim_config.h"
+#include "sim_stats.h"
+#include <sstream>
+
+namespace py = pybind11;
+
+// 模拟器状态（ROB、RS、sim_config、统计结构体等）都是进程全局的，因此所有入口在执行期间都持有 GIL，
+// run() 也不释放：其他 Python 线程的调用与对 stats() 数组的读取都被串行化，不会与模拟并发
+
+// 统计块直接映射为 uint64 数组：数据在全局结构体中，用空 capsule 作 base，NumPy 不会释放也不会拷贝
+static py::array_t<uint64_t> block_view(const StatBlock& b) {
+    py::capsule owner(b.data, [](void*) {});
+    return py::array_t<uint64_t>({static_cast<py::ssize_t>(b.size)},
+                                 {static_cast<py::ssize_t>(sizeof(uint64_t))}, b.data, owner);
+}
+
+PYBIND11_MODULE(tomasulo, m) {
+    m.doc() = "In-process Tomasulo simulator: load a program, configure, run and read counters";
+
+    // 先在副本上逐项设置，全部合法后才替换 sim_config：任何一项非法时配置保持不变
+    m.def("configure", [](py::kwargs kwargs) {
+        SimConfig cfg = sim_config;
+        for (auto item : kwargs) {
+            std::string key = py::str(item.first);
+            py::handle v = item.second;
+            std::string value;
+            if (py::isinstance<py::bool_>(v)) value = v.cast<bool>() ? "on" : "off";
+            else value = py::str(v);
+            if (!set_config_option(cfg, key, value)) {
+                throw py::value_error("invalid option " + key + "=" + value);
+            }
+        }
+        sim_config = std::move(cfg);
+    }, "Set options by keyword, same names as the --key=value command-line options; "
+       "nothing is changed if any option is invalid");
+    m.def("reset_config", []() { sim_config = SimConfig{}; }, "Restore all options to their defaults");
+
+    m.def("load", &sim_load, py::arg("path"),
+          "Load a .bin program with the default memory/register initialisation and reset the machine; "
+          "returns the instruction count. Call after configure()");
+    m.def("run", [](uint64_t cycles) {
+        return sim_run(cycles);
+    }, py::arg("cycles") = 0,
+       "Run up to `cycles` cycles (0 = to completion); returns cycles advanced. Holds the GIL for the whole run");
+    m.def("finished", &sim_finished);
+
+    m.def("stats", []() {
+        py::dict d;
+        for (const StatBlock& b : stat_blocks()) d[b.name] = block_view(b);
+        return d;
+    }, "Counter blocks as uint64 arrays that alias the simulator's counters (updated live, no copy)");
+    m.def("stat_fields", []() {
+        py::dict d;
+        for (const StatBlock& b : stat_blocks()) {
+            py::list names;
+            for (size_t i = 0; i < b.size; ++i) names.append(b.fields[i]);
+            d[b.name] = names;
+        }
+        return d;
+    }, "Field names of each counter block, in array order");
+    m.def("report", []() {
+        std::ostringstream os;
+        print_stats(os);
+        return os.str();
+    }, "The end-of-run statistics text");
+
+    m.def("rob_snapshot", []() {
+        auto snap = rob_snapshot();
+        py::ssize_t n = static_cast<py::ssize_t>(snap.size());
+        py::array_t<int32_t> index(n), op(n), state(n);
+        py::array_t<uint64_t> pc(n);
+        py::array_t<bool> is_load(n), is_store(n);
+        for (py::ssize_t i = 0; i < n; ++i) {
+            index.mutable_at(i) = snap[i].index;
+            op.mutable_at(i) = static_cast<int32_t>(snap[i].op);
+            state.mutable_at(i) = static_cast<int32_t>(snap[i].state);
+            pc.mutable_at(i) = snap[i].pc;
+            is_load.mutable_at(i) = snap[i].is_load;
+            is_store.mutable_at(i) = snap[i].is_store;
+        }
+        py::dict d;
+        d["index"] = index; d["op"] = op; d["state"] = state; d["pc"] = pc;
+        d["is_load"] = is_load; d["is_store"] = is_store;
+        return d;
+    }, "Occupied ROB entries, oldest first (state: 0 issued, 1 executing, 2 executed)");
+    m.def("lsq_snapshot", []() {
+        auto snap = lsq_snapshot();
+        py::ssize_t n = static_cast<py::ssize_t>(snap.size());
+        py::array_t<int32_t> index(n), rob_idx(n);
+        py::array_t<bool> is_store(n), addr_ready(n), executed(n);
+        py::array_t<uint64_t> address(n);
+        for (py::ssize_t i = 0; i < n; ++i) {
+            index.mutable_at(i) = snap[i].index;
+            rob_idx.mutable_at(i) = snap[i].rob_idx;
+            is_store.mutable_at(i) = snap[i].is_store;
+            addr_ready.mutable_at(i) = snap[i].addr_ready;
+            executed.mutable_at(i) = snap[i].executed;
+            address.mutable_at(i) = snap[i].address;
+        }
+        py::dict d;
+        d["index"] = index; d["rob_idx"] = rob_idx; d["is_store"] = is_store;
+        d["addr_ready"] = addr_ready; d["executed"] = executed; d["address"] = address;
+        return d;
+    }, "Occupied LSQ entries, oldest first");
+
+    m.def("memory", []() {
+        return py::make_tuple(memory_int, memory_fp);
+    }, "(int memory, fp memory) as dicts address -> value");
+    m.attr("ROB_SIZE") = ROB_SIZE;
+    m.attr("LSQ_SIZE") = LSQ_SIZE;
+}
@@ -0,0 +1,244 @@
+// src/cache.cpp
+#include "cache.h"
+#include "dram.h"
+#include "prefetcher.h"
+#include "sim_stats.h"
+#include <algorithm>
+
+void Cache::configure(int sets, int ways, int line_size) {
+    sets_ = sets;
+    ways_ = ways;
+    line_size_ = line_size;
+    lines_.assign(static_cast<size_t>(sets) * ways, CacheLine{});
+}
+
+CacheLine* Cache::find(uint64_t line) {
+    CacheLine* set = &lines_[(line % sets_) * ways_];
+    for (int w = 0; w < ways_; ++w) {
+        if (set[w].valid && set[w].line == line) return &set[w];
+    }
+    return nullptr;
+}
+
+CacheLine* Cache::fill(uint64_t line, uint64_t ready_cycle, bool prefetched, uint64_t now,
+                       CacheLine& victim) {
+    CacheLine* set = &lines_[(line % sets_) * ways_];
+    CacheLine* slot = &set[0];
+    for (int w = 0; w < ways_; ++w) {
+        if (!set[w].valid) { slot = &set[w]; break; }
+        if (set[w].lru < slot->lru) slot = &set[w];
+    }
+    victim = *slot;
+    *slot = CacheLine{true, line, now, ready_cycle, prefetched};
+    return slot;
+}
+
+// --- L1D 实例与预取器 ---
+static Cache l1d;
+static std::unique_ptr<Prefetcher> l1d_prefetcher;
+static std::vector<uint64_t> pf_candidates;
+
+struct Mshr {
+    bool valid = false;
+    uint64_t line = 0;
+    int targets = 0;
+};
+static std::vector<Mshr> mshrs;
+
+// 从内存取一行：开启 DRAM 模型时发出读请求，到达周期由内存控制器决定
+static CacheLine* fill_line(uint64_t line, bool prefetched, uint64_t now) {
+    CacheLine victim;
+    CacheLine* l;
+    if (sim_config.dram_enabled) {
+        uint64_t req = dram_request(line * sim_config.dcache_line, false, now);
+        l = l1d.fill(line, 0, prefetched, now, victim);
+        l->mem_req = req;
+    } else {
+        l = l1d.fill(line, now + sim_config.mem_latency, prefetched, now, victim);
+        energy_stats.mem_accesses++;
+    }
+    if (victim.valid) {
+        cache_stats.evictions++;
+        if (victim.prefetched) prefetch_stats.useless++;
+    }
+    return l;
+}
+
+// 行的数据在 now 时是否仍在途；DRAM 请求被调度后把返回周期写回 ready_cycle
+static bool line_in_flight(CacheLine& l, uint64_t now) {
+    if (l.mem_req) {
+        uint64_t done = dram_done_cycle(l.mem_req, now);
+        if (done == DRAM_PENDING) return true;
+        l.ready_cycle = done;
+        l.mem_req = 0;
+    }
+    return l.ready_cycle > now;
+}
+
+// 等待在途的行：返回周期已知时折算为额外周期，否则交给调用者按请求号等待
+static int wait_for_line(const CacheLine& l, uint64_t now, uint64_t* mem_req) {
+    if (!l.mem_req) return static_cast<int>(l.ready_cycle - now);
+    if (mem_req) *mem_req = l.mem_req;
+    return 0;
+}
+
+void dcache_reset(const SimConfig& cfg) {
+    l1d.configure(cfg.dcache_sets, cfg.dcache_ways, cfg.dcache_line);
+    l1d_prefetcher = cfg.dcache_enabled ? make_prefetcher(cfg) : nullptr;
+    mshrs.assign(cfg.dcache_mshrs, Mshr{});
+}
+
+int dcache_load_access(uint64_t pc, uint64_t addr, uint64_t now, uint64_t* mem_req) {
+    if (!sim_config.dcache_enabled) {
+        // 没有 cache 时每次 load 都直接访问 DRAM
+        if (sim_config.dram_enabled) {
+            uint64_t req = dram_request(addr, false, now);
+            if (mem_req) *mem_req = req;
+        } else {
+            energy_stats.mem_accesses++;
+        }
+        return 0;
+    }
+    cache_stats.load_accesses++;
+
+    uint64_t line = l1d.line_of(addr);
+    CacheLine* hit = l1d.find(line);
+    bool pf_hit = false;
+    int extra = 0;
+    if (hit) {
+        cache_stats.load_hits++;
+        bool in_flight = line_in_flight(*hit, now);
+        if (in_flight) {
+            cache_stats.pending_hits++;
+            extra = wait_for_line(*hit, now, mem_req);
+        }
+        if (hit->prefetched) {
+            pf_hit = true;
+            hit->prefetched = false;
+            prefetch_stats.useful++;
+            if (in_flight) prefetch_stats.late++;
+        }
+        hit->lru = now;
+    } else {
+        cache_stats.load_misses++;
+        extra = wait_for_line(*fill_line(line, false, now), now, mem_req);
+    }
+
+    if (l1d_prefetcher) {
+        pf_candidates.clear();
+        l1d_prefetcher->on_access(pc, addr, hit == nullptr, pf_hit, pf_candidates);
+        for (uint64_t pf_line : pf_candidates) {
+            if (l1d.find(pf_line)) {
+                prefetch_stats.redundant++;
+                continue;
+            }
+            prefetch_stats.issued++;
+            fill_line(pf_line, true, now);
+        }
+    }
+    return extra;
+}
+
+int dcache_store_access(uint64_t addr, uint64_t now, uint64_t* mem_req) {
+    if (!sim_config.dcache_enabled) {
+        if (sim_config.dram_enabled) dram_request(addr, true, now);
+        else energy_stats.mem_accesses++;
+        return 0;
+    }
+    // 写分配；store 在提交时写入，不阻塞流水线
+    cache_stats.store_accesses++;
+    uint64_t line = l1d.line_of(addr);
+    if (CacheLine* l = l1d.find(line)) {
+        // 覆盖率只针对 load，store 命中预取行不计入有用预取
+        l->lru = now;
+        l->prefetched = false;
+        return 0;
+    }
+    cache_stats.store_misses++;
+    return wait_for_line(*fill_line(line, false, now), now, mem_req);
+}
+
+// --- MSHR ---
+bool dcache_nonblocking() {
+    return sim_config.dcache_enabled && !mshrs.empty();
+}
+
+static Mshr* find_mshr(uint64_t line) {
+    for (auto& m : mshrs) {
+        if (m.valid && m.line == line) return &m;
+    }
+    return nullptr;
+}
+
+bool dcache_mshr_available(uint64_t addr, uint64_t now) {
+    if (!dcache_nonblocking()) return true;
+    uint64_t line = l1d.line_of(addr);
+    CacheLine* l = l1d.find(line);
+    if (l && !line_in_flight(*l, now)) return true;
+    bool ok;
+    if (Mshr* m = find_mshr(line)) {
+        ok = m->targets < sim_config.mshr_targets;
+    } else {
+        ok = std::any_of(mshrs.begin(), mshrs.end(), [](const Mshr& m) { return !m.valid; });
+    }
+    if (!ok) cache_stats.mshr_full_stalls++;
+    return ok;
+}
+
+void dcache_mshr_allocate(uint64_t addr) {
+    uint64_t line = l1d.line_of(addr);
+    if (Mshr* m = find_mshr(line)) {
+        m->targets++;
+        cache_stats.mshr_merges++;
+        return;
+    }
+    for (auto& m : mshrs) {
+        if (!m.valid) {
+            m = Mshr{true, line, 1};
+            cache_stats.mshr_allocs++;
+            return;
+        }
+    }
+}
+
+void dcache_mshr_tick(uint64_t now) {
+    uint64_t in_use = 0;
+    for (auto& m : mshrs) {
+        if (!m.valid) continue;
+        // 行已到达（或在途时被替换）即释放，已合并的 load 各自按数据到达时间写回
+        CacheLine* l = l1d.find(m.line);
+        if (!l || !line_in_flight(*l, now)) {
+            m.valid = false;
+            continue;
+        }
+        in_use++;
+    }
+    cache_stats.mshr_in_use_sum += in_use;
+    cache_stats.mshr_in_use_max = std::max(cache_stats.mshr_in_use_max, in_use);
+}
+
+// --- L1I 实例（无预取） ---
+static Cache l1i;
+
+void icache_reset(const SimConfig& cfg) {
+    l1i.configure(cfg.icache_sets, cfg.icache_ways, cfg.icache_line);
+}
+
+uint64_t icache_line_of(uint64_t pc) {
+    return l1i.line_of(pc);
+}
+
+int icache_fetch_access(uint64_t pc, uint64_t now) {
+    if (!sim_config.icache_enabled) return 0;
+    frontend_stats.icache_accesses++;
+    uint64_t line = l1i.line_of(pc);
+    if (CacheLine* l = l1i.find(line)) {
+        l->lru = now;
+        return l->ready_cycle > now ? static_cast<int>(l->ready_cycle - now) : 0;
+    }
+    frontend_stats.icache_misses++;
+    energy_stats.mem_accesses++;
+    CacheLine victim;
+    l1i.fill(line, now + sim_config.mem_latency, false, now, victim);
+    return sim_config.mem_latency;
+}
@@ -0,0 +1,58 @@
+// src/cache.h
+#ifndef CACHE_H
+#define CACHE_H
+#include <cstdint>
+#include <vector>
+#include "sim_config.h"
+
+// 组相联 cache 的一行（只建模标签与时序，数据仍在 memory_int / memory_fp 中）
+struct CacheLine {
+    bool valid = false;
+    uint64_t line = 0;           // 行号 = addr / line_size
+    uint64_t lru = 0;            // 最近访问周期
+    uint64_t ready_cycle = 0;    // 数据到达的周期（缺失或预取在途时大于当前周期）
+    bool prefetched = false;     // 由预取填入且尚未被 demand 访问
+    uint64_t mem_req = 0;        // 经 DRAM 填入且返回周期未知时的请求号，此时 ready_cycle 无意义
+};
+
+class Cache {
+public:
+    void configure(int sets, int ways, int line_size);
+    uint64_t line_of(uint64_t addr) const { return addr / line_size_; }
+
+    // 查找行，未命中返回 nullptr
+    CacheLine* find(uint64_t line);
+    // 填入一行（LRU 替换），victim 返回被替换的行
+    CacheLine* fill(uint64_t line, uint64_t ready_cycle, bool prefetched, uint64_t now,
+                    CacheLine& victim);
+
+private:
+    int sets_ = 1, ways_ = 1;
+    uint64_t line_size_ = 64;
+    std::vector<CacheLine> lines_;
+};
+
+// L1D 访问入口：返回在基本访存延迟之外需要额外等待的周期数
+// 未开启 cache 时恒为 0。开启 DRAM 模型时数据若仍在内存控制器中，返回 0 并把请求号写入 mem_req，
+// 调用者等该请求返回后再开始计基本延迟（功能模拟传 nullptr，不等待）
+void dcache_reset(const SimConfig& cfg);
+int dcache_load_access(uint64_t pc, uint64_t addr, uint64_t now, uint64_t* mem_req = nullptr);
+// store 写入 L1D：缺失时返回写分配填充的等待（与 load 相同的约定）；提交时直接写的 store 忽略返回值
+int dcache_store_access(uint64_t addr, uint64_t now, uint64_t* mem_req = nullptr);
+
+// MSHR（--mshrs > 0 时为非阻塞 L1D）：缺失或命中在途行的 load 占用该行的 MSHR，
+// 同一行的后续缺失合并为它的目标；数据到达 cache 后释放
+bool dcache_nonblocking();
+// load 发往 FU 前检查：需要 MSHR 但没有空闲项或该行目标已满时返回 false
+bool dcache_mshr_available(uint64_t addr, uint64_t now);
+// 为在途行上的 load 分配 / 合并 MSHR（须先经 dcache_mshr_available 检查）
+void dcache_mshr_allocate(uint64_t addr);
+// 每周期调用：释放数据已到达的 MSHR 并统计占用
+void dcache_mshr_tick(uint64_t now);
+
+// L1I：取指组起始 pc 的访问，返回需要停顿的周期数；未开启时恒为 0
+void icache_reset(const SimConfig& cfg);
+int icache_fetch_access(uint64_t pc, uint64_t now);
+uint64_t icache_line_of(uint64_t pc);
+
+#endif
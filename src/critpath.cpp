@@ -0,0 +1,246 @@
+// src/critpath.cpp
+#include "critpath.h"
+#include "sim_config.h"
+#include "sim_stats.h"
+#include "tomasulo_sim.h"
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <unordered_map>
+#include <vector>
+
+// 一条指令在流水线中的各时刻
+struct CpInst {
+    uint64_t seq = 0;          // 发射序号，从 1 开始
+    uint64_t pc = 0;
+    bool control = false;      // 条件分支 / JALR：其后的取指要等它解析
+    bool mem = false;
+    CpEdge stall = CpEdge::NONE;
+    uint64_t fetch = 0, issue = 0, ready = 0, exec = 0, complete = 0, commit = 0;
+    bool exec_seen = false, complete_seen = false;
+    uint64_t data_src = 0;     // 最后到达的源操作数的生产者发射序号；0 表示发射时已就绪
+};
+
+// 一条静态指令在关键路径上的周期
+struct CpStatic {
+    std::string text;
+    std::array<uint64_t, static_cast<size_t>(CpEdge::COUNT)> cycles{};
+    uint64_t total = 0;
+};
+
+static CpInst inflight[ROB_SIZE];
+static std::vector<CpInst> window;
+static std::unordered_map<uint64_t, CpStatic> static_insts;
+static uint64_t next_seq = 1;
+static CpEdge pending_stall = CpEdge::NONE;
+
+static const char* edge_name(CpEdge e) {
+    switch (e) {
+        case CpEdge::ISSUE:    return "in-order issue";
+        case CpEdge::FETCH:    return "fetch";
+        case CpEdge::BRANCH:   return "branch barrier";
+        case CpEdge::ROB_FULL: return "ROB full";
+        case CpEdge::RS_FULL:  return "RS full";
+        case CpEdge::LSQ_FULL: return "LSQ full";
+        case CpEdge::PRF_FULL: return "PRF full";
+        case CpEdge::DATA:     return "data (CDB)";
+        case CpEdge::DISPATCH: return "dispatch";
+        case CpEdge::FU_WAIT:  return "FU wait";
+        case CpEdge::EXECUTE:  return "execute";
+        case CpEdge::MEMORY:   return "memory";
+        case CpEdge::COMMIT:   return "in-order commit";
+        default:               return "none";
+    }
+}
+
+static uint64_t& edge_counter(CpEdge e) {
+    CritPathStats& s = critpath_stats;
+    switch (e) {
+        case CpEdge::ISSUE:    return s.issue;
+        case CpEdge::FETCH:    return s.fetch;
+        case CpEdge::BRANCH:   return s.branch;
+        case CpEdge::ROB_FULL: return s.rob_full;
+        case CpEdge::RS_FULL:  return s.rs_full;
+        case CpEdge::LSQ_FULL: return s.lsq_full;
+        case CpEdge::PRF_FULL: return s.prf_full;
+        case CpEdge::DATA:     return s.data;
+        case CpEdge::DISPATCH: return s.dispatch;
+        case CpEdge::FU_WAIT:  return s.fu_wait;
+        case CpEdge::EXECUTE:  return s.execute;
+        case CpEdge::MEMORY:   return s.memory;
+        default:               return s.commit;
+    }
+}
+
+static uint64_t gap(uint64_t later, uint64_t earlier) {
+    return later > earlier ? later - earlier : 0;
+}
+
+static void charge(CpEdge e, const CpInst& r, uint64_t cycles) {
+    if (cycles == 0) return;
+    edge_counter(e) += cycles;
+    critpath_stats.path_cycles += cycles;
+    CpStatic& s = static_insts[r.pc];
+    s.cycles[static_cast<size_t>(e)] += cycles;
+    s.total += cycles;
+}
+
+// 从窗口最后一条指令的提交向前回溯：每个节点走向约束它最晚的前驱，直到离开窗口
+static void analyze_window() {
+    if (window.empty()) return;
+    critpath_stats.windows++;
+    enum class Node { D, E, C, R };
+    size_t i = window.size() - 1;
+    Node node = Node::R;
+    while (true) {
+        const CpInst& r = window[i];
+        if (node == Node::R) {
+            // 提交：等自己完成，或等前一条提交（每周期按序提交）
+            if (i > 0 && window[i - 1].commit > r.complete) {
+                charge(CpEdge::COMMIT, r, gap(r.commit, window[i - 1].commit));
+                --i;
+            } else {
+                charge(CpEdge::COMMIT, r, gap(r.commit, r.complete));
+                node = Node::C;
+            }
+        } else if (node == Node::C) {
+            charge(r.mem ? CpEdge::MEMORY : CpEdge::EXECUTE, r, gap(r.complete, r.exec));
+            node = Node::E;
+        } else if (node == Node::E) {
+            // 最早可在发射 / 最后一个操作数广播的下一周期发往 FU，多出的是结构等待
+            uint64_t earliest = std::max(r.issue, r.ready) + 1;
+            uint64_t wait = gap(r.exec, earliest);
+            charge(CpEdge::FU_WAIT, r, wait);
+            uint64_t launch = r.exec - wait;
+            if (r.data_src && r.ready > r.issue) {
+                auto end = window.begin() + i;
+                auto it = std::lower_bound(window.begin(), end, r.data_src,
+                                           [](const CpInst& c, uint64_t seq) { return c.seq < seq; });
+                if (it == end || it->seq != r.data_src) break;   // 生产者在窗口之前
+                charge(CpEdge::DATA, r, gap(launch, it->complete));
+                i = static_cast<size_t>(it - window.begin());
+                node = Node::C;
+            } else {
+                charge(CpEdge::DISPATCH, r, gap(launch, r.issue));
+                node = Node::D;
+            }
+        } else {
+            if (i == 0) break;
+            // 发射：最早在前一条发射后、自己取到之后；再晚则是资源不足
+            const CpInst& p = window[i - 1];
+            uint64_t earliest = std::max(p.issue + 1, r.fetch);
+            uint64_t stall = gap(r.issue, earliest);
+            if (stall > 0 && r.stall == CpEdge::ROB_FULL && i >= static_cast<size_t>(ROB_SIZE)) {
+                charge(CpEdge::ROB_FULL, r, gap(r.issue, window[i - ROB_SIZE].commit));
+                i -= ROB_SIZE;
+                node = Node::R;
+                continue;
+            }
+            charge(r.stall == CpEdge::NONE ? CpEdge::ISSUE : r.stall, r, stall);
+            if (r.fetch > p.issue + 1 && p.control) {
+                charge(CpEdge::BRANCH, r, gap(earliest, p.complete));
+                node = Node::C;
+            } else if (r.fetch > p.issue + 1) {
+                charge(CpEdge::FETCH, r, gap(earliest, p.issue));
+            } else {
+                charge(CpEdge::ISSUE, r, gap(earliest, p.issue));
+            }
+            --i;
+        }
+    }
+    window.clear();
+}
+
+void critpath_reset() {
+    for (auto& c : inflight) c = CpInst{};
+    window.clear();
+    if (sim_config.critpath) window.reserve(sim_config.critpath_window);
+    static_insts.clear();
+    next_seq = 1;
+    pending_stall = CpEdge::NONE;
+}
+
+void critpath_issue_stall(CpEdge reason) {
+    if (sim_config.critpath) pending_stall = reason;
+}
+
+void critpath_on_issue(int rob_idx, const Instruction& instr) {
+    if (!sim_config.critpath) return;
+    CpInst& c = inflight[rob_idx];
+    c = CpInst{};
+    c.seq = next_seq++;
+    c.pc = instr.pc;
+    c.control = is_branch_op(instr.op) || instr.op == OpType::JALR;
+    c.mem = is_load_op(instr.op) || is_store_op(instr.op) ||
+            is_vec_load_op(instr.op) || is_vec_store_op(instr.op);
+    c.stall = pending_stall;
+    c.fetch = instr.fetch_cycle;
+    c.issue = c.ready = sim_now();
+    pending_stall = CpEdge::NONE;
+    CpStatic& s = static_insts[instr.pc];
+    if (s.text.empty()) s.text = instr.toString();
+}
+
+void critpath_on_wakeup(int consumer_rob, int producer_rob) {
+    if (!sim_config.critpath) return;
+    inflight[consumer_rob].ready = sim_now();
+    inflight[consumer_rob].data_src = inflight[producer_rob].seq;
+}
+
+void critpath_end_cycle() {
+    if (!sim_config.critpath) return;
+    uint64_t now = sim_now();
+    for (int i = 0; i < ROB_SIZE; ++i) {
+        if (!rob[i].busy) continue;
+        CpInst& c = inflight[i];
+        if (rob[i].state >= InstructionState::EXECUTING && !c.exec_seen) {
+            c.exec = now;
+            c.exec_seen = true;
+        }
+        if (rob[i].state >= InstructionState::EXECUTED && !c.complete_seen) {
+            c.complete = now;
+            c.complete_seen = true;
+        }
+    }
+}
+
+void critpath_on_commit(int rob_idx) {
+    if (!sim_config.critpath) return;
+    CpInst c = inflight[rob_idx];
+    c.commit = sim_now();
+    if (!c.complete_seen) c.exec = c.complete = c.commit;
+    window.push_back(c);
+    if (window.size() >= static_cast<size_t>(sim_config.critpath_window)) analyze_window();
+}
+
+void print_critpath_report(std::ostream& os) {
+    analyze_window();
+    const CritPathStats& s = critpath_stats;
+    auto pct = [&](uint64_t v) { return s.path_cycles ? 100.0 * v / s.path_cycles : 0.0; };
+    os << "--- critical path (" << s.windows << " windows of up to " << sim_config.critpath_window
+       << " insts) ---\n";
+    os << "path cycles       : " << s.path_cycles << " (" << (core_stats.cycles ? 100.0 * s.path_cycles / core_stats.cycles : 0.0)
+       << "% of cycles)\n";
+    for (int e = static_cast<int>(CpEdge::ISSUE); e < static_cast<int>(CpEdge::COUNT); ++e) {
+        uint64_t v = edge_counter(static_cast<CpEdge>(e));
+        if (v == 0) continue;
+        os << "  " << std::left << std::setw(16) << edge_name(static_cast<CpEdge>(e)) << ": "
+           << std::right << v << " (" << pct(v) << "%)\n";
+    }
+
+    std::vector<std::pair<uint64_t, const CpStatic*>> top;
+    for (const auto& [pc, st] : static_insts) {
+        if (st.total) top.emplace_back(pc, &st);
+    }
+    std::sort(top.begin(), top.end(), [](const auto& a, const auto& b) {
+        return a.second->total != b.second->total ? a.second->total > b.second->total : a.first < b.first;
+    });
+    if (top.size() > static_cast<size_t>(sim_config.critpath_top)) top.resize(sim_config.critpath_top);
+    os << "top instructions on the path:\n";
+    for (const auto& [pc, st] : top) {
+        size_t main_edge = std::max_element(st->cycles.begin(), st->cycles.end()) - st->cycles.begin();
+        os << "  0x" << std::hex << std::setw(4) << std::setfill('0') << pc << std::dec << std::setfill(' ')
+           << "  " << std::setw(6) << pct(st->total) << "%  " << std::left << std::setw(16)
+           << edge_name(static_cast<CpEdge>(main_edge)) << std::right << "  " << st->text << "\n";
+    }
+}
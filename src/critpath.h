@@ -0,0 +1,43 @@
+// src/critpath.h
+#ifndef CRITPATH_H
+#define CRITPATH_H
+#include <cstdint>
+#include <iostream>
+#include "instruction.h"
+
+// 动态关键路径分析：每条提交的指令记录发射 (D)、开始执行 (E)、完成 (C)、提交 (R) 四个时刻，
+// 以及真正推迟它的边（CDB 上最后到达的源操作数、发射时的资源不足、取指 / 分支屏障）。
+// 每积累 critpath_window 条提交指令，从窗口最后一条的提交向前沿最晚到达的边回溯出关键路径，
+// 把路径上每段周期计入边的类别和所属的静态指令，然后丢弃窗口，内存占用与程序长度无关
+
+enum class CpEdge {
+    NONE,
+    ISSUE,      // 按序发射：前一条指令发射后才轮到它
+    FETCH,      // 指令尚未取到（L1I 缺失、取指带宽、取指队列）
+    BRANCH,     // 取指等待前一条分支 / JALR 解析
+    ROB_FULL,   // 发射等待 ROB 空位（更老指令提交）
+    RS_FULL,    // 没有空闲保留站
+    LSQ_FULL,
+    PRF_FULL,   // 没有空闲物理寄存器
+    DATA,       // 源操作数经 CDB 到达
+    DISPATCH,   // 发射后到发往 FU
+    FU_WAIT,    // 操作数就绪但 FU / MSHR / 访存顺序未就绪
+    EXECUTE,    // 运算延迟
+    MEMORY,     // 访存指令的执行延迟（含 cache / DRAM）
+    COMMIT,     // 按序提交
+    COUNT
+};
+
+void critpath_reset();
+// 发射失败时记录原因，发射成功时该原因归到这条指令
+void critpath_issue_stall(CpEdge reason);
+void critpath_on_issue(int rob_idx, const Instruction& instr);
+// consumer 的一个源操作数由 producer 的广播唤醒
+void critpath_on_wakeup(int consumer_rob, int producer_rob);
+// 每周期末调用：记录进入 EXECUTING / EXECUTED 的时刻
+void critpath_end_cycle();
+void critpath_on_commit(int rob_idx);
+// 分析剩余窗口并输出各类别占比与关键路径上最多的静态指令
+void print_critpath_report(std::ostream& os);
+
+#endif
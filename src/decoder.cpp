@@ -22,6 +22,63 @@ static int32_t decode_imm_s(uint32_t inst) {
     return imm;
 }
 
+// RVV: funct6 / vm 字段
+static inline uint32_t get_funct6(uint32_t inst) { return (inst >> 26) & 0x3F; }
+static inline uint32_t get_vm(uint32_t inst)     { return (inst >> 25) & 0x1; }
+
+// OP-V 算术指令，只接受非掩码形式（vm=1）
+static void decode_vector_arith(uint32_t inst_word, Instruction& inst) {
+    const uint32_t OPIVV = 0x0, OPFVV = 0x1, OPMVV = 0x2;
+    const uint32_t OPIVX = 0x4, OPFVF = 0x5, OPMVX = 0x6;
+
+    uint32_t f3 = get_funct3(inst_word);
+    uint32_t f6 = get_funct6(inst_word);
+    inst.vd = get_rd(inst_word);
+    inst.vs2 = get_rs2(inst_word);
+    inst.op = OpType::UNKNOWN;
+    if (get_vm(inst_word) == 0) return;
+
+    if (f3 == OPIVV || f3 == OPFVV || f3 == OPMVV) {
+        inst.vs1 = get_rs1(inst_word);
+    } else if (f3 == OPFVF) {
+        inst.fs1 = get_rs1(inst_word);
+        inst.is_fp = true;
+    } else {
+        inst.rs1 = get_rs1(inst_word);
+    }
+
+    if (f3 == OPIVV && f6 == 0x00) inst.op = OpType::VADD_VV;
+    else if (f3 == OPIVX && f6 == 0x00) inst.op = OpType::VADD_VX;
+    else if (f3 == OPMVV && f6 == 0x25) inst.op = OpType::VMUL_VV;
+    else if (f3 == OPMVX && f6 == 0x25) inst.op = OpType::VMUL_VX;
+    else if (f3 == OPMVV && f6 == 0x2D) inst.op = OpType::VMACC_VV;
+    else if (f3 == OPMVX && f6 == 0x2D) inst.op = OpType::VMACC_VX;
+    else if (f3 == OPFVV && f6 == 0x00) inst.op = OpType::VFADD_VV;
+    else if (f3 == OPFVF && f6 == 0x00) inst.op = OpType::VFADD_VF;
+    else if (f3 == OPFVV && f6 == 0x24) inst.op = OpType::VFMUL_VV;
+    else if (f3 == OPFVF && f6 == 0x24) inst.op = OpType::VFMUL_VF;
+    else if (f3 == OPFVV && f6 == 0x2C) inst.op = OpType::VFMACC_VV;
+    else if (f3 == OPFVF && f6 == 0x2C) inst.op = OpType::VFMACC_VF;
+}
+
+// 向量访存：width=111 (e64)，支持 unit-stride 和 strided，nf=0 且 vm=1
+static void decode_vector_mem(uint32_t inst_word, Instruction& inst, bool is_store) {
+    uint32_t mop = (inst_word >> 26) & 0x3;
+    uint32_t nf_mew = (inst_word >> 28) & 0xF;
+    inst.rs1 = get_rs1(inst_word);
+    if (is_store) inst.vs3 = get_rd(inst_word);
+    else inst.vd = get_rd(inst_word);
+    inst.op = OpType::UNKNOWN;
+    if (nf_mew != 0 || get_vm(inst_word) == 0) return;
+
+    if (mop == 0x0 && get_rs2(inst_word) == 0) {
+        inst.op = is_store ? OpType::VSE64_V : OpType::VLE64_V;
+    } else if (mop == 0x2) {
+        inst.rs2 = get_rs2(inst_word);
+        inst.op = is_store ? OpType::VSSE64_V : OpType::VLSE64_V;
+    }
+}
+
 Instruction decode_instruction(uint32_t inst_word) {
     Instruction inst{};
     inst.raw = inst_word;
@@ -37,20 +94,31 @@ Instruction decode_instruction(uint32_t inst_word) {
     const uint32_t OP_LUI    = 0x37;
     const uint32_t OP_AUIPC  = 0x17;
     const uint32_t OP_JALR   = 0x67;
+    const uint32_t OP_JAL    = 0x6F;
+    const uint32_t OP_IMM_32 = 0x1B;
+    const uint32_t OP_OP_32  = 0x3B;
     const uint32_t OP_BRANCH = 0x63;
     const uint32_t OP_MISC_MEM = 0x73;
+    const uint32_t OP_V      = 0x57;
+    const uint32_t OP_FMADD  = 0x43;
+    const uint32_t OP_FMSUB  = 0x47;
+    const uint32_t OP_FNMSUB = 0x4B;
+    const uint32_t OP_FNMADD = 0x4F;
 
     if (opcode == OP_LOAD) {
         uint32_t funct3 = get_funct3(inst_word);
         inst.rd = get_rd(inst_word);
         inst.rs1 = get_rs1(inst_word);
         inst.imm = decode_imm_i(inst_word);
-        if (funct3 == 0x3) {
-            inst.op = OpType::LD;
-        } else if (funct3 == 0x2) {
-            inst.op = OpType::LW;
-        } else {
-            inst.op = OpType::UNKNOWN;
+        switch (funct3) {
+            case 0x0: inst.op = OpType::LB;  break;
+            case 0x1: inst.op = OpType::LH;  break;
+            case 0x2: inst.op = OpType::LW;  break;
+            case 0x3: inst.op = OpType::LD;  break;
+            case 0x4: inst.op = OpType::LBU; break;
+            case 0x5: inst.op = OpType::LHU; break;
+            case 0x6: inst.op = OpType::LWU; break;
+            default:  inst.op = OpType::UNKNOWN;
         }
     }
     else if (opcode == OP_STORE) {
@@ -58,12 +126,12 @@ Instruction decode_instruction(uint32_t inst_word) {
         inst.rs1 = get_rs1(inst_word);
         inst.rs2 = get_rs2(inst_word);
         inst.imm = decode_imm_s(inst_word);
-        if (funct3 == 0x3) {
-            inst.op = OpType::SD;
-        } else if (funct3 == 0x2) {
-            inst.op = OpType::SW;
-        } else {
-            inst.op = OpType::UNKNOWN;
+        switch (funct3) {
+            case 0x0: inst.op = OpType::SB; break;
+            case 0x1: inst.op = OpType::SH; break;
+            case 0x2: inst.op = OpType::SW; break;
+            case 0x3: inst.op = OpType::SD; break;
+            default:  inst.op = OpType::UNKNOWN;
         }
     }
     else if (opcode == OP_OP) {
@@ -76,8 +144,13 @@ Instruction decode_instruction(uint32_t inst_word) {
         if (f3 == 0x0 && f7 == 0x00) inst.op = OpType::ADD;
         else if (f3 == 0x0 && f7 == 0x20) inst.op = OpType::SUB;
         else if (f3 == 0x0 && f7 == 0x01) inst.op = OpType::MUL;
+        else if (f3 == 0x1 && f7 == 0x01) inst.op = OpType::MULH;
+        else if (f3 == 0x2 && f7 == 0x01) inst.op = OpType::MULHSU;
+        else if (f3 == 0x3 && f7 == 0x01) inst.op = OpType::MULHU;
         else if (f3 == 0x4 && f7 == 0x01) inst.op = OpType::DIV;
+        else if (f3 == 0x5 && f7 == 0x01) inst.op = OpType::DIVU;
         else if (f3 == 0x6 && f7 == 0x01) inst.op = OpType::REM;
+        else if (f3 == 0x7 && f7 == 0x01) inst.op = OpType::REMU;
         else if (f3 == 0x1 && f7 == 0x00) inst.op = OpType::SLL;
         else if (f3 == 0x5 && f7 == 0x00) inst.op = OpType::SRL;
         else if (f3 == 0x5 && f7 == 0x20) inst.op = OpType::SRA;
@@ -88,6 +161,26 @@ Instruction decode_instruction(uint32_t inst_word) {
         else if (f3 == 0x7 && f7 == 0x00) inst.op = OpType::AND;
         else inst.op = OpType::UNKNOWN;
     }
+    else if (opcode == OP_OP_32) {
+        // RV64 *W: operate on the low 32 bits, sign-extend the result
+        uint32_t f3 = get_funct3(inst_word);
+        uint32_t f7 = get_funct7(inst_word);
+        inst.rd = get_rd(inst_word);
+        inst.rs1 = get_rs1(inst_word);
+        inst.rs2 = get_rs2(inst_word);
+
+        if (f3 == 0x0 && f7 == 0x00) inst.op = OpType::ADDW;
+        else if (f3 == 0x0 && f7 == 0x20) inst.op = OpType::SUBW;
+        else if (f3 == 0x1 && f7 == 0x00) inst.op = OpType::SLLW;
+        else if (f3 == 0x5 && f7 == 0x00) inst.op = OpType::SRLW;
+        else if (f3 == 0x5 && f7 == 0x20) inst.op = OpType::SRAW;
+        else if (f3 == 0x0 && f7 == 0x01) inst.op = OpType::MULW;
+        else if (f3 == 0x4 && f7 == 0x01) inst.op = OpType::DIVW;
+        else if (f3 == 0x5 && f7 == 0x01) inst.op = OpType::DIVUW;
+        else if (f3 == 0x6 && f7 == 0x01) inst.op = OpType::REMW;
+        else if (f3 == 0x7 && f7 == 0x01) inst.op = OpType::REMUW;
+        else inst.op = OpType::UNKNOWN;
+    }
     else if (opcode == OP_FP) {
         uint32_t f3 = get_funct3(inst_word); // fmt
         uint32_t f7 = get_funct7(inst_word);
@@ -96,33 +189,81 @@ Instruction decode_instruction(uint32_t inst_word) {
         inst.fs2 = get_rs2(inst_word); // actually 'rm' for conversions
         inst.is_fp = true;
 
-        if (f3 == 0x3 || f3 == 0x7) {
-            // Arithmetic: fadd.d, fsub.d, etc.
+        if (f7 == 0x01 || f7 == 0x02 || f7 == 0x05 || f7 == 0x09 || f7 == 0x0D || f7 == 0x2D) {
+            // Arithmetic: fadd.d, fsub.d, etc. (funct3 is the rounding mode here)
             switch (f7) {
                 case 0x01:
                 case 0x02: inst.op = OpType::FADD_D; break;
                 case 0x05: inst.op = OpType::FSUB_D; break;
                 case 0x09: inst.op = OpType::FMUL_D; break;
                 case 0x0D: inst.op = OpType::FDIV_D; break;
+                case 0x2D:
+                    // fsqrt.d: rs2 field must be 0 and is not a source
+                    inst.fs2 = -1;
+                    inst.op = (get_rs2(inst_word) == 0) ? OpType::FSQRT_D : OpType::UNKNOWN;
+                    break;
                 default: inst.op = OpType::UNKNOWN;
             }
         }
+        else if (f7 == 0x11) {
+            // fsgnj.d / fsgnjn.d / fsgnjx.d
+            if (f3 == 0x0) inst.op = OpType::FSGNJ_D;
+            else if (f3 == 0x1) inst.op = OpType::FSGNJN_D;
+            else if (f3 == 0x2) inst.op = OpType::FSGNJX_D;
+            else inst.op = OpType::UNKNOWN;
+        }
+        else if (f7 == 0x15) {
+            // fmin.d / fmax.d
+            if (f3 == 0x0) inst.op = OpType::FMIN_D;
+            else if (f3 == 0x1) inst.op = OpType::FMAX_D;
+            else inst.op = OpType::UNKNOWN;
+        }
+        else if (f7 == 0x51) {
+            // feq.d / flt.d / fle.d → integer rd
+            inst.rd = inst.fd;
+            inst.fd = -1;
+            if (f3 == 0x2) inst.op = OpType::FEQ_D;
+            else if (f3 == 0x1) inst.op = OpType::FLT_D;
+            else if (f3 == 0x0) inst.op = OpType::FLE_D;
+            else inst.op = OpType::UNKNOWN;
+        }
         else if (f3 == 0 && (f7 == 0x60 || f7 == 0x68 || f7 == 0x69)) {
             // fcvt.d.w  → int32 to double
             inst.rs1 = inst.fs1;
             inst.fs1 = -1;
+            inst.fs2 = -1;
             inst.op = OpType::FCVT_D_W;
         }
         else if (f3 == 0x1 && (f7 == 0x60 || f7 == 0x61)) {
             // fcvt.w.d  → double to int32(actually the compiler will use fcvt.wu.d)
             inst.rd = inst.fd;
             inst.fd = -1;
+            inst.fs2 = -1;
             inst.op = OpType::FCVT_W_D;
         }
         else {
             inst.op = OpType::UNKNOWN;
         }
     }
+    else if (opcode == OP_FMADD || opcode == OP_FMSUB || opcode == OP_FNMSUB || opcode == OP_FNMADD) {
+        // R4-type: fs3 = inst[31:27], fmt = inst[26:25] (01 = double)
+        inst.fd = get_rd(inst_word);
+        inst.fs1 = get_rs1(inst_word);
+        inst.fs2 = get_rs2(inst_word);
+        inst.fs3 = (inst_word >> 27) & 0x1F;
+        inst.is_fp = true;
+        if (((inst_word >> 25) & 0x3) != 0x1) inst.op = OpType::UNKNOWN;
+        else if (opcode == OP_FMADD) inst.op = OpType::FMADD_D;
+        else if (opcode == OP_FMSUB) inst.op = OpType::FMSUB_D;
+        else if (opcode == OP_FNMSUB) inst.op = OpType::FNMSUB_D;
+        else inst.op = OpType::FNMADD_D;
+    }
+    else if (opcode == OP_FLOAD && get_funct3(inst_word) == 0x7) {
+        decode_vector_mem(inst_word, inst, false);
+    }
+    else if (opcode == OP_FSTORE && get_funct3(inst_word) == 0x7) {
+        decode_vector_mem(inst_word, inst, true);
+    }
     else if (opcode == OP_FLOAD) {
         uint32_t funct3 = get_funct3(inst_word);
         inst.fd = get_rd(inst_word);
@@ -159,6 +300,32 @@ Instruction decode_instruction(uint32_t inst_word) {
         else if (funct3 == 0x4) inst.op = OpType::XORI;
         else if (funct3 == 0x2) inst.op = OpType::SLTI;
         else if (funct3 == 0x3) inst.op = OpType::SLTIU;
+        else if (funct3 == 0x1 || funct3 == 0x5) {
+            // RV64 shifts: shamt = imm[5:0], funct6 = imm[11:6]
+            uint32_t funct6 = (inst_word >> 26) & 0x3F;
+            inst.imm = (inst_word >> 20) & 0x3F;
+            if (funct3 == 0x1 && funct6 == 0x00) inst.op = OpType::SLLI;
+            else if (funct3 == 0x5 && funct6 == 0x00) inst.op = OpType::SRLI;
+            else if (funct3 == 0x5 && funct6 == 0x10) inst.op = OpType::SRAI;
+            else inst.op = OpType::UNKNOWN;
+        }
+        else inst.op = OpType::UNKNOWN;
+    }
+    else if (opcode == OP_IMM_32) {
+        uint32_t funct3 = get_funct3(inst_word);
+        uint32_t f7 = get_funct7(inst_word);
+        inst.rd = get_rd(inst_word);
+        inst.rs1 = get_rs1(inst_word);
+        inst.imm = decode_imm_i(inst_word);
+
+        if (funct3 == 0x0) inst.op = OpType::ADDIW;
+        else if (funct3 == 0x1 || funct3 == 0x5) {
+            inst.imm = get_rs2(inst_word);   // shamt[4:0]
+            if (funct3 == 0x1 && f7 == 0x00) inst.op = OpType::SLLIW;
+            else if (funct3 == 0x5 && f7 == 0x00) inst.op = OpType::SRLIW;
+            else if (funct3 == 0x5 && f7 == 0x20) inst.op = OpType::SRAIW;
+            else inst.op = OpType::UNKNOWN;
+        }
         else inst.op = OpType::UNKNOWN;
     }
     else if (opcode == OP_LUI) {
@@ -176,6 +343,17 @@ Instruction decode_instruction(uint32_t inst_word) {
         inst.rd = get_rd(inst_word);
         inst.rs1 = get_rs1(inst_word);
         inst.imm = decode_imm_i(inst_word);
+    }
+    else if (opcode == OP_JAL) {
+        inst.op = OpType::JAL;
+        inst.rd = get_rd(inst_word);
+        // Decode J-type immediate
+        uint32_t imm = ((inst_word >> 31) & 1) << 20 |
+                   ((inst_word >> 12) & 0xFF) << 12 |
+                   ((inst_word >> 20) & 1) << 11 |
+                   ((inst_word >> 21) & 0x3FF) << 1;
+        // Sign-extend from 21 bits to 32 bits
+        inst.imm = static_cast<int32_t>(imm << 11) >> 11;
     } else if (opcode == OP_BRANCH) {
         uint32_t funct3 = get_funct3(inst_word);
         inst.rs1 = get_rs1(inst_word);
@@ -189,10 +367,25 @@ Instruction decode_instruction(uint32_t inst_word) {
         // Sign-extend from 13 bits to 32 bits
         inst.imm = static_cast<int32_t>(imm << 19) >> 19;
 
-        if (funct3 == 0x1) { // BNE
-            inst.op = OpType::BNE;
+        switch (funct3) {
+            case 0x0: inst.op = OpType::BEQ;  break;
+            case 0x1: inst.op = OpType::BNE;  break;
+            case 0x4: inst.op = OpType::BLT;  break;
+            case 0x5: inst.op = OpType::BGE;  break;
+            case 0x6: inst.op = OpType::BLTU; break;
+            case 0x7: inst.op = OpType::BGEU; break;
+            default:  inst.op = OpType::UNKNOWN;
+        }
+    }
+    else if (opcode == OP_V) {
+        if (get_funct3(inst_word) == 0x7 && ((inst_word >> 31) & 1) == 0) {
+            // vsetvli rd, rs1, vtypei
+            inst.op = OpType::VSETVLI;
+            inst.rd = get_rd(inst_word);
+            inst.rs1 = get_rs1(inst_word);
+            inst.imm = static_cast<int32_t>((inst_word >> 20) & 0x7FF);
         } else {
-            inst.op = OpType::UNKNOWN; // 只处理 BNE
+            decode_vector_arith(inst_word, inst);
         }
     }
     else if (opcode == OP_MISC_MEM && (inst_word & 0x000FFFFF) == 0x00000073) {
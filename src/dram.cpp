@@ -0,0 +1,176 @@
+// src/dram.cpp
+#include "dram.h"
+#include "sim_stats.h"
+#include <algorithm>
+#include <deque>
+
+struct DramRequest {
+    uint64_t id;
+    uint64_t arrival;
+    int bank;              // 通道内的 bank 下标（rank * banks + bank）
+    uint64_t row;
+    bool is_write;
+};
+
+struct DramBank {
+    bool open = false;     // 行缓冲中是否有打开的行
+    uint64_t row = 0;
+    uint64_t ready = 0;    // 可以接受下一条命令的周期
+};
+
+struct DramChannel {
+    std::deque<DramRequest> queue;
+    std::vector<DramBank> banks;
+    uint64_t bus_free = 0; // 数据总线空闲的周期
+};
+
+// 已调度请求的返回周期，按请求号取模保存
+struct DoneSlot {
+    uint64_t id = 0;
+    uint64_t done = 0;
+};
+
+static std::vector<DramChannel> channels;
+static std::vector<DoneSlot> done_ring;
+static uint64_t next_id = 1;
+static uint64_t cur_cycle = 0;     // 控制器已调度到的周期（不含）
+static uint64_t queued = 0;
+static uint64_t burst_bytes = 64;
+static uint64_t bursts_per_row = 32;
+
+void dram_reset(const SimConfig& cfg) {
+    channels.assign(cfg.dram_channels, DramChannel{});
+    for (auto& ch : channels) ch.banks.assign(cfg.dram_ranks * cfg.dram_banks, DramBank{});
+    done_ring.assign(1024, DoneSlot{});
+    next_id = 1;
+    cur_cycle = 0;
+    queued = 0;
+    // 有 cache 时按行突发，否则每次访问一个字
+    burst_bytes = cfg.dcache_enabled ? cfg.dcache_line : 8;
+    bursts_per_row = std::max<uint64_t>(1, cfg.dram_row_size / burst_bytes);
+}
+
+// 地址映射 row : rank : bank : channel : column，顺序访问先在同一行内连续命中
+static void map_address(uint64_t addr, int& channel, int& bank, uint64_t& row) {
+    uint64_t rest = addr / burst_bytes / bursts_per_row;
+    channel = static_cast<int>(rest % sim_config.dram_channels);
+    rest /= sim_config.dram_channels;
+    int b = static_cast<int>(rest % sim_config.dram_banks);
+    rest /= sim_config.dram_banks;
+    int rank = static_cast<int>(rest % sim_config.dram_ranks);
+    row = rest / sim_config.dram_ranks;
+    bank = rank * sim_config.dram_banks + b;
+}
+
+// 在周期 c 为一个通道选出并发射一个请求
+static void schedule_channel(DramChannel& ch, uint64_t c) {
+    const SimConfig& cfg = sim_config;
+    bool open_page = cfg.dram_page == "open";
+    auto pick = ch.queue.end();
+    if (cfg.dram_sched == "fcfs") {
+        if (ch.banks[ch.queue.front().bank].ready <= c) pick = ch.queue.begin();
+    } else {
+        // FR-FCFS：先选 bank 就绪的最老行命中请求，没有再选 bank 就绪的最老请求
+        for (auto it = ch.queue.begin(); it != ch.queue.end(); ++it) {
+            const DramBank& b = ch.banks[it->bank];
+            if (b.ready > c) continue;
+            if (b.open && b.row == it->row) {
+                pick = it;
+                break;
+            }
+            if (pick == ch.queue.end()) pick = it;
+        }
+    }
+    if (pick == ch.queue.end()) return;
+
+    DramBank& b = ch.banks[pick->bank];
+    uint64_t lat = cfg.dram_tcas;
+    if (b.open && b.row == pick->row) {
+        dram_stats.row_hits++;
+    } else if (b.open) {
+        dram_stats.row_conflicts++;
+        lat += cfg.dram_trp + cfg.dram_trcd;
+    } else {
+        dram_stats.row_empty++;
+        lat += cfg.dram_trcd;
+    }
+    uint64_t done = std::max(c + lat, ch.bus_free) + cfg.dram_tburst;
+    ch.bus_free = done;
+    if (open_page) {
+        // 行保持打开，同一行的下一次列访问在本次突发之后即可发出
+        b.open = true;
+        b.row = pick->row;
+        b.ready = c + lat - cfg.dram_tcas + cfg.dram_tburst;
+    } else {
+        // 突发结束后自动预充电
+        b.open = false;
+        b.ready = done + cfg.dram_trp;
+    }
+
+    if (pick->is_write) dram_stats.writes++;
+    else dram_stats.reads++;
+    dram_stats.bytes += burst_bytes;
+    dram_stats.latency_sum += done - pick->arrival;
+    done_ring[pick->id % done_ring.size()] = DoneSlot{pick->id, done};
+    ch.queue.erase(pick);
+    queued--;
+}
+
+static void step_cycle() {
+    for (auto& ch : channels) {
+        if (!ch.queue.empty()) schedule_channel(ch, cur_cycle);
+    }
+    dram_stats.queue_depth_sum += queued;
+    cur_cycle++;
+}
+
+// 调度 [cur_cycle, now) 内的各周期；队列空时直接跳到 now
+static void advance_to(uint64_t now) {
+    while (cur_cycle < now) {
+        if (queued == 0) {
+            cur_cycle = now;
+            break;
+        }
+        step_cycle();
+    }
+}
+
+uint64_t dram_request(uint64_t addr, bool is_write, uint64_t now) {
+    advance_to(now);
+    DramRequest r{next_id++, 0, 0, 0, is_write};
+    int channel = 0;
+    map_address(addr, channel, r.bank, r.row);
+    DramChannel& ch = channels[channel];
+    // 队列满：请求在控制器腾出位置后才进入队列（控制器时钟暂时领先于 now）
+    while (ch.queue.size() >= static_cast<size_t>(sim_config.dram_queue_size)) {
+        dram_stats.queue_full_cycles++;
+        step_cycle();
+    }
+    r.arrival = std::max(now, cur_cycle);
+    ch.queue.push_back(r);
+    queued++;
+    dram_stats.queue_depth_max = std::max(dram_stats.queue_depth_max, queued);
+    done_ring[r.id % done_ring.size()] = DoneSlot{r.id, DRAM_PENDING};
+    return r.id;
+}
+
+uint64_t dram_done_cycle(uint64_t req, uint64_t now) {
+    advance_to(now);
+    const DoneSlot& slot = done_ring[req % done_ring.size()];
+    if (slot.id == req) return slot.done;
+    // 槽位已被更新的请求占用：仍在队列中（被行命中长期越过）或早已返回
+    for (const auto& ch : channels) {
+        for (const auto& r : ch.queue) {
+            if (r.id == req) return DRAM_PENDING;
+        }
+    }
+    return 0;
+}
+
+bool dram_ready(const std::vector<uint64_t>& reqs, uint64_t now) {
+    for (uint64_t req : reqs) {
+        uint64_t done = dram_done_cycle(req, now);
+        if (done == DRAM_PENDING || done > now) return false;
+    }
+    return true;
+}
@@ -0,0 +1,23 @@
+// src/dram.h
+#ifndef DRAM_H
+#define DRAM_H
+#include <cstdint>
+#include <vector>
+#include "sim_config.h"
+
+// DRAM 时序模型：通道 / rank / bank，行缓冲（open / closed page），tRCD / tRP / tCAS / tBURST，
+// 每个通道一个有界请求队列，按 FR-FCFS（或 FCFS）调度。数据仍在 memory_int / memory_fp 中，
+// 这里只决定数据何时返回。控制器按需推进：每次发请求或查询时调度到当前周期为止，
+// 因此功能快进阶段也按同一时钟（sim_now）排空队列
+
+constexpr uint64_t DRAM_PENDING = UINT64_MAX;   // 请求仍在队列中，返回周期未知
+
+void dram_reset(const SimConfig& cfg);
+// 发出一次突发读 / 写，返回请求号（从 1 开始）。队列满时控制器先向前调度直到腾出位置
+uint64_t dram_request(uint64_t addr, bool is_write, uint64_t now);
+// 请求的数据返回周期；仍在队列中时返回 DRAM_PENDING
+uint64_t dram_done_cycle(uint64_t req, uint64_t now);
+// reqs 中的请求是否都已在 now 或之前返回
+bool dram_ready(const std::vector<uint64_t>& reqs, uint64_t now);
+
+#endif
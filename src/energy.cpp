@@ -0,0 +1,139 @@
+// src/energy.cpp
+#include "energy.h"
+#include "sim_config.h"
+#include "sim_stats.h"
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+// 配置文件中的键与 EnergyModel 字段的对应关系
+struct EnergyKey {
+    const char* name;
+    double EnergyModel::*field;
+};
+static const EnergyKey energy_keys[] = {
+    {"rs_write", &EnergyModel::rs_write},
+    {"wakeup_compare", &EnergyModel::wakeup_compare},
+    {"cdb_broadcast", &EnergyModel::cdb_broadcast},
+    {"rob_write", &EnergyModel::rob_write},
+    {"rob_read", &EnergyModel::rob_read},
+    {"fu_int_alu", &EnergyModel::fu_int_alu},
+    {"fu_muldiv", &EnergyModel::fu_muldiv},
+    {"fu_load", &EnergyModel::fu_load},
+    {"fu_store", &EnergyModel::fu_store},
+    {"fu_fp_add", &EnergyModel::fu_fp_add},
+    {"fu_fp_mul", &EnergyModel::fu_fp_mul},
+    {"fu_fp_div", &EnergyModel::fu_fp_div},
+    {"fu_fp_fma", &EnergyModel::fu_fp_fma},
+    {"fu_vec", &EnergyModel::fu_vec},
+    {"fu_vec_mem", &EnergyModel::fu_vec_mem},
+    {"l1d_access", &EnergyModel::l1d_access},
+    {"l1i_access", &EnergyModel::l1i_access},
+    {"mem_access", &EnergyModel::mem_access},
+    {"dram_activate", &EnergyModel::dram_activate},
+    {"dram_precharge", &EnergyModel::dram_precharge},
+    {"dram_burst", &EnergyModel::dram_burst},
+    {"leakage", &EnergyModel::leakage},
+    {"clock_ghz", &EnergyModel::clock_ghz},
+};
+
+bool load_energy_model(const std::string& path, EnergyModel& model, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::string line;
+    int line_no = 0;
+    while (std::getline(in, line)) {
+        ++line_no;
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+        size_t eq = line.find('=');
+        std::istringstream key_in(line.substr(0, eq));
+        std::string key;
+        if (!(key_in >> key)) continue;   // 空行
+        std::string where = path + ":" + std::to_string(line_no);
+        if (eq == std::string::npos) {
+            error = where + ": expected key = value";
+            return false;
+        }
+        std::istringstream value_in(line.substr(eq + 1));
+        double value;
+        std::string rest;
+        if (!(value_in >> value) || (value_in >> rest) || value < 0) {
+            error = where + ": bad value for " + key;
+            return false;
+        }
+        bool known = false;
+        for (const auto& k : energy_keys) {
+            if (key == k.name) {
+                model.*k.field = value;
+                known = true;
+                break;
+            }
+        }
+        if (!known) {
+            error = where + ": unknown key " + key;
+            return false;
+        }
+    }
+    if (model.clock_ghz <= 0) {
+        error = path + ": clock_ghz must be positive";
+        return false;
+    }
+    return true;
+}
+
+void energy_count_fu_op(const std::string& rs_type) {
+    EnergyStats& e = energy_stats;
+    if (rs_type == "INTALU") e.int_alu_ops++;
+    else if (rs_type == "MULDIV") e.muldiv_ops++;
+    else if (rs_type == "LOAD") e.load_ops++;
+    else if (rs_type == "STORE") e.store_ops++;
+    else if (rs_type == "FPADD") e.fp_add_ops++;
+    else if (rs_type == "FPMUL") e.fp_mul_ops++;
+    else if (rs_type == "FPDIV") e.fp_div_ops++;
+    else if (rs_type == "FPFMA") e.fp_fma_ops++;
+    else if (rs_type == "VEC") e.vec_ops++;
+    else if (rs_type == "VMEM") e.vec_mem_ops++;
+}
+
+void print_energy_report(std::ostream& os) {
+    const EnergyModel& m = sim_config.energy;
+    const EnergyStats& e = energy_stats;
+    const DramStats& d = dram_stats;
+
+    // 各部件动态能耗（pJ）
+    double rs = m.rs_write * e.rs_writes + m.wakeup_compare * e.wakeup_compares;
+    double cdb = m.cdb_broadcast * e.cdb_broadcasts;
+    double rob_e = m.rob_write * e.rob_writes + m.rob_read * e.rob_reads;
+    double fu = m.fu_int_alu * e.int_alu_ops + m.fu_muldiv * e.muldiv_ops + m.fu_load * e.load_ops +
+                m.fu_store * e.store_ops + m.fu_fp_add * e.fp_add_ops + m.fu_fp_mul * e.fp_mul_ops +
+                m.fu_fp_div * e.fp_div_ops + m.fu_fp_fma * e.fp_fma_ops + m.fu_vec * e.vec_ops +
+                m.fu_vec_mem * e.vec_mem_ops;
+    double caches = m.l1d_access * (cache_stats.load_accesses + cache_stats.store_accesses) +
+                    m.l1i_access * frontend_stats.icache_accesses;
+    // 开页策略下只有行冲突需要预充电，关页策略每次访问后都预充电
+    uint64_t activates = d.row_empty + d.row_conflicts;
+    uint64_t precharges = sim_config.dram_page == "open" ? d.row_conflicts : d.reads + d.writes;
+    double memory = m.mem_access * e.mem_accesses + m.dram_activate * activates +
+                    m.dram_precharge * precharges + m.dram_burst * (d.reads + d.writes);
+    double leakage = m.leakage * core_stats.cycles;
+    double total = rs + cdb + rob_e + fu + caches + memory + leakage;
+
+    double time_ns = core_stats.cycles / m.clock_ghz;
+    os << "--- energy (" << m.clock_ghz << " GHz) ---\n";
+    os << "reservation stns  : " << rs / 1000 << " nJ\n";
+    os << "CDB               : " << cdb / 1000 << " nJ\n";
+    os << "ROB               : " << rob_e / 1000 << " nJ\n";
+    os << "functional units  : " << fu / 1000 << " nJ\n";
+    os << "caches            : " << caches / 1000 << " nJ\n";
+    os << "memory            : " << memory / 1000 << " nJ\n";
+    os << "leakage           : " << leakage / 1000 << " nJ\n";
+    os << "total energy      : " << total / 1000 << " nJ ("
+       << (core_stats.committed ? total / core_stats.committed : 0.0) << " pJ/inst)\n";
+    // pJ / ns = mW
+    os << "avg power         : " << (time_ns > 0 ? total / time_ns : 0.0) << " mW\n";
+    os << "EDP               : " << total / 1000 * time_ns << " nJ*ns\n";
+}
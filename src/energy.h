@@ -0,0 +1,42 @@
+// src/energy.h
+#ifndef ENERGY_H
+#define ENERGY_H
+#include <iostream>
+#include <string>
+
+// 事件能耗模型：每类事件一个系数（pJ），乘以模拟中的活动计数得到动态能耗，
+// 再加每周期的静态能耗。系数从配置文件读取（见 configs/energy.cfg），未列出的键保持默认值
+struct EnergyModel {
+    double rs_write = 1.0;         // 发射写入一个保留站条目
+    double wakeup_compare = 0.1;   // CDB 标签与一个等待中的源操作数比较
+    double cdb_broadcast = 2.0;
+    double rob_write = 1.5;        // 分配条目或写回结果
+    double rob_read = 1.2;         // 提交读出
+    double fu_int_alu = 0.5;       // 各类功能单元每次操作
+    double fu_muldiv = 3.0;
+    double fu_load = 1.0;          // 地址计算，不含 cache
+    double fu_store = 1.0;
+    double fu_fp_add = 3.0;
+    double fu_fp_mul = 4.0;
+    double fu_fp_div = 15.0;
+    double fu_fp_fma = 6.0;
+    double fu_vec = 8.0;
+    double fu_vec_mem = 4.0;
+    double l1d_access = 10.0;
+    double l1i_access = 8.0;
+    double mem_access = 200.0;     // 未开 DRAM 模型时的平坦内存访问
+    double dram_activate = 1000.0;
+    double dram_precharge = 500.0;
+    double dram_burst = 500.0;     // 一次读 / 写突发
+    double leakage = 50.0;         // 每周期静态能耗
+    double clock_ghz = 2.0;        // 用于换算平均功率与 EDP
+};
+
+// 读取 "key = value" 格式的系数文件（# 开头为注释），出错时返回 false 并填写 error
+bool load_energy_model(const std::string& path, EnergyModel& model, std::string& error);
+// 按保留站类型（"INTALU"、"FPADD" 等）记一次功能单元操作
+void energy_count_fu_op(const std::string& rs_type);
+// 各部件能耗、总能耗、平均功率与 EDP
+void print_energy_report(std::ostream& os);
+
+#endif
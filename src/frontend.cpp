@@ -0,0 +1,209 @@
+// src/frontend.cpp
+#include "frontend.h"
+#include "tomasulo_sim.h"
+#include "cache.h"
+#include "trace.h"
+
+extern Instruction decode_instruction(uint32_t inst_word);
+
+std::deque<Instruction> fetch_queue;
+
+// L1I 缺失时取指停顿到该周期
+static uint64_t fetch_stall_until = 0;
+
+// 锁定的循环：指令下标 [start, end]，end 为循环分支
+struct LoopBuffer {
+    bool active = false;
+    size_t start = 0;
+    size_t end = 0;
+};
+static LoopBuffer loop_buffer;
+
+void frontend_reset(const SimConfig& cfg) {
+    fetch_queue.clear();
+    fetch_stall_until = 0;
+    loop_buffer = LoopBuffer{};
+    icache_reset(cfg);
+}
+
+void frontend_apply_redirect() {
+    if (!fetch_redirect) return;
+    next_fetch_idx = next_fetch_branch;
+    fetch_queue.clear();
+    // 跳出循环体（循环退出、违例冲刷到循环之外）时缓冲失效
+    if (next_fetch_idx < loop_buffer.start || next_fetch_idx > loop_buffer.end) loop_buffer.active = false;
+    // 在途的 L1I 缺失仍会填入 cache，但取指不再等待它
+    fetch_stall_until = 0;
+    fetch_redirect = false;
+}
+
+bool frontend_drained() {
+    if (trace_active()) return !trace_record(next_fetch_idx) && fetch_queue.empty();
+    return next_fetch_idx >= instruction_queue.size() && fetch_queue.empty();
+}
+
+void loop_buffer_observe(size_t branch_idx, size_t target_idx) {
+    size_t capacity = static_cast<size_t>(sim_config.loop_buffer);
+    if (capacity == 0 || trace_active()) return;
+    if (target_idx > branch_idx || branch_idx - target_idx + 1 > capacity) return;
+    if (loop_buffer.active && loop_buffer.start == target_idx && loop_buffer.end == branch_idx) return;
+    for (size_t i = target_idx; i < branch_idx; ++i) {
+        OpType op = instruction_queue[i].op;
+        if (is_branch_op(op) || op == OpType::JAL || op == OpType::JALR ||
+            op == OpType::EBREAK || op == OpType::UNKNOWN) {
+            return;
+        }
+    }
+    loop_buffer = LoopBuffer{true, target_idx, branch_idx};
+    frontend_stats.lb_captures++;
+}
+
+// 由循环缓冲供指；返回 false 时本周期走正常取指
+static bool loop_buffer_fetch(uint64_t now) {
+    if (!loop_buffer.active || fetch_barrier) return false;
+    if (next_fetch_idx < loop_buffer.start || next_fetch_idx > loop_buffer.end) {
+        loop_buffer.active = false;
+        return false;
+    }
+    if (static_cast<int>(fetch_queue.size()) >= sim_config.fetch_queue_size) {
+        frontend_stats.queue_full_cycles++;
+        return true;
+    }
+    int fetched = 0;
+    while (fetched < sim_config.fetch_width &&
+           static_cast<int>(fetch_queue.size()) < sim_config.fetch_queue_size) {
+        fetch_queue.push_back(instruction_queue[next_fetch_idx]);
+        Instruction& instr = fetch_queue.back();
+        instr.fetch_cycle = now;
+        if (next_fetch_idx == loop_buffer.end) {
+            instr.lb_predicted = true;
+            next_fetch_idx = loop_buffer.start;
+            frontend_stats.lb_iterations++;
+        } else {
+            next_fetch_idx++;
+        }
+        fetched++;
+        frontend_stats.fetched++;
+        frontend_stats.lb_insts++;
+    }
+    frontend_stats.lb_cycles++;
+    return true;
+}
+
+// trace 驱动取指：next_fetch_idx 是记录序号，控制流沿 trace 走，不做重定向；
+// 分支 / JALR 仍要等解析后才继续取指，发生跳转时结束取指组
+static void fetch_stage_trace(uint64_t now) {
+    // 最老在途指令之前的记录不会再重新取指
+    if (rob_count > 0) trace_retire(rob_instr[rob_head].seq);
+    else if (!fetch_queue.empty()) trace_retire(fetch_queue.front().seq);
+    else trace_retire(next_fetch_idx);
+
+    const TraceRecord* rec = trace_record(next_fetch_idx);
+    if (!rec) return;
+    if (fetch_stall_until > now) {
+        frontend_stats.icache_stall_cycles++;
+        return;
+    }
+    if (fetch_barrier) {
+        frontend_stats.branch_stall_cycles++;
+        return;
+    }
+    if (static_cast<int>(fetch_queue.size()) >= sim_config.fetch_queue_size) {
+        frontend_stats.queue_full_cycles++;
+        return;
+    }
+
+    uint64_t group_pc = rec->pc;
+    int extra = icache_fetch_access(group_pc, now);
+    if (extra > 0) {
+        fetch_stall_until = now + extra;
+        frontend_stats.icache_stall_cycles++;
+        return;
+    }
+
+    int fetched = 0;
+    while (rec && fetched < sim_config.fetch_width &&
+           static_cast<int>(fetch_queue.size()) < sim_config.fetch_queue_size) {
+        if (icache_line_of(rec->pc) != icache_line_of(group_pc)) break;
+        Instruction instr = decode_instruction(rec->raw);
+        instr.pc = rec->pc;
+        instr.seq = next_fetch_idx;
+        instr.mem_addr = rec->addr;
+        instr.taken = rec->taken;
+        bool taken = rec->taken;
+        next_fetch_idx++;
+        if (instr.op == OpType::UNKNOWN || instr.op == OpType::EBREAK) {
+            // 模拟器不支持的指令（系统调用、CSR 等）不进入流水线
+            trace_stats.skipped++;
+        } else {
+            fetch_queue.push_back(instr);
+            fetch_queue.back().fetch_cycle = now;
+            fetched++;
+            frontend_stats.fetched++;
+            if (is_branch_op(instr.op) || instr.op == OpType::JALR) {
+                fetch_barrier = true;
+                break;
+            }
+        }
+        if (taken) break;
+        rec = trace_record(next_fetch_idx);
+    }
+}
+
+void fetch_stage() {
+    uint64_t now = sim_now();
+    if (trace_active()) return fetch_stage_trace(now);
+    if (next_fetch_idx >= instruction_queue.size()) return;
+    if (loop_buffer_fetch(now)) return;
+
+    if (fetch_stall_until > now) {
+        frontend_stats.icache_stall_cycles++;
+        return;
+    }
+    // 没有分支预测：分支 / JALR 解析前不再取后续指令
+    if (fetch_barrier) {
+        frontend_stats.branch_stall_cycles++;
+        return;
+    }
+    if (static_cast<int>(fetch_queue.size()) >= sim_config.fetch_queue_size) {
+        frontend_stats.queue_full_cycles++;
+        return;
+    }
+
+    uint64_t group_pc = instruction_queue[next_fetch_idx].pc;
+    int extra = icache_fetch_access(group_pc, now);
+    if (extra > 0) {
+        fetch_stall_until = now + extra;
+        frontend_stats.icache_stall_cycles++;
+        return;
+    }
+
+    // 一个取指组不跨越 L1I 行
+    int fetched = 0;
+    while (fetched < sim_config.fetch_width && next_fetch_idx < instruction_queue.size() &&
+           static_cast<int>(fetch_queue.size()) < sim_config.fetch_queue_size) {
+        const Instruction& instr = instruction_queue[next_fetch_idx];
+        if (icache_line_of(instr.pc) != icache_line_of(group_pc)) break;
+
+        if (instr.op == OpType::EBREAK) {
+            // ebreak / ecall 视为程序结束：停止取指，等待已取指令排空
+            next_fetch_idx = instruction_queue.size();
+            break;
+        }
+        fetch_queue.push_back(instr);
+        fetch_queue.back().fetch_cycle = now;
+        fetched++;
+        frontend_stats.fetched++;
+
+        if (instr.op == OpType::JAL) {
+            // JAL 的目标在译码时已知，直接重定向
+            next_fetch_idx = (instr.pc + instr.imm) / 4;
+            break;
+        }
+        next_fetch_idx++;
+        if (is_branch_op(instr.op) || instr.op == OpType::JALR) {
+            fetch_barrier = true;
+            break;
+        }
+    }
+}
@@ -0,0 +1,25 @@
+// src/frontend.h
+#ifndef FRONTEND_H
+#define FRONTEND_H
+#include <deque>
+#include "instruction.h"
+#include "sim_config.h"
+
+// 解耦前端：取指按 L1I 行每周期最多取 fetch_width 条放入取指队列，
+// 发射阶段从队头按序取指令；两者之间的队列吸收后端的阻塞
+extern std::deque<Instruction> fetch_queue;
+
+void frontend_reset(const SimConfig& cfg);
+// 若有重定向（分支解析 / 违例冲刷）则清空取指队列并从新地址取指
+void frontend_apply_redirect();
+// 取指阶段，每周期调用一次
+void fetch_stage();
+// 所有指令均已取完且队列为空
+bool frontend_drained();
+
+// 循环缓冲（--loop_buffer=N）：向后跳转的条件分支解析为跳转时，若循环体不超过 N 条且其中没有其他控制流，
+// 锁定该循环。此后由缓冲按 fetch_width 送出已译码的循环体，不访问 L1I、不受取指组边界限制，
+// 循环分支按跳转预测、不阻塞取指；分支实际不跳转时由执行阶段冲刷其后的指令并退出
+void loop_buffer_observe(size_t branch_idx, size_t target_idx);
+
+#endif
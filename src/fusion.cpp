@@ -0,0 +1,105 @@
+// src/fusion.cpp
+#include "fusion.h"
+#include "tomasulo_sim.h"
+#include "sim_stats.h"
+#include <cstdint>
+
+// load+op 中第二条指令可接的整数运算；is_commutative 表示 load 结果可以作为第二个源
+static bool fusable_alu_op(OpType op, bool& is_commutative) {
+    is_commutative = false;
+    switch (op) {
+        case OpType::ADD: case OpType::AND: case OpType::OR: case OpType::XOR: case OpType::ADDW:
+            is_commutative = true;
+            return true;
+        case OpType::SUB: case OpType::SLT: case OpType::SLTU:
+        case OpType::SLL: case OpType::SRL: case OpType::SRA:
+        case OpType::SUBW: case OpType::SLLW: case OpType::SRLW: case OpType::SRAW:
+        case OpType::ADDI: case OpType::ANDI: case OpType::ORI: case OpType::XORI:
+        case OpType::SLTI: case OpType::SLTIU:
+        case OpType::SLLI: case OpType::SRLI: case OpType::SRAI:
+        case OpType::ADDIW: case OpType::SLLIW: case OpType::SRLIW: case OpType::SRAIW:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool fuse_pair(const Instruction& first, const Instruction& second,
+               const SimConfig& cfg, Instruction& fused) {
+    if (first.fusion != FusionKind::NONE || second.fusion != FusionKind::NONE) return false;
+    if (first.rd <= 0 || second.rd != first.rd) return false;
+    int rd = first.rd;
+
+    // lui rd, hi; addi(w) rd, rd, lo
+    if (cfg.fuse_lui_addi && first.op == OpType::LUI &&
+        (second.op == OpType::ADDI || second.op == OpType::ADDIW) && second.rs1 == rd) {
+        fused = first;
+        fused.fused_raw = second.raw;
+        fused.fusion = FusionKind::LUI_ADDI;
+        fused.fused_op = second.op;
+        fused.fused_imm = second.imm;
+        return true;
+    }
+
+    // auipc rd, hi; jalr rd, lo(rd)：目标 = auipc 的 pc + hi + lo，不再依赖寄存器
+    if (cfg.fuse_auipc_jalr && first.op == OpType::AUIPC &&
+        second.op == OpType::JALR && second.rs1 == rd) {
+        int64_t target = static_cast<int64_t>(first.pc) + first.imm + second.imm;
+        if (target < 0 || target > INT32_MAX) return false;
+        // 保留 jalr 的 pc 使链接地址仍为 pc + 4；目标作为 rs1 = x0 时的立即数
+        fused = second;
+        fused.fused_raw = first.raw;
+        fused.fusion = FusionKind::AUIPC_JALR;
+        fused.rs1 = -1;
+        fused.imm = static_cast<int32_t>(target);
+        return true;
+    }
+
+    // slli rd, rs1, sh; add rd, rd, rs2（只融合地址计算常见的 1–3 位移位）
+    if (cfg.fuse_slli_add && first.op == OpType::SLLI && first.imm >= 1 && first.imm <= 3 &&
+        second.op == OpType::ADD) {
+        int other = second.rs1 == rd ? second.rs2 : (second.rs2 == rd ? second.rs1 : -1);
+        if (other < 0 || other == rd) return false;
+        fused = first;
+        fused.fused_raw = second.raw;
+        fused.fusion = FusionKind::SLLI_ADD;
+        fused.fused_op = OpType::ADD;
+        fused.fused_rs = other;
+        return true;
+    }
+
+    // load rd, off(rs1); op rd, rd, src
+    bool is_commutative = false;
+    if (cfg.fuse_load_op && is_load_op(first.op) && first.op != OpType::FLD &&
+        fusable_alu_op(second.op, is_commutative)) {
+        int other = -1;
+        if (second.rs2 < 0) {
+            // I-type：load 结果只能是 rs1
+            if (second.rs1 != rd) return false;
+        } else if (second.rs1 == rd && second.rs2 != rd) {
+            other = second.rs2;
+        } else if (second.rs2 == rd && second.rs1 != rd && is_commutative) {
+            other = second.rs1;
+        } else {
+            return false;
+        }
+        fused = first;
+        fused.fused_raw = second.raw;
+        fused.fusion = FusionKind::LOAD_OP;
+        fused.fused_op = second.op;
+        fused.fused_rs = other;
+        fused.fused_imm = second.imm;
+        return true;
+    }
+    return false;
+}
+
+void fusion_count_commit(FusionKind kind) {
+    switch (kind) {
+        case FusionKind::LUI_ADDI:   fusion_stats.lui_addi++; break;
+        case FusionKind::AUIPC_JALR: fusion_stats.auipc_jalr++; break;
+        case FusionKind::SLLI_ADD:   fusion_stats.slli_add++; break;
+        case FusionKind::LOAD_OP:    fusion_stats.load_op++; break;
+        case FusionKind::NONE:       break;
+    }
+}
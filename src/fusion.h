@@ -0,0 +1,16 @@
+// src/fusion.h
+#ifndef FUSION_H
+#define FUSION_H
+#include "instruction.h"
+#include "sim_config.h"
+
+// 宏融合：发射阶段检查取指队列头部相邻的两条指令，可融合时合并为一条内部指令，
+// 只占一个 ROB 条目和一个 RS 条目，提交时按两条体系结构指令计数。
+// 融合要求第二条指令覆盖第一条的目的寄存器，因此第一条的中间结果无需写回。
+// 可融合时返回 true 并写入 fused
+bool fuse_pair(const Instruction& first, const Instruction& second,
+               const SimConfig& cfg, Instruction& fused);
+// 融合条目提交时按模式计数
+void fusion_count_commit(FusionKind kind);
+
+#endif
@@ -0,0 +1,634 @@
+// src/history.cpp
+#include "history.h"
+#include "prf.h"
+#include "sim_config.h"
+#include "sim_stats.h"
+#include "tomasulo_sim.h"
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+// 寄存器槽：[0,32) 整数、[32,64) 浮点、[64,96) 向量、96 为 vl
+const int NUM_REG_SLOTS = 97;
+const int VL_SLOT = 96;
+
+// 以下视图都是平凡可复制、按 8 字节对齐的定长结构（生成时先整体清零），
+// 条目变化时按 8 字节字比较新旧视图，只记录变了的字
+
+
+// 操作数：kind 为 OperandValue 的下标加一（0 表示无值），标量只用 e[0]
+struct Value {
+    uint8_t kind;
+    uint64_t e[VLMAX];
+};
+
+// 目的寄存器：kind 为 DestReg 的下标
+struct DestView {
+    int8_t kind;
+    int8_t idx;
+};
+
+struct RobView {
+    bool busy;
+    bool eliminated;
+    InstructionState state;
+    DestView dest;
+    int lsq_idx;
+    int phys_dest;
+    int move_src;
+    Value result;
+    Instruction instr;
+};
+
+struct RsView {
+    bool busy;
+    OpType op;
+    OpType post_op;
+    DestView dest;
+    int rob_idx;
+    int Pj, Pk, Pr;
+    int64_t A;
+    uint64_t pc;
+    int Qj, Qk, Qr, Qvl, Qst;   // 整数标签，打印时经 tag_name 转成 "ROB<n>" / "P<n>"
+    Value Vj, Vk, Vr, Vvl;
+};
+
+struct LsqView {
+    bool valid;
+    bool is_store;
+    bool addr_ready;
+    bool executed;
+    bool committed;
+    OpType op;
+    DestView dest;
+    int fwd_lsq;
+    int rob_idx;
+    uint64_t address;
+    int64_t stride;
+    uint64_t vl;
+    Value data;
+};
+
+struct RegView {
+    uint64_t e[VLMAX];     // 整数值 / 浮点位模式 / 向量元素 / vl
+    int status;            // 状态表标签
+    int map;               // PRF 模式下的推测映射，否则为 -1
+};
+
+// 所有保留站按 rs_pools 的顺序拼成一个下标空间
+const int NUM_RS_TOTAL = NUM_INTALU_RS + NUM_MULDIV_RS + NUM_LOAD_RS + NUM_STORE_RS + NUM_FPADD_RS +
+                         NUM_FPMUL_RS + NUM_FPDIV_RS + NUM_FPFMA_RS + NUM_VEC_RS + NUM_VEC_MEM_RS;
+
+// ROB / LSQ 的 head、tail、count
+using QueuePtrs = std::array<int, 6>;
+
+struct MachineState {
+    RobView rob[ROB_SIZE];
+    RsView rs[NUM_RS_TOTAL];
+    LsqView lsq[LSQ_SIZE];
+    RegView regs[NUM_REG_SLOTS];
+    QueuePtrs ptrs{};
+    std::vector<CDB> cdb;
+};
+
+enum Table : uint8_t { T_ROB, T_RS, T_LSQ, T_REG };
+
+// 一个 8 字节字的变化：table 中第 idx 个条目视图的第 word 个字
+struct WordChange {
+    Table table;
+    uint8_t word;
+    uint16_t idx;
+    uint64_t before, after;
+};
+
+// 一个周期内的全部变化
+struct CycleDelta {
+    uint64_t cycle = 0;
+    std::vector<WordChange> changes;
+    QueuePtrs ptrs_before{}, ptrs_after{};
+    std::vector<CDB> cdb;    // 本周期的广播
+};
+
+static MachineState shadow;            // 最后记录周期末的状态
+static std::vector<CycleDelta> ring;
+static size_t ring_next = 0;           // 下一个写入位置
+static size_t ring_size = 0;
+static uint64_t next_now = 0;          // 下一次记录预期的 sim_now()，不连续说明中间有功能快进
+
+// ---------- 由模拟器状态生成视图 ----------
+
+static void fill_value(Value& v, const std::optional<OperandValue>& src) {
+    if (!src) return;
+    v.kind = static_cast<uint8_t>(src->index() + 1);
+    if (auto* i = std::get_if<uint64_t>(&*src)) v.e[0] = *i;
+    else if (auto* d = std::get_if<double>(&*src)) std::memcpy(&v.e[0], d, sizeof(double));
+    else std::memcpy(v.e, std::get<VecData>(*src).e.data(), sizeof(v.e));
+}
+
+static void fill_dest(DestView& d, const DestReg& r) {
+    d.kind = static_cast<int8_t>(r.index());
+    if (auto* x = std::get_if<IntReg>(&r)) d.idx = static_cast<int8_t>(x->idx);
+    else if (auto* f = std::get_if<FpReg>(&r)) d.idx = static_cast<int8_t>(f->idx);
+    else if (auto* v = std::get_if<VecReg>(&r)) d.idx = static_cast<int8_t>(v->idx);
+}
+
+// ROB 条目与其冷数据（指令副本）
+struct RobLive {
+    const ROBEntry& e;
+    const Instruction& instr;
+};
+
+static void make_view(const RobLive& live, RobView& v) {
+    const ROBEntry& e = live.e;
+    if (!e.busy) {
+        v.busy = false;
+        return;
+    }
+    std::memset(static_cast<void*>(&v), 0, sizeof(v));
+    v.busy = true;
+    v.eliminated = e.eliminated;
+    v.state = e.state;
+    fill_dest(v.dest, e.dest);
+    v.lsq_idx = e.lsq_idx;
+    v.phys_dest = e.phys_dest;
+    v.move_src = e.move_src;
+    fill_value(v.result, e.result);
+    std::memcpy(&v.instr, &live.instr, sizeof(Instruction));
+}
+
+static void make_view(const ReservationStation& rs, RsView& v) {
+    if (!rs.busy) {
+        v.busy = false;
+        return;
+    }
+    std::memset(static_cast<void*>(&v), 0, sizeof(v));
+    v.busy = true;
+    v.op = rs.op;
+    v.post_op = rs.post_op;
+    fill_dest(v.dest, rs.dest);
+    v.rob_idx = rs.ROB_idx;
+    v.Pj = rs.Pj;
+    v.Pk = rs.Pk;
+    v.Pr = rs.Pr;
+    v.A = rs.A;
+    v.pc = rs.pc;
+    v.Qj = rs.Qj;
+    v.Qk = rs.Qk;
+    v.Qr = rs.Qr;
+    v.Qvl = rs.Qvl;
+    v.Qst = rs.Qst;
+    fill_value(v.Vj, rs.Vj);
+    fill_value(v.Vk, rs.Vk);
+    fill_value(v.Vr, rs.Vr);
+    fill_value(v.Vvl, rs.Vvl);
+}
+
+static void make_view(const LSQEntry& e, LsqView& v) {
+    if (!e.valid) {
+        v.valid = false;
+        return;
+    }
+    std::memset(static_cast<void*>(&v), 0, sizeof(v));
+    v.valid = true;
+    v.is_store = e.is_store;
+    v.addr_ready = e.addr_ready;
+    v.executed = e.executed;
+    v.committed = e.committed;
+    v.op = e.op;
+    fill_dest(v.dest, e.dest);
+    v.fwd_lsq = e.fwd_lsq;
+    v.rob_idx = e.rob_idx;
+    v.address = e.address;
+    v.stride = e.stride;
+    v.vl = e.vl;
+    fill_value(v.data, e.data);
+}
+
+static void make_reg_view(int slot, RegView& v, bool prf) {
+    std::memset(static_cast<void*>(&v), 0, sizeof(v));
+    v.map = -1;
+    if (slot < 32) {
+        v.e[0] = regs_int[slot];
+        v.status = regs_int_status[slot];
+        if (prf) v.map = rename_int[slot];
+    } else if (slot < 64) {
+        std::memcpy(&v.e[0], &regs_fp[slot - 32], sizeof(double));
+        v.status = regs_fp_status[slot - 32];
+        if (prf) v.map = rename_fp[slot - 32];
+    } else if (slot < VL_SLOT) {
+        std::memcpy(v.e, regs_vec[slot - 64].e.data(), sizeof(v.e));
+        v.status = regs_vec_status[slot - 64];
+    } else {
+        v.e[0] = vec_vl;
+        v.status = vec_vl_status;
+    }
+}
+
+// ---------- 视图与模拟器状态逐字段比较（无变化时不生成视图） ----------
+
+static bool same_value(const Value& v, const std::optional<OperandValue>& src) {
+    if (!src) return v.kind == 0;
+    if (v.kind != src->index() + 1) return false;
+    if (auto* i = std::get_if<uint64_t>(&*src)) return v.e[0] == *i;
+    if (auto* d = std::get_if<double>(&*src)) return std::memcmp(&v.e[0], d, sizeof(double)) == 0;
+    return std::memcmp(v.e, std::get<VecData>(*src).e.data(), sizeof(v.e)) == 0;
+}
+
+static bool same_dest(const DestView& d, const DestReg& r) {
+    DestView cur{};
+    fill_dest(cur, r);
+    return cur.kind == d.kind && cur.idx == d.idx;
+}
+
+static bool unchanged(const RobView& v, const RobLive& live) {
+    const ROBEntry& e = live.e;
+    if (v.busy != e.busy) return false;
+    if (!e.busy) return true;
+    // 同一条目在一个周期内可能先提交再分配给新指令，pc 与取指周期区分不同的动态指令
+    return v.state == e.state && v.lsq_idx == e.lsq_idx && v.phys_dest == e.phys_dest &&
+           v.eliminated == e.eliminated && v.instr.pc == live.instr.pc && v.instr.fetch_cycle == live.instr.fetch_cycle &&
+           same_value(v.result, e.result) && same_dest(v.dest, e.dest) && v.move_src == e.move_src;
+}
+
+static bool unchanged(const RsView& v, const ReservationStation& rs) {
+    if (v.busy != rs.busy) return false;
+    if (!rs.busy) return true;
+    return v.rob_idx == rs.ROB_idx && v.op == rs.op && v.A == rs.A && v.pc == rs.pc && v.post_op == rs.post_op &&
+           v.Pj == rs.Pj && v.Pk == rs.Pk && v.Pr == rs.Pr && v.Qj == rs.Qj && v.Qk == rs.Qk &&
+           v.Qr == rs.Qr && v.Qvl == rs.Qvl && v.Qst == rs.Qst &&
+           same_value(v.Vj, rs.Vj) && same_value(v.Vk, rs.Vk) && same_value(v.Vr, rs.Vr) &&
+           same_value(v.Vvl, rs.Vvl) && same_dest(v.dest, rs.dest);
+}
+
+static bool unchanged(const LsqView& v, const LSQEntry& e) {
+    if (v.valid != e.valid) return false;
+    if (!e.valid) return true;
+    return v.rob_idx == e.rob_idx && v.addr_ready == e.addr_ready && v.address == e.address &&
+           v.executed == e.executed && v.committed == e.committed && v.fwd_lsq == e.fwd_lsq &&
+           v.is_store == e.is_store && v.op == e.op && v.stride == e.stride && v.vl == e.vl &&
+           same_value(v.data, e.data) && same_dest(v.dest, e.dest);
+}
+
+static bool reg_unchanged(int slot, const RegView& v, bool prf) {
+    if (slot < 32) {
+        return v.e[0] == regs_int[slot] && v.status == regs_int_status[slot] &&
+               v.map == (prf ? rename_int[slot] : -1);
+    }
+    if (slot < 64) {
+        return std::memcmp(&v.e[0], &regs_fp[slot - 32], sizeof(double)) == 0 &&
+               v.status == regs_fp_status[slot - 32] && v.map == (prf ? rename_fp[slot - 32] : -1);
+    }
+    if (slot < VL_SLOT) {
+        return std::memcmp(v.e, regs_vec[slot - 64].e.data(), sizeof(v.e)) == 0 &&
+               v.status == regs_vec_status[slot - 64];
+    }
+    return v.e[0] == vec_vl && v.status == vec_vl_status;
+}
+
+template <typename T>
+static void diff_words(CycleDelta& d, Table table, int idx, const T& before, const T& after) {
+    static_assert(std::is_trivially_copyable_v<T> && sizeof(T) % 8 == 0 && sizeof(T) / 8 <= 256, "view layout");
+    const char* b = reinterpret_cast<const char*>(&before);
+    const char* a = reinterpret_cast<const char*>(&after);
+    for (size_t w = 0; w < sizeof(T) / 8; ++w) {
+        uint64_t x, y;
+        std::memcpy(&x, b + 8 * w, 8);
+        std::memcpy(&y, a + 8 * w, 8);
+        if (x != y) d.changes.push_back({table, static_cast<uint8_t>(w), static_cast<uint16_t>(idx), x, y});
+    }
+}
+
+// 条目释放时只清 busy 位、保留其余内容，释放只产生一个字的变化
+template <typename T, typename Live>
+static bool record_entry(CycleDelta& d, Table table, int idx, T& prev, const Live& live) {
+    if (unchanged(prev, live)) return false;
+    T cur = prev;
+    make_view(live, cur);
+    diff_words(d, table, idx, prev, cur);
+    prev = cur;
+    return true;
+}
+
+static QueuePtrs read_ptrs() {
+    return {rob_head, rob_tail, rob_count, lsq_head, lsq_tail, lsq_count};
+}
+
+void history_reset() {
+    ring.clear();
+    ring_next = ring_size = 0;
+    if (sim_config.history <= 0) return;
+    ring.resize(sim_config.history);
+    bool prf = prf_mode();
+    std::memset(static_cast<void*>(&shadow.rob), 0, sizeof(shadow.rob));
+    std::memset(static_cast<void*>(&shadow.rs), 0, sizeof(shadow.rs));
+    std::memset(static_cast<void*>(&shadow.lsq), 0, sizeof(shadow.lsq));
+    int k = 0;
+    for (const auto& a : rs_pools) {
+        for (int i = 0; i < a.size; ++i) make_view(a.rs[i], shadow.rs[k++]);
+    }
+    for (int i = 0; i < ROB_SIZE; ++i) make_view(RobLive{rob[i], rob_instr[i]}, shadow.rob[i]);
+    for (int i = 0; i < LSQ_SIZE; ++i) make_view(lsq[i], shadow.lsq[i]);
+    for (int s = 0; s < NUM_REG_SLOTS; ++s) make_reg_view(s, shadow.regs[s], prf);
+    shadow.ptrs = read_ptrs();
+    shadow.cdb.clear();
+    next_now = sim_now();
+}
+
+static int dest_slot(const DestView& d) {
+    switch (d.kind) {
+        case 1: return d.idx;
+        case 2: return 32 + d.idx;
+        case 3: return 64 + d.idx;
+        default: return -1;
+    }
+}
+
+static void record_reg(CycleDelta& d, int slot, bool prf) {
+    if (reg_unchanged(slot, shadow.regs[slot], prf)) return;
+    RegView cur;
+    make_reg_view(slot, cur, prf);
+    diff_words(d, T_REG, slot, shadow.regs[slot], cur);
+    shadow.regs[slot] = cur;
+}
+
+void history_record(uint64_t cycle) {
+    if (ring.empty()) return;
+    CycleDelta& d = ring[ring_next];
+    d.cycle = cycle;
+    d.changes.clear();
+
+    // 寄存器值、状态表与重命名表只在发射、提交和冲刷时改变，都伴随写该寄存器的指令的 ROB 条目变化，
+    // 因此只检查变化的 ROB 条目新旧内容中的目的寄存器；中间有功能快进时全部检查
+    int reg_slots[4 * ROB_SIZE];
+    int num_slots = 0;
+    auto touch = [&](DestView dest, OpType op) {
+        int slot = dest_slot(dest);
+        if (slot >= 0) reg_slots[num_slots++] = slot;
+        if (op == OpType::VSETVLI) reg_slots[num_slots++] = VL_SLOT;
+    };
+    for (int i = 0; i < ROB_SIZE; ++i) {
+        RobView& v = shadow.rob[i];
+        DestView old_dest = v.dest;
+        OpType old_op = v.instr.op;
+        if (record_entry(d, T_ROB, i, v, RobLive{rob[i], rob_instr[i]})) {
+            touch(old_dest, old_op);
+            touch(v.dest, v.instr.op);
+        }
+    }
+    int k = 0;
+    for (const auto& a : rs_pools) {
+        for (int i = 0; i < a.size; ++i, ++k) record_entry(d, T_RS, k, shadow.rs[k], a.rs[i]);
+    }
+    for (int i = 0; i < LSQ_SIZE; ++i) record_entry(d, T_LSQ, i, shadow.lsq[i], lsq[i]);
+
+    bool prf = prf_mode();
+    if (sim_now() != next_now) {
+        for (int slot = 0; slot < NUM_REG_SLOTS; ++slot) record_reg(d, slot, prf);
+    } else {
+        for (int n = 0; n < num_slots; ++n) record_reg(d, reg_slots[n], prf);
+    }
+    next_now = sim_now() + 1;
+    d.ptrs_before = shadow.ptrs;
+    d.ptrs_after = shadow.ptrs = read_ptrs();
+    d.cdb = cdb_list;
+
+    ring_next = (ring_next + 1) % ring.size();
+    if (ring_size < ring.size()) ring_size++;
+}
+
+// ---------- 打印 ----------
+
+static const char* state_name(InstructionState s) {
+    switch (s) {
+        case InstructionState::ISSUED: return "ISSUED";
+        case InstructionState::EXECUTING: return "EXECUTING";
+        case InstructionState::EXECUTED: return "EXECUTED";
+        case InstructionState::COMMITTED: return "COMMITTED";
+        default: return "UNKNOWN";
+    }
+}
+
+static std::string dest_name(const DestView& d) {
+    switch (d.kind) {
+        case 1: return "x" + std::to_string(d.idx);
+        case 2: return "f" + std::to_string(d.idx);
+        case 3: return "v" + std::to_string(d.idx);
+        default: return "-";
+    }
+}
+
+static std::string value_text(const Value& v) {
+    if (v.kind == 1) return format_operand_value(OperandValue(v.e[0]));
+    if (v.kind == 2) {
+        double d;
+        std::memcpy(&d, &v.e[0], sizeof(double));
+        return format_operand_value(OperandValue(d));
+    }
+    VecData vec;
+    std::memcpy(vec.e.data(), v.e, sizeof(v.e));
+    return format_operand_value(OperandValue(vec));
+}
+
+static std::string tag_text(int tag) {
+    return tag == NO_TAG ? "-" : tag_name(tag);
+}
+
+static std::string rob_line(int i, const RobView& e) {
+    std::ostringstream os;
+    os << "ROB" << i;
+    if (!e.busy) return os.str() + " : (free)";
+    os << " : " << e.instr.toString() << " dest=" << dest_name(e.dest) << " state=" << state_name(e.state)
+       << " lsq_idx=" << e.lsq_idx;
+    if (e.phys_dest >= 0) os << " phys=P" << e.phys_dest;
+    if (e.eliminated) os << " [eliminated]";
+    if (e.move_src != NO_TAG) os << " move_src=" << tag_name(e.move_src);
+    if (e.result.kind) os << " result=" << value_text(e.result);
+    return os.str();
+}
+
+static std::string rs_line(int k, const RsView& rs) {
+    std::ostringstream os;
+    for (const auto& a : rs_pools) {
+        if (k < a.size) {
+            os << a.type << "_RS" << k;
+            break;
+        }
+        k -= a.size;
+    }
+    if (!rs.busy) return os.str() + ": (free)";
+    os << ": op=" << static_cast<int>(rs.op) << " ROB" << rs.rob_idx << " Qj=" << tag_text(rs.Qj)
+       << " Qk=" << tag_text(rs.Qk);
+    if (rs.Vj.kind) os << " Vj=" << value_text(rs.Vj);
+    if (rs.Vk.kind) os << " Vk=" << value_text(rs.Vk);
+    if (rs.Qr != NO_TAG) os << " Qr=" << tag_name(rs.Qr);
+    if (rs.Vr.kind) os << " Vr=" << value_text(rs.Vr);
+    if (rs.Qvl != NO_TAG) os << " Qvl=" << tag_name(rs.Qvl);
+    if (rs.Qst != NO_TAG) os << " Qst=" << tag_name(rs.Qst);
+    os << " A=" << rs.A;
+    return os.str();
+}
+
+static std::string lsq_line(int i, const LsqView& e) {
+    std::ostringstream os;
+    os << "LSQ" << i;
+    if (!e.valid) return os.str() + ": (free)";
+    os << ": " << (e.is_store ? "store" : "load") << " ROB" << e.rob_idx << " addr=";
+    if (e.addr_ready) os << "0x" << std::hex << e.address << std::dec;
+    else os << "?";
+    if (e.data.kind) os << " data=" << value_text(e.data);
+    if (e.executed) os << " [executed]";
+    if (e.fwd_lsq >= 0) os << " fwd=LSQ" << e.fwd_lsq;
+    if (e.committed) os << " [committed]";
+    return os.str();
+}
+
+static std::string reg_name(int slot) {
+    if (slot < 32) return "x" + std::to_string(slot);
+    if (slot < 64) return "f" + std::to_string(slot - 32);
+    if (slot < VL_SLOT) return "v" + std::to_string(slot - 64);
+    return "vl";
+}
+
+static std::string reg_line(int slot, const RegView& r) {
+    std::ostringstream os;
+    os << reg_name(slot) << " = ";
+    Value v{};
+    v.kind = slot >= 32 && slot < 64 ? 2 : (slot >= 64 && slot < VL_SLOT ? 3 : 1);
+    std::memcpy(v.e, r.e, sizeof(v.e));
+    os << (v.kind == 1 ? std::to_string(static_cast<int64_t>(r.e[0])) : value_text(v));
+    if (r.status != NO_TAG) os << " <- " << tag_name(r.status);
+    if (r.map >= 0) os << " -> " << tag_name(prf_tag(r.map));
+    return os.str();
+}
+
+static bool reg_shown(int slot, const RegView& r) {
+    if (r.status != NO_TAG) return true;
+    // PRF 映射只显示偏离初始对应关系（x_i -> P_i，f_i -> P_(int_size + i)）的
+    if (slot < 32 && r.map >= 0 && r.map != slot) return true;
+    if (slot >= 32 && slot < 64 && r.map >= 0 && r.map != sim_config.prf_int_size + slot - 32) return true;
+    for (uint64_t e : r.e) {
+        if (e != 0) return true;
+    }
+    return false;
+}
+
+static void print_state(std::ostream& os, const MachineState& st, uint64_t cycle) {
+    const QueuePtrs& p = st.ptrs;
+    os << "========== CYCLE " << cycle << " ==========\n";
+    os << "ROB (head=" << p[0] << ", tail=" << p[1] << ", count=" << p[2] << "):\n";
+    for (int k = 0; k < p[2]; ++k) {
+        int i = (p[0] + k) % ROB_SIZE;
+        os << "  " << rob_line(i, st.rob[i]) << "\n";
+    }
+    os << "Reservation stations:\n";
+    for (int k = 0; k < NUM_RS_TOTAL; ++k) {
+        if (st.rs[k].busy) os << "  " << rs_line(k, st.rs[k]) << "\n";
+    }
+    os << "LSQ (head=" << p[3] << ", tail=" << p[4] << ", count=" << p[5] << "):\n";
+    for (int k = 0; k < p[5]; ++k) {
+        int i = (p[3] + k) % LSQ_SIZE;
+        os << "  " << lsq_line(i, st.lsq[i]) << "\n";
+    }
+    os << "Registers:\n";
+    for (int s = 0; s < NUM_REG_SLOTS; ++s) {
+        if (reg_shown(s, st.regs[s])) os << "  " << reg_line(s, st.regs[s]) << "\n";
+    }
+    if (!st.cdb.empty()) {
+        os << "CDB Broadcasts:\n";
+        for (const auto& c : st.cdb) os << "  " << tag_name(c.producer) << " -> " << format_operand_value(c.value) << "\n";
+    }
+}
+
+static char* entry_bytes(MachineState& st, Table table, int idx) {
+    switch (table) {
+        case T_ROB: return reinterpret_cast<char*>(&st.rob[idx]);
+        case T_RS:  return reinterpret_cast<char*>(&st.rs[idx]);
+        case T_LSQ: return reinterpret_cast<char*>(&st.lsq[idx]);
+        default:    return reinterpret_cast<char*>(&st.regs[idx]);
+    }
+}
+
+static void apply(MachineState& st, const CycleDelta& d, bool forward) {
+    for (const auto& c : d.changes) {
+        uint64_t v = forward ? c.after : c.before;
+        std::memcpy(entry_bytes(st, c.table, c.idx) + 8 * c.word, &v, 8);
+    }
+    st.ptrs = forward ? d.ptrs_after : d.ptrs_before;
+}
+
+// 以 "- 修改前 / + 修改后" 列出一个周期变化的条目；st 为该周期末的状态
+static void print_delta(std::ostream& os, const MachineState& st, const CycleDelta& d) {
+    static MachineState before;
+    before = st;
+    apply(before, d, false);
+    os << "---------- cycle " << d.cycle << ": " << d.changes.size() << " words changed ----------\n";
+    // 同一条目的字连续记录
+    for (size_t c = 0; c < d.changes.size(); ++c) {
+        const WordChange& w = d.changes[c];
+        if (c > 0 && d.changes[c - 1].table == w.table && d.changes[c - 1].idx == w.idx) continue;
+        std::string b, a;
+        switch (w.table) {
+            case T_ROB: b = rob_line(w.idx, before.rob[w.idx]); a = rob_line(w.idx, st.rob[w.idx]); break;
+            case T_RS:  b = rs_line(w.idx, before.rs[w.idx]); a = rs_line(w.idx, st.rs[w.idx]); break;
+            case T_LSQ: b = lsq_line(w.idx, before.lsq[w.idx]); a = lsq_line(w.idx, st.lsq[w.idx]); break;
+            default:    b = reg_line(w.idx, before.regs[w.idx]); a = reg_line(w.idx, st.regs[w.idx]); break;
+        }
+        os << "  - " << b << "\n  + " << a << "\n";
+    }
+    for (const auto& c : d.cdb) os << "  CDB " << tag_name(c.producer) << " -> " << format_operand_value(c.value) << "\n";
+}
+
+// ---------- 单步器 ----------
+
+void history_step(std::istream& in, std::ostream& os) {
+    if (ring_size == 0) {
+        os << "history: no cycles recorded (use --history=N)\n";
+        return;
+    }
+    size_t oldest = (ring_next + ring.size() - ring_size) % ring.size();
+    auto at = [&](size_t k) -> const CycleDelta& { return ring[(oldest + k) % ring.size()]; };
+
+    // 从最新状态开始，pos 为当前所在周期在保留范围内的下标
+    static MachineState cur;
+    cur = shadow;
+    size_t pos = ring_size - 1;
+    auto move_to = [&](size_t target) {
+        while (pos > target) apply(cur, at(pos--), false);
+        while (pos < target) apply(cur, at(++pos), true);
+        cur.cdb = at(pos).cdb;
+    };
+
+    os << "history: cycles " << at(0).cycle << " .. " << at(ring_size - 1).cycle
+       << " (p print, d changes, b/f [N] step, g CYCLE goto, q quit)\n";
+    std::string line;
+    while (os << "[cycle " << at(pos).cycle << "] > " << std::flush, std::getline(in, line)) {
+        std::istringstream cmd(line);
+        std::string op;
+        if (!(cmd >> op)) continue;
+        if (op == "q") break;
+        if (op == "p") {
+            print_state(os, cur, at(pos).cycle);
+        } else if (op == "d") {
+            print_delta(os, cur, at(pos));
+        } else if (op == "b" || op == "f") {
+            size_t n = 1;
+            cmd >> n;
+            size_t target = op == "b" ? (n > pos ? 0 : pos - n) : std::min(ring_size - 1, pos + n);
+            move_to(target);
+            print_delta(os, cur, at(pos));
+        } else if (op == "g") {
+            uint64_t cycle = 0;
+            if (!(cmd >> cycle) || cycle < at(0).cycle || cycle > at(ring_size - 1).cycle) {
+                os << "cycle out of range\n";
+                continue;
+            }
+            // 周期编号在采样模式下可能不连续，取不超过目标的最后一个
+            size_t target = 0;
+            while (target + 1 < ring_size && at(target + 1).cycle <= cycle) ++target;
+            move_to(target);
+            print_state(os, cur, at(pos).cycle);
+        } else {
+            os << "unknown command: " << op << "\n";
+        }
+    }
+}
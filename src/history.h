@@ -0,0 +1,17 @@
+// src/history.h
+#ifndef HISTORY_H
+#define HISTORY_H
+#include <cstdint>
+#include <iostream>
+
+// 时间回溯调试：每周期末把 ROB、保留站、LSQ、寄存器（值、状态表、PRF 映射）与上一周期比较，
+// 只记录变化条目的前后值，保存在容纳最近 history 个周期的环形缓冲中。
+// 前后值都在，单步器可从最新状态向前撤销、向后重做，重建任一保留周期的完整状态
+
+void history_reset();
+// 每周期末调用，cycle 与逐周期打印的 CYCLE 编号一致
+void history_record(uint64_t cycle);
+// 交互式单步器：从最后记录的周期开始，读取命令直到 q 或输入结束
+void history_step(std::istream& in, std::ostream& os);
+
+#endif
@@ -24,6 +24,24 @@ std::string reg_name_fp(int f) {
     return "f?";
 }
 
+// 向量寄存器名称（v0–v31）
+std::string reg_name_vec(int v) {
+    if (v >= 0 && v < 32) {
+        return "v" + std::to_string(v);
+    }
+    return "v?";
+}
+
+// vtypei → "e64, m1, ta, ma"
+static std::string format_vtype(int32_t vtypei) {
+    static const char* lmul_names[] = {"m1", "m2", "m4", "m8", "m?", "mf8", "mf4", "mf2"};
+    int sew = 8 << ((vtypei >> 3) & 0x7);
+    std::string s = "e" + std::to_string(sew) + ", " + lmul_names[vtypei & 0x7];
+    s += (vtypei & 0x40) ? ", ta" : ", tu";
+    s += (vtypei & 0x80) ? ", ma" : ", mu";
+    return s;
+}
+
 // 格式化函数类型
 using FormatFn = std::function<std::string(const Instruction&)>;
 
@@ -61,6 +79,44 @@ static const std::unordered_map<OpType, FormatFn>& get_formatters() {
             return "sra " + std::string(reg_name_int(i.rd)) + ", " + reg_name_int(i.rs1) + ", " + reg_name_int(i.rs2); 
         }},
 
+        // RV64 移位立即数 / 字操作
+        {OpType::SLLI, [](const Instruction& i) {
+            return "slli " + std::string(reg_name_int(i.rd)) + ", " + reg_name_int(i.rs1) + ", " + std::to_string(i.imm);
+        }},
+        {OpType::SRLI, [](const Instruction& i) {
+            return "srli " + std::string(reg_name_int(i.rd)) + ", " + reg_name_int(i.rs1) + ", " + std::to_string(i.imm);
+        }},
+        {OpType::SRAI, [](const Instruction& i) {
+            return "srai " + std::string(reg_name_int(i.rd)) + ", " + reg_name_int(i.rs1) + ", " + std::to_string(i.imm);
+        }},
+        {OpType::ADDW, [](const Instruction& i) {
+            return "addw " + std::string(reg_name_int(i.rd)) + ", " + reg_name_int(i.rs1) + ", " + reg_name_int(i.rs2);
+        }},
+        {OpType::SUBW, [](const Instruction& i) {
+            return "subw " + std::string(reg_name_int(i.rd)) + ", " + reg_name_int(i.rs1) + ", " + reg_name_int(i.rs2);
+        }},
+        {OpType::SLLW, [](const Instruction& i) {
+            return "sllw " + std::string(reg_name_int(i.rd)) + ", " + reg_name_int(i.rs1) + ", " + reg_name_int(i.rs2);
+        }},
+        {OpType::SRLW, [](const Instruction& i) {
+            return "srlw " + std::string(reg_name_int(i.rd)) + ", " + reg_name_int(i.rs1) + ", " + reg_name_int(i.rs2);
+        }},
+        {OpType::SRAW, [](const Instruction& i) {
+            return "sraw " + std::string(reg_name_int(i.rd)) + ", " + reg_name_int(i.rs1) + ", " + reg_name_int(i.rs2);
+        }},
+        {OpType::ADDIW, [](const Instruction& i) {
+            return "addiw " + std::string(reg_name_int(i.rd)) + ", " + reg_name_int(i.rs1) + ", " + std::to_string(i.imm);
+        }},
+        {OpType::SLLIW, [](const Instruction& i) {
+            return "slliw " + std::string(reg_name_int(i.rd)) + ", " + reg_name_int(i.rs1) + ", " + std::to_string(i.imm);
+        }},
+        {OpType::SRLIW, [](const Instruction& i) {
+            return "srliw " + std::string(reg_name_int(i.rd)) + ", " + reg_name_int(i.rs1) + ", " + std::to_string(i.imm);
+        }},
+        {OpType::SRAIW, [](const Instruction& i) {
+            return "sraiw " + std::string(reg_name_int(i.rd)) + ", " + reg_name_int(i.rs1) + ", " + std::to_string(i.imm);
+        }},
+
         // 乘除
         {OpType::MUL,    [](const Instruction& i) { 
             return "mul " + std::string(reg_name_int(i.rd)) + ", " + reg_name_int(i.rs1) + ", " + reg_name_int(i.rs2); 
@@ -86,6 +142,21 @@ static const std::unordered_map<OpType, FormatFn>& get_formatters() {
         {OpType::REMU,   [](const Instruction& i) { 
             return "remu " + std::string(reg_name_int(i.rd)) + ", " + reg_name_int(i.rs1) + ", " + reg_name_int(i.rs2); 
         }},
+        {OpType::MULW, [](const Instruction& i) {
+            return "mulw " + std::string(reg_name_int(i.rd)) + ", " + reg_name_int(i.rs1) + ", " + reg_name_int(i.rs2);
+        }},
+        {OpType::DIVW, [](const Instruction& i) {
+            return "divw " + std::string(reg_name_int(i.rd)) + ", " + reg_name_int(i.rs1) + ", " + reg_name_int(i.rs2);
+        }},
+        {OpType::DIVUW, [](const Instruction& i) {
+            return "divuw " + std::string(reg_name_int(i.rd)) + ", " + reg_name_int(i.rs1) + ", " + reg_name_int(i.rs2);
+        }},
+        {OpType::REMW, [](const Instruction& i) {
+            return "remw " + std::string(reg_name_int(i.rd)) + ", " + reg_name_int(i.rs1) + ", " + reg_name_int(i.rs2);
+        }},
+        {OpType::REMUW, [](const Instruction& i) {
+            return "remuw " + std::string(reg_name_int(i.rd)) + ", " + reg_name_int(i.rs1) + ", " + reg_name_int(i.rs2);
+        }},
 
         // 立即数
         {OpType::ADDI,  [](const Instruction& i) { 
@@ -120,6 +191,36 @@ static const std::unordered_map<OpType, FormatFn>& get_formatters() {
         {OpType::FDIV_D, [](const Instruction& i) { 
             return "fdiv.d " + reg_name_fp(i.fd) + ", " + reg_name_fp(i.fs1) + ", " + reg_name_fp(i.fs2); 
         }},
+        {OpType::FSQRT_D, [](const Instruction& i) {
+            return "fsqrt.d " + reg_name_fp(i.fd) + ", " + reg_name_fp(i.fs1);
+        }},
+        {OpType::FMADD_D, [](const Instruction& i) {
+            return "fmadd.d " + reg_name_fp(i.fd) + ", " + reg_name_fp(i.fs1) + ", " + reg_name_fp(i.fs2) + ", " + reg_name_fp(i.fs3);
+        }},
+        {OpType::FMSUB_D, [](const Instruction& i) {
+            return "fmsub.d " + reg_name_fp(i.fd) + ", " + reg_name_fp(i.fs1) + ", " + reg_name_fp(i.fs2) + ", " + reg_name_fp(i.fs3);
+        }},
+        {OpType::FNMSUB_D, [](const Instruction& i) {
+            return "fnmsub.d " + reg_name_fp(i.fd) + ", " + reg_name_fp(i.fs1) + ", " + reg_name_fp(i.fs2) + ", " + reg_name_fp(i.fs3);
+        }},
+        {OpType::FNMADD_D, [](const Instruction& i) {
+            return "fnmadd.d " + reg_name_fp(i.fd) + ", " + reg_name_fp(i.fs1) + ", " + reg_name_fp(i.fs2) + ", " + reg_name_fp(i.fs3);
+        }},
+        {OpType::FMIN_D, [](const Instruction& i) {
+            return "fmin.d " + reg_name_fp(i.fd) + ", " + reg_name_fp(i.fs1) + ", " + reg_name_fp(i.fs2);
+        }},
+        {OpType::FMAX_D, [](const Instruction& i) {
+            return "fmax.d " + reg_name_fp(i.fd) + ", " + reg_name_fp(i.fs1) + ", " + reg_name_fp(i.fs2);
+        }},
+        {OpType::FSGNJ_D, [](const Instruction& i) {
+            return "fsgnj.d " + reg_name_fp(i.fd) + ", " + reg_name_fp(i.fs1) + ", " + reg_name_fp(i.fs2);
+        }},
+        {OpType::FSGNJN_D, [](const Instruction& i) {
+            return "fsgnjn.d " + reg_name_fp(i.fd) + ", " + reg_name_fp(i.fs1) + ", " + reg_name_fp(i.fs2);
+        }},
+        {OpType::FSGNJX_D, [](const Instruction& i) {
+            return "fsgnjx.d " + reg_name_fp(i.fd) + ", " + reg_name_fp(i.fs1) + ", " + reg_name_fp(i.fs2);
+        }},
         {OpType::FEQ_D,  [](const Instruction& i) { 
             return "feq.d " + std::string(reg_name_int(i.rd)) + ", " + reg_name_fp(i.fs1) + ", " + reg_name_fp(i.fs2); 
         }},
@@ -157,6 +258,27 @@ static const std::unordered_map<OpType, FormatFn>& get_formatters() {
         {OpType::FSD, [](const Instruction& i) { 
             return "fsd " + reg_name_fp(i.fs2) + ", " + std::to_string(i.imm) + "(" + reg_name_int(i.rs1) + ")"; 
         }},
+        {OpType::LB, [](const Instruction& i) {
+            return "lb " + std::string(reg_name_int(i.rd)) + ", " + std::to_string(i.imm) + "(" + reg_name_int(i.rs1) + ")";
+        }},
+        {OpType::LH, [](const Instruction& i) {
+            return "lh " + std::string(reg_name_int(i.rd)) + ", " + std::to_string(i.imm) + "(" + reg_name_int(i.rs1) + ")";
+        }},
+        {OpType::LBU, [](const Instruction& i) {
+            return "lbu " + std::string(reg_name_int(i.rd)) + ", " + std::to_string(i.imm) + "(" + reg_name_int(i.rs1) + ")";
+        }},
+        {OpType::LHU, [](const Instruction& i) {
+            return "lhu " + std::string(reg_name_int(i.rd)) + ", " + std::to_string(i.imm) + "(" + reg_name_int(i.rs1) + ")";
+        }},
+        {OpType::LWU, [](const Instruction& i) {
+            return "lwu " + std::string(reg_name_int(i.rd)) + ", " + std::to_string(i.imm) + "(" + reg_name_int(i.rs1) + ")";
+        }},
+        {OpType::SB, [](const Instruction& i) {
+            return "sb " + std::string(reg_name_int(i.rs2)) + ", " + std::to_string(i.imm) + "(" + reg_name_int(i.rs1) + ")";
+        }},
+        {OpType::SH, [](const Instruction& i) {
+            return "sh " + std::string(reg_name_int(i.rs2)) + ", " + std::to_string(i.imm) + "(" + reg_name_int(i.rs1) + ")";
+        }},
 
         // 其他
         {OpType::LUI,   [](const Instruction& i) { 
@@ -175,12 +297,98 @@ static const std::unordered_map<OpType, FormatFn>& get_formatters() {
         {OpType::BNE, [](const Instruction& i) { 
             return "bne " + std::string(reg_name_int(i.rs1)) + ", " + reg_name_int(i.rs2) + ", " + std::to_string(i.imm); 
         }},
+        {OpType::BEQ, [](const Instruction& i) {
+            return "beq " + std::string(reg_name_int(i.rs1)) + ", " + reg_name_int(i.rs2) + ", " + std::to_string(i.imm);
+        }},
+        {OpType::BLT, [](const Instruction& i) {
+            return "blt " + std::string(reg_name_int(i.rs1)) + ", " + reg_name_int(i.rs2) + ", " + std::to_string(i.imm);
+        }},
+        {OpType::BGE, [](const Instruction& i) {
+            return "bge " + std::string(reg_name_int(i.rs1)) + ", " + reg_name_int(i.rs2) + ", " + std::to_string(i.imm);
+        }},
+        {OpType::BLTU, [](const Instruction& i) {
+            return "bltu " + std::string(reg_name_int(i.rs1)) + ", " + reg_name_int(i.rs2) + ", " + std::to_string(i.imm);
+        }},
+        {OpType::BGEU, [](const Instruction& i) {
+            return "bgeu " + std::string(reg_name_int(i.rs1)) + ", " + reg_name_int(i.rs2) + ", " + std::to_string(i.imm);
+        }},
+        {OpType::JAL, [](const Instruction& i) {
+            return "jal " + std::string(reg_name_int(i.rd)) + ", " + std::to_string(i.imm);
+        }},
+
+        // 向量
+        {OpType::VSETVLI, [](const Instruction& i) {
+            return "vsetvli " + std::string(reg_name_int(i.rd)) + ", " + reg_name_int(i.rs1) + ", " + format_vtype(i.imm);
+        }},
+        {OpType::VLE64_V, [](const Instruction& i) {
+            return "vle64.v " + reg_name_vec(i.vd) + ", (" + reg_name_int(i.rs1) + ")";
+        }},
+        {OpType::VLSE64_V, [](const Instruction& i) {
+            return "vlse64.v " + reg_name_vec(i.vd) + ", (" + reg_name_int(i.rs1) + "), " + reg_name_int(i.rs2);
+        }},
+        {OpType::VSE64_V, [](const Instruction& i) {
+            return "vse64.v " + reg_name_vec(i.vs3) + ", (" + reg_name_int(i.rs1) + ")";
+        }},
+        {OpType::VSSE64_V, [](const Instruction& i) {
+            return "vsse64.v " + reg_name_vec(i.vs3) + ", (" + reg_name_int(i.rs1) + "), " + reg_name_int(i.rs2);
+        }},
+        {OpType::VADD_VV, [](const Instruction& i) {
+            return "vadd.vv " + reg_name_vec(i.vd) + ", " + reg_name_vec(i.vs2) + ", " + reg_name_vec(i.vs1);
+        }},
+        {OpType::VADD_VX, [](const Instruction& i) {
+            return "vadd.vx " + reg_name_vec(i.vd) + ", " + reg_name_vec(i.vs2) + ", " + reg_name_int(i.rs1);
+        }},
+        {OpType::VMUL_VV, [](const Instruction& i) {
+            return "vmul.vv " + reg_name_vec(i.vd) + ", " + reg_name_vec(i.vs2) + ", " + reg_name_vec(i.vs1);
+        }},
+        {OpType::VMUL_VX, [](const Instruction& i) {
+            return "vmul.vx " + reg_name_vec(i.vd) + ", " + reg_name_vec(i.vs2) + ", " + reg_name_int(i.rs1);
+        }},
+        {OpType::VMACC_VV, [](const Instruction& i) {
+            return "vmacc.vv " + reg_name_vec(i.vd) + ", " + reg_name_vec(i.vs1) + ", " + reg_name_vec(i.vs2);
+        }},
+        {OpType::VMACC_VX, [](const Instruction& i) {
+            return "vmacc.vx " + reg_name_vec(i.vd) + ", " + reg_name_int(i.rs1) + ", " + reg_name_vec(i.vs2);
+        }},
+        {OpType::VFADD_VV, [](const Instruction& i) {
+            return "vfadd.vv " + reg_name_vec(i.vd) + ", " + reg_name_vec(i.vs2) + ", " + reg_name_vec(i.vs1);
+        }},
+        {OpType::VFADD_VF, [](const Instruction& i) {
+            return "vfadd.vf " + reg_name_vec(i.vd) + ", " + reg_name_vec(i.vs2) + ", " + reg_name_fp(i.fs1);
+        }},
+        {OpType::VFMUL_VV, [](const Instruction& i) {
+            return "vfmul.vv " + reg_name_vec(i.vd) + ", " + reg_name_vec(i.vs2) + ", " + reg_name_vec(i.vs1);
+        }},
+        {OpType::VFMUL_VF, [](const Instruction& i) {
+            return "vfmul.vf " + reg_name_vec(i.vd) + ", " + reg_name_vec(i.vs2) + ", " + reg_name_fp(i.fs1);
+        }},
+        {OpType::VFMACC_VV, [](const Instruction& i) {
+            return "vfmacc.vv " + reg_name_vec(i.vd) + ", " + reg_name_vec(i.vs1) + ", " + reg_name_vec(i.vs2);
+        }},
+        {OpType::VFMACC_VF, [](const Instruction& i) {
+            return "vfmacc.vf " + reg_name_vec(i.vd) + ", " + reg_name_fp(i.fs1) + ", " + reg_name_vec(i.vs2);
+        }},
     };
     return formatters;
 }
 
 std::string Instruction::toString() const {
     const auto& formatters = get_formatters();
+    if (fusion == FusionKind::AUIPC_JALR) {
+        // 融合后的 jalr 以绝对目标地址为立即数
+        return "auipc+jalr " + std::string(reg_name_int(rd)) + ", " + std::to_string(imm);
+    }
+    if (fusion != FusionKind::NONE) {
+        // 还原出第二条指令：rd = rd op (fused_rs | fused_imm)
+        Instruction first = *this;
+        first.fusion = FusionKind::NONE;
+        Instruction second = first;
+        second.op = fused_op;
+        second.rs1 = rd;
+        second.rs2 = fused_rs;
+        second.imm = fused_imm;
+        return first.toString() + " ; " + second.toString();
+    }
     auto it = formatters.find(op);
     if (it != formatters.end()) {
         return it->second(*this);
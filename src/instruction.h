@@ -8,29 +8,70 @@
 enum class OpType {
     ADD, SUB, AND, OR, XOR, SLT, SLTU,
     ADDI, ANDI, ORI, XORI, SLTI, SLTIU,
-    SLL, SRL, SRA,
+    SLL, SRL, SRA, SLLI, SRLI, SRAI,
+    ADDW, SUBW, SLLW, SRLW, SRAW,
+    ADDIW, SLLIW, SRLIW, SRAIW,
     MUL, MULH, MULHSU, MULHU,
     DIV, DIVU, REM, REMU,
-    FADD_D, FSUB_D, FMUL_D, FDIV_D,
+    MULW, DIVW, DIVUW, REMW, REMUW,
+    FADD_D, FSUB_D, FMUL_D, FDIV_D, FSQRT_D,
+    FMADD_D, FMSUB_D, FNMSUB_D, FNMADD_D,
+    FMIN_D, FMAX_D, FSGNJ_D, FSGNJN_D, FSGNJX_D,
     FEQ_D, FLT_D, FLE_D,
     FCVT_D_W, FCVT_W_D,
     LD, SD, LW, SW, FLD, FSD,
+    LB, LH, LBU, LHU, LWU, SB, SH,
     LUI, AUIPC,
-    JALR, BNE, EBREAK, UNKNOWN
+    JAL, JALR, BEQ, BNE, BLT, BGE, BLTU, BGEU, EBREAK,
+    // RVV 子集（SEW=64, LMUL=1）
+    VSETVLI,
+    VLE64_V, VLSE64_V, VSE64_V, VSSE64_V,
+    VADD_VV, VADD_VX, VMUL_VV, VMUL_VX, VMACC_VV, VMACC_VX,
+    VFADD_VV, VFADD_VF, VFMUL_VV, VFMUL_VF, VFMACC_VV, VFMACC_VF,
+    UNKNOWN
+};
+
+// 宏融合（macro-op fusion）：发射前相邻两条指令合并成的一个内部操作
+enum class FusionKind {
+    NONE,
+    LUI_ADDI,    // lui rd, hi; addi(w) rd, rd, lo         → 常数生成
+    AUIPC_JALR,  // auipc rd, hi; jalr rd, lo(rd)          → 目标在译码时已知的调用
+    SLLI_ADD,    // slli rd, rs1, sh; add rd, rd, rs2      → 移位加（地址计算）
+    LOAD_OP      // load rd, off(rs1); op rd, rd, src      → 取数后立即运算
 };
 
 struct Instruction {
     uint32_t raw;
     OpType op;
+    uint64_t pc = 0;  // 指令地址（代码从 0x0 开始，由 loader 填写）
     int rd = -1;    // integer dest
     int rs1 = -1;   // integer src1
     int rs2 = -1;   // integer src2
     int fd = -1;    // float dest
     int fs1 = -1;   // float src1
     int fs2 = -1;   // float src2
+    int fs3 = -1;   // float src3 (fused multiply-add)
+    int vd = -1;    // vector dest
+    int vs1 = -1;   // vector src1
+    int vs2 = -1;   // vector src2
+    int vs3 = -1;   // vector store data
     int32_t imm = 0;
     bool is_fp = false;
 
+    // 宏融合：第二条指令的操作及其另一个源（fused_rs 为 -1 时使用 fused_imm）
+    FusionKind fusion = FusionKind::NONE;
+    OpType fused_op = OpType::UNKNOWN;
+    int fused_rs = -1;
+    int32_t fused_imm = 0;
+    uint32_t fused_raw = 0;    // 另一条指令的指令字（提交 trace 按两条记录输出）
+
+    uint64_t fetch_cycle = 0;  // 进入取指队列的周期（关键路径分析用）
+    bool lb_predicted = false; // 循环缓冲按跳转送出的循环分支，解析为不跳转时冲刷其后的指令
+    // trace 驱动模式：记录序号（冲刷后按它重新取指）、记录中的访存地址与分支结果
+    uint64_t seq = 0;
+    uint64_t mem_addr = 0;
+    bool taken = false;
+
     std::string toString() const;
 
 private:
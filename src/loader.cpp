@@ -26,6 +26,7 @@ std::vector<Instruction> load_instructions_from_bin(const std::string& filename)
                        (static_cast<uint32_t>(buffer[i*4+3]) << 24);
 
         Instruction inst = decode_instruction(word);
+        inst.pc = i * 4;
         // 可选：跳过 unknown 指令
         // if (inst.op != OpType::UNKNOWN)
         instructions.push_back(inst);
@@ -1,46 +1,134 @@
 #include "instruction.h"
 #include "tomasulo_sim.h"
+#include "sim_api.h"
+#include "server.h"
+#include "history.h"
+#include "trace.h"
 #include <vector>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <cstdlib>
 
 std::vector<Instruction> load_instructions_from_bin(const std::string& filename);
 
+static void print_usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [options] <program.bin>\n"
+              << "       " << prog << " [options] --serve=SOCKET [--workers=N]\n"
+              << "       " << prog << " [options] --trace=FILE\n"
+              << "  --quiet                      只输出最终内存与统计，不打印每周期状态\n"
+              << "  --history=N --step           保留最近 N 个周期的状态变化，运行结束（或出错）后进入单步器\n"
+              << "  --fetch_width=N              每周期取指条数（不跨 L1I 行）\n"
+              << "  --fetch_queue_size=N         取指队列项数\n"
+              << "  --icache=on|off              启用 L1 指令 cache（缺失代价为 --mem_latency）\n"
+              << "  --icache_sets=N --icache_ways=N --icache_line=BYTES\n"
+              << "  --loop_buffer=N              循环缓冲容量（指令数），0 表示关闭\n"
+              << "  --rename=rob|prf             在途值保存在 ROB，或把整数/浮点寄存器重命名到物理寄存器堆\n"
+              << "  --prf_int_size=N --prf_fp_size=N\n"
+              << "  --move_elim=on|off           在重命名阶段消除 move、清零习语与 nop\n"
+              << "  --fusion=none|all|LIST       宏操作融合，LIST 为 lui_addi,auipc_jalr,slli_add,load_op 的逗号分隔子集\n"
+              << "  --select=POLICY              就绪 RS 项的选择策略 position|oldest|random，可用 pool:policy 单独指定某个池\n"
+              << "  --cdbs=N                     结果总线数，0 表示不限\n"
+              << "  --cdb_priority=MODE          总线仲裁：oldest 最老指令优先，fu_class 长延迟 FU 类优先\n"
+              << "  --dcache=on|off              启用 L1 数据 cache\n"
+              << "  --dcache_sets=N --dcache_ways=N --dcache_line=BYTES --mem_latency=N\n"
+              << "  --mshrs=N --mshr_targets=N   非阻塞 L1D：最多 N 个未完成的行缺失，每个 MSHR 合并若干 load（隐含 --dcache=on）\n"
+              << "  --dram=on|off                L1D 缺失（关闭 dcache 时为每次访存）经 DRAM 时序模型，替代 --mem_latency\n"
+              << "  --dram_channels=N --dram_ranks=N --dram_banks=N --dram_row_size=BYTES\n"
+              << "  --dram_page=open|closed --dram_sched=frfcfs|fcfs --dram_queue_size=N\n"
+              << "  --dram_tcas=N --dram_trcd=N --dram_trp=N --dram_tburst=N\n"
+              << "  --prefetcher=none|next_line|stride|stream\n"
+              << "  --pf_degree=N --pf_distance=N --pf_table_size=N --pf_streams=N\n"
+              << "  --mem_dep=MODE               load 与更早的未决 store：store_set 预测、conservative 总是等待、aggressive 总是推测\n"
+              << "  --ssit_size=N --lfst_size=N\n"
+              << "  --store_buffer=N             提交后 store buffer 行数，0 表示提交时直接写内存\n"
+              << "  --sb_drain=N                 每周期写回内存的 store buffer 行数\n"
+              << "  --sample=on|off              抽样模拟，输出 CPI 置信区间\n"
+              << "  --sample_period=N --sample_warmup=N --sample_window=N\n"
+              << "  --energy=default|off|FILE    报告能耗、平均功率与 EDP（FILE 为 key = value 系数文件，单位 pJ）\n"
+              << "  --critpath=on|off            报告动态关键路径及贡献最多的静态指令\n"
+              << "  --critpath_window=N --critpath_top=N\n"
+              << "  --serve=SOCKET --workers=N   在 Unix 域套接字上常驻，接收 JSON 作业（N=0 表示按 CPU 数）\n"
+              << "  --trace=FILE                 trace 驱动模拟：按提交指令 trace 取指，只输出时序统计\n"
+              << "  --trace_out=FILE             把提交的指令流（PC、指令字、目的寄存器值、访存地址与数据）写成 trace\n";
+}
+
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <program.bin>\n";
+    std::string program;
+    bool cycle_print = true;
+    bool step = false;
+    std::string serve_path;
+    std::string trace_path;
+    std::string trace_out;
+    int workers = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--quiet") {
+            cycle_print = false;
+        } else if (arg == "--step") {
+            step = true;
+        } else if (arg.rfind("--serve=", 0) == 0) {
+            serve_path = arg.substr(8);
+        } else if (arg.rfind("--trace=", 0) == 0) {
+            trace_path = arg.substr(8);
+        } else if (arg.rfind("--trace_out=", 0) == 0) {
+            trace_out = arg.substr(12);
+        } else if (arg.rfind("--workers=", 0) == 0) {
+            workers = std::atoi(arg.c_str() + 10);
+        } else if (arg.rfind("--", 0) == 0) {
+            size_t eq = arg.find('=');
+            if (eq == std::string::npos ||
+                !set_config_option(sim_config, arg.substr(2, eq - 2), arg.substr(eq + 1))) {
+                std::cerr << "Invalid option: " << arg << "\n";
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (program.empty()) {
+            program = arg;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!serve_path.empty()) {
+        return run_server(serve_path, workers);
+    }
+    if (program.empty() == trace_path.empty()) {
+        print_usage(argv[0]);
         return 1;
     }
-
-    std::vector<double> input_data = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0};
-    uint64_t base_addr = 0x1000;
-    uint64_t start_addr = base_addr + (input_data.size() - 1) * sizeof(double); // 0x1040
-    uint64_t end_addr = base_addr; // 0x1000
-
-    // 构建内存初始化数据
-    MemoryInitData mem_init;
-    for (size_t i = 0; i < input_data.size(); ++i) {
-        uint64_t addr = base_addr + i * sizeof(double);
-        mem_init.fp_data.push_back({addr, input_data[i]});
+    // 采样的功能快进要按语义执行指令，trace 中没有这些信息
+    if (!trace_path.empty() && sim_config.sample) {
+        std::cerr << "--trace cannot be combined with --sample\n";
+        return 1;
+    }
+    // 快进阶段的指令不经过提交，写出的 trace 会不完整
+    if (!trace_out.empty() && sim_config.sample) {
+        std::cerr << "--trace_out cannot be combined with --sample\n";
+        return 1;
     }
 
-    // 寄存器初始化
-    RegisterInitData reg_init;
-    reg_init.int_regs = {
-        {5, start_addr},   // R1 = x1 = 0x1040 (起始地址)
-        {6, end_addr}      // R2 = x2 = 0x1000 (终止地址)
-    };
-    reg_init.fp_regs = {
-        {2, 2.0}           // F2 = 2.0 (乘数)
-    };
+    // 单步器需要历史记录，未指定时保留最近 1000 个周期
+    if (step && sim_config.history == 0) sim_config.history = 1000;
 
     try {
-        auto instructions = load_instructions_from_bin(argv[1]);
-        simulate(instructions, mem_init, reg_init, true);
+        if (!trace_out.empty()) trace_writer_open(trace_out);
+        if (!trace_path.empty()) {
+            simulate_trace(trace_path, cycle_print);
+        } else {
+            auto instructions = load_instructions_from_bin(program);
+            MemoryInitData mem_init;
+            RegisterInitData reg_init;
+            make_default_init(instructions.size(), mem_init, reg_init);
+            simulate(instructions, mem_init, reg_init, cycle_print);
+        }
+        trace_writer_close();
     } catch (const std::exception& e) {
+        trace_writer_close();
         std::cerr << "Error: " << e.what() << "\n";
+        if (step) history_step(std::cin, std::cout);
         return 1;
     }
+    if (step) history_step(std::cin, std::cout);
     return 0;
 }
\ No newline at end of file
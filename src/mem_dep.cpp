@@ -0,0 +1,51 @@
+// src/mem_dep.cpp
+#include "mem_dep.h"
+#include "sim_stats.h"
+#include <algorithm>
+#include <vector>
+
+static std::vector<int> ssit;         // PC -> SSID，-1 表示不属于任何 set
+static std::vector<int> lfst;         // SSID -> ROB 下标，-1 表示无在途 store
+static int next_ssid = 0;
+
+static int& ssit_entry(uint64_t pc) {
+    return ssit[(pc / 4) % ssit.size()];
+}
+
+void mdp_reset(const SimConfig& cfg) {
+    ssit.assign(cfg.ssit_size, -1);
+    lfst.assign(cfg.lfst_size, -1);
+    next_ssid = 0;
+}
+
+int mdp_lookup_load(uint64_t load_pc) {
+    int ssid = ssit_entry(load_pc);
+    return ssid < 0 ? -1 : lfst[ssid];
+}
+
+void mdp_record_store(uint64_t store_pc, int rob_idx) {
+    int ssid = ssit_entry(store_pc);
+    if (ssid >= 0) lfst[ssid] = rob_idx;
+}
+
+void mdp_train(uint64_t load_pc, uint64_t store_pc) {
+    int& load_set = ssit_entry(load_pc);
+    int& store_set = ssit_entry(store_pc);
+    if (load_set < 0 && store_set < 0) {
+        // 两者都无 set：分配新的 SSID（循环复用）
+        int ssid = next_ssid;
+        next_ssid = (next_ssid + 1) % static_cast<int>(lfst.size());
+        lfst[ssid] = -1;
+        load_set = store_set = ssid;
+        mem_dep_stats.sets_allocated++;
+    } else if (load_set < 0) {
+        load_set = store_set;
+    } else if (store_set < 0) {
+        store_set = load_set;
+    } else if (load_set != store_set) {
+        // 两个 set 合并为编号较小者
+        int ssid = std::min(load_set, store_set);
+        load_set = store_set = ssid;
+        mem_dep_stats.sets_merged++;
+    }
+}
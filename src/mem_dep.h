@@ -0,0 +1,19 @@
+// src/mem_dep.h
+#ifndef MEM_DEP_H
+#define MEM_DEP_H
+#include <cstdint>
+#include "sim_config.h"
+
+// Store-set 访存相关预测器
+//   SSIT：按指令 PC 索引，给出其所属 store set 编号（SSID）
+//   LFST：按 SSID 索引，记录该 set 中最近发射的 store 所在 ROB 条目
+// load 发射时查到的 store 若地址尚未解析，则 load 等待它；否则 load 越过未知地址的 store 推测执行
+void mdp_reset(const SimConfig& cfg);
+// 返回 load 预测依赖的 store 的 ROB 下标，-1 表示无（调用方需确认该条目仍是更老的 store）
+int mdp_lookup_load(uint64_t load_pc);
+// store 发射时更新 LFST
+void mdp_record_store(uint64_t store_pc, int rob_idx);
+// 检测到违例后把 load 与 store 放进同一个 store set
+void mdp_train(uint64_t load_pc, uint64_t store_pc);
+
+#endif
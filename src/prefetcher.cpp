@@ -0,0 +1,149 @@
+// src/prefetcher.cpp
+#include "prefetcher.h"
+#include <stdexcept>
+
+// --- Next-line：缺失或命中预取行时，预取其后第 distance 行起的 degree 行 ---
+class NextLinePrefetcher : public Prefetcher {
+public:
+    explicit NextLinePrefetcher(const SimConfig& cfg)
+        : line_(cfg.dcache_line), degree_(cfg.pf_degree), distance_(cfg.pf_distance) {}
+
+    void on_access(uint64_t, uint64_t addr, bool miss, bool pf_hit,
+                   std::vector<uint64_t>& out) override {
+        if (!miss && !pf_hit) return;
+        uint64_t line = addr / line_;
+        for (int d = 0; d < degree_; ++d)
+            out.push_back(line + distance_ + d);
+    }
+
+private:
+    uint64_t line_;
+    int degree_, distance_;
+};
+
+// --- PC-stride（参考预测表）：按 load 的 PC 记录最远访问地址与步长，
+//     置信度达到 2 后预取 addr + stride * (distance .. distance + degree - 1)。
+//     load 在 FU 上乱序执行，同一 PC 的地址可能乱序到达，
+//     因此步长整数倍的跳跃也算命中，落后的地址不更新表项 ---
+class StridePrefetcher : public Prefetcher {
+public:
+    explicit StridePrefetcher(const SimConfig& cfg)
+        : line_(cfg.dcache_line), degree_(cfg.pf_degree), distance_(cfg.pf_distance),
+          table_(cfg.pf_table_size) {}
+
+    void on_access(uint64_t pc, uint64_t addr, bool, bool,
+                   std::vector<uint64_t>& out) override {
+        Entry& e = table_[(pc / 4) % table_.size()];
+        if (!e.valid || e.pc != pc) {
+            e = Entry{true, pc, addr, 0, 0};
+            return;
+        }
+        int64_t delta = static_cast<int64_t>(addr - e.last_addr);
+        if (delta == 0) return;
+        if (e.stride != 0 && delta % e.stride == 0) {
+            if (delta / e.stride < 0) return;   // 较老的 load 迟到
+            if (e.confidence < 3) e.confidence++;
+        } else {
+            if (e.confidence > 0) e.confidence--;
+            if (e.confidence == 0) e.stride = delta;
+        }
+        e.last_addr = addr;
+
+        if (e.confidence < 2) return;
+        uint64_t last_line = addr / line_;
+        for (int d = 0; d < degree_; ++d) {
+            uint64_t line = (addr + e.stride * (distance_ + d)) / line_;
+            // 步长小于一行时多个目标落在同一行，只发一次
+            if (line != last_line) out.push_back(line);
+            last_line = line;
+        }
+    }
+
+private:
+    struct Entry {
+        bool valid = false;
+        uint64_t pc = 0;
+        uint64_t last_addr = 0;
+        int64_t stride = 0;
+        int confidence = 0;
+    };
+    uint64_t line_;
+    int degree_, distance_;
+    std::vector<Entry> table_;
+};
+
+// --- Stream buffer：两次相邻行的缺失确定一个方向的流，分配一个 stream（LRU 替换），
+//     之后 demand 访问落在流的窗口内就推进流头，保持领先 distance 行、每次补 degree 行。
+//     预取的行直接填入 L1D，不单独建模 buffer 存储 ---
+class StreamPrefetcher : public Prefetcher {
+public:
+    explicit StreamPrefetcher(const SimConfig& cfg)
+        : line_(cfg.dcache_line), degree_(cfg.pf_degree), distance_(cfg.pf_distance),
+          streams_(cfg.pf_streams) {}
+
+    void on_access(uint64_t, uint64_t addr, bool miss, bool,
+                   std::vector<uint64_t>& out) override {
+        uint64_t line = addr / line_;
+        ++tick_;
+
+        for (auto& s : streams_) {
+            if (!s.valid) continue;
+            int64_t ahead = (static_cast<int64_t>(line) - static_cast<int64_t>(s.head)) * s.dir;
+            if (ahead < 0 || ahead > distance_ + degree_) continue;
+            s.head = line;
+            s.lru = tick_;
+            advance(s, out);
+            return;
+        }
+
+        if (!miss) return;
+        // 训练：与上次缺失相邻则按其方向分配新流
+        if (have_last_miss_ && (line == last_miss_ + 1 || line + 1 == last_miss_)) {
+            Stream* victim = &streams_[0];
+            for (auto& s : streams_) {
+                if (!s.valid) { victim = &s; break; }
+                if (s.lru < victim->lru) victim = &s;
+            }
+            *victim = Stream{true, line, line, line > last_miss_ ? 1 : -1, tick_};
+            advance(*victim, out);
+        }
+        last_miss_ = line;
+        have_last_miss_ = true;
+    }
+
+private:
+    struct Stream {
+        bool valid = false;
+        uint64_t head = 0;     // 最近一次 demand 访问的行
+        uint64_t next = 0;     // 下一条待预取的行
+        int dir = 1;
+        uint64_t lru = 0;
+    };
+
+    void advance(Stream& s, std::vector<uint64_t>& out) {
+        uint64_t want = s.head + s.dir * distance_;
+        // 流头已越过预取位置时跳到 head + distance
+        if ((static_cast<int64_t>(want) - static_cast<int64_t>(s.next)) * s.dir > 0)
+            s.next = want;
+        uint64_t limit = s.head + s.dir * (distance_ + degree_);
+        while ((static_cast<int64_t>(limit) - static_cast<int64_t>(s.next)) * s.dir > 0) {
+            out.push_back(s.next);
+            s.next += s.dir;
+        }
+    }
+
+    uint64_t line_;
+    int degree_, distance_;
+    std::vector<Stream> streams_;
+    uint64_t tick_ = 0;
+    uint64_t last_miss_ = 0;
+    bool have_last_miss_ = false;
+};
+
+std::unique_ptr<Prefetcher> make_prefetcher(const SimConfig& cfg) {
+    if (cfg.prefetcher == "none") return nullptr;
+    if (cfg.prefetcher == "next_line") return std::make_unique<NextLinePrefetcher>(cfg);
+    if (cfg.prefetcher == "stride") return std::make_unique<StridePrefetcher>(cfg);
+    if (cfg.prefetcher == "stream") return std::make_unique<StreamPrefetcher>(cfg);
+    throw std::runtime_error("Unknown prefetcher: " + cfg.prefetcher);
+}
@@ -0,0 +1,23 @@
+// src/prefetcher.h
+#ifndef PREFETCHER_H
+#define PREFETCHER_H
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "sim_config.h"
+
+// L1D 数据预取器接口
+// 每次 demand load 访问 cache 后调用 on_access，预取器把要预取的行号（addr / line）追加到 out，
+// 是否真正发出（去重、填入 cache、计数）由 cache 决定
+class Prefetcher {
+public:
+    virtual ~Prefetcher() = default;
+    // miss：本次访问缺失；pf_hit：本次访问首次命中一条预取填入的行
+    virtual void on_access(uint64_t pc, uint64_t addr, bool miss, bool pf_hit,
+                           std::vector<uint64_t>& out) = 0;
+};
+
+// 按 cfg.prefetcher 创建预取器，"none" 返回空指针
+std::unique_ptr<Prefetcher> make_prefetcher(const SimConfig& cfg);
+
+#endif
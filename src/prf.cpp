@@ -0,0 +1,118 @@
+// src/prf.cpp
+#include "prf.h"
+#include <deque>
+
+std::vector<OperandValue> prf;
+std::vector<bool> prf_ready;
+static std::vector<int> prf_refs;    // 引用该物理寄存器的映射数（推测表或在途的旧映射）
+int rename_int[32];
+int rename_fp[32];
+int retire_int[32];
+int retire_fp[32];
+
+static std::deque<int> free_int;
+static std::deque<int> free_fp;
+static int int_size = 0;
+static int fp_size = 0;
+
+void prf_reset(const SimConfig& cfg) {
+    int_size = cfg.prf_int_size;
+    fp_size = cfg.prf_fp_size;
+    prf.assign(int_size + fp_size, OperandValue{});
+    prf_ready.assign(int_size + fp_size, true);
+    prf_refs.assign(int_size + fp_size, 0);
+    free_int.clear();
+    free_fp.clear();
+    for (int i = 0; i < 32; ++i) {
+        rename_int[i] = retire_int[i] = i;
+        rename_fp[i] = retire_fp[i] = int_size + i;
+        prf[i] = OperandValue(regs_int[i]);
+        prf[int_size + i] = OperandValue(regs_fp[i]);
+        prf_refs[i] = prf_refs[int_size + i] = 1;
+    }
+    for (int p = 32; p < int_size; ++p) free_int.push_back(p);
+    for (int p = int_size + 32; p < int_size + fp_size; ++p) free_fp.push_back(p);
+}
+
+bool prf_can_allocate(const DestReg& dest) {
+    if (std::holds_alternative<IntReg>(dest)) return !free_int.empty();
+    if (std::holds_alternative<FpReg>(dest)) return !free_fp.empty();
+    return true;
+}
+
+int prf_allocate(const DestReg& dest, int& old_phys) {
+    old_phys = -1;
+    int p = -1;
+    if (auto* r = std::get_if<IntReg>(&dest)) {
+        p = free_int.front();
+        free_int.pop_front();
+        old_phys = rename_int[r->idx];
+        rename_int[r->idx] = p;
+        prf_stats.int_allocs++;
+    } else if (auto* r = std::get_if<FpReg>(&dest)) {
+        p = free_fp.front();
+        free_fp.pop_front();
+        old_phys = rename_fp[r->idx];
+        rename_fp[r->idx] = p;
+        prf_stats.fp_allocs++;
+    }
+    if (p >= 0) {
+        prf_ready[p] = false;
+        prf_refs[p] = 1;
+    }
+    return p;
+}
+
+void prf_alias(const DestReg& dest, int phys, int& old_phys) {
+    old_phys = -1;
+    if (auto* r = std::get_if<IntReg>(&dest)) {
+        old_phys = rename_int[r->idx];
+        rename_int[r->idx] = phys;
+    } else if (auto* r = std::get_if<FpReg>(&dest)) {
+        old_phys = rename_fp[r->idx];
+        rename_fp[r->idx] = phys;
+    }
+    prf_refs[phys]++;
+}
+
+// 释放一个映射；最后一个映射释放后物理寄存器回到空闲表
+static void prf_free(int p) {
+    if (--prf_refs[p] > 0) return;
+    if (p < int_size) free_int.push_back(p);
+    else free_fp.push_back(p);
+}
+
+void prf_commit(const DestReg& dest, int phys, int old_phys) {
+    if (auto* r = std::get_if<IntReg>(&dest)) retire_int[r->idx] = phys;
+    else if (auto* r = std::get_if<FpReg>(&dest)) retire_fp[r->idx] = phys;
+    if (old_phys >= 0) prf_free(old_phys);
+}
+
+void prf_recover(const bool* squashed) {
+    for (int i = 0; i < 32; ++i) {
+        rename_int[i] = retire_int[i];
+        rename_fp[i] = retire_fp[i];
+    }
+    // ROB 中先是存活的较老指令，再是被冲刷的较年轻指令
+    for (int k = 0; k < ROB_SIZE; ++k) {
+        int i = (rob_head + k) % ROB_SIZE;
+        const ROBEntry& e = rob[i];
+        if (e.phys_dest < 0) continue;
+        if (squashed[i]) {
+            prf_free(e.phys_dest);
+            continue;
+        }
+        if (!e.busy) continue;
+        if (auto* r = std::get_if<IntReg>(&e.dest)) rename_int[r->idx] = e.phys_dest;
+        else if (auto* r = std::get_if<FpReg>(&e.dest)) rename_fp[r->idx] = e.phys_dest;
+    }
+}
+
+void prf_sample_occupancy() {
+    uint64_t int_used = int_size - free_int.size();
+    uint64_t fp_used = fp_size - free_fp.size();
+    prf_stats.int_in_use_sum += int_used;
+    prf_stats.fp_in_use_sum += fp_used;
+    if (int_used > prf_stats.int_in_use_max) prf_stats.int_in_use_max = int_used;
+    if (fp_used > prf_stats.fp_in_use_max) prf_stats.fp_in_use_max = fp_used;
+}
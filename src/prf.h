@@ -0,0 +1,38 @@
+// src/prf.h
+#ifndef PRF_H
+#define PRF_H
+#include <vector>
+#include "tomasulo_sim.h"
+
+// R10K 式合并物理寄存器堆（--rename=prf）
+// 整数与浮点物理寄存器统一编号：[0, int_size) 为整数，[int_size, int_size + fp_size) 为浮点。
+// 推测重命名表在发射时更新，退休重命名表在提交时更新；被覆盖的旧物理寄存器在提交时回收。
+// 保留站只记录物理寄存器号（标签 prf_tag(n)，显示为 "P<n>"），操作数在发往 FU 时从 PRF 读出。
+// 向量寄存器与 vl 仍按 ROB 标签重命名。
+
+extern std::vector<OperandValue> prf;
+extern std::vector<bool> prf_ready;
+extern int rename_int[32];
+extern int rename_fp[32];
+extern int retire_int[32];
+extern int retire_fp[32];
+
+inline bool prf_mode() { return sim_config.rename == "prf"; }
+inline int prf_tag(int p) { return ROB_SIZE + p; }
+
+// 以当前体系结构寄存器值初始化 PRF：x_i -> P_i，f_i -> P_(int_size + i)
+void prf_reset(const SimConfig& cfg);
+// 目的寄存器需要物理寄存器且空闲表已空时返回 false
+bool prf_can_allocate(const DestReg& dest);
+// 为目的寄存器分配新物理寄存器并更新推测重命名表；old_phys 返回原映射，无目的寄存器返回 -1
+int prf_allocate(const DestReg& dest, int& old_phys);
+// 被消除的 move / 零习语：目的寄存器直接映射到已有的物理寄存器 phys（引用计数加一）
+void prf_alias(const DestReg& dest, int phys, int& old_phys);
+// 提交：更新退休重命名表并回收旧物理寄存器
+void prf_commit(const DestReg& dest, int phys, int old_phys);
+// 冲刷后：推测表回到退休表，再按存活的 ROB 条目顺序重放映射，回收被冲刷指令的物理寄存器
+void prf_recover(const bool* squashed);
+// 每周期采样物理寄存器占用
+void prf_sample_occupancy();
+
+#endif
@@ -0,0 +1,102 @@
+// src/sampling.cpp
+#include "sampling.h"
+#include "tomasulo_sim.h"
+#include "frontend.h"
+#include "prf.h"
+#include "store_buffer.h"
+#include <cmath>
+#include <vector>
+
+static std::vector<double> unit_cpi;   // 每个采样单元测得的 CPI
+
+static bool program_done() {
+    return frontend_drained() && rob_count == 0 && sb_empty();
+}
+
+// 详细模拟直到再提交 n 条指令或程序结束
+static void run_detailed(uint64_t n, bool print) {
+    uint64_t target = core_stats.committed + n;
+    while (core_stats.committed < target && !program_done()) {
+        simulate_cycle(true, print);
+    }
+}
+
+void run_sampled(bool print) {
+    unit_cpi.clear();
+    uint64_t detailed = static_cast<uint64_t>(sim_config.sample_warmup) + sim_config.sample_window;
+    uint64_t period = static_cast<uint64_t>(sim_config.sample_period);
+    uint64_t fast_forward = period > detailed ? period - detailed : 0;
+
+    while (!program_done()) {
+        // 1. 功能快进
+        for (uint64_t i = 0; i < fast_forward; ++i) {
+            if (!functional_step()) break;
+        }
+        if (program_done()) break;
+
+        // 2. 详细预热 + 测量；PRF 模式按当前体系结构寄存器重建映射
+        if (prf_mode()) prf_reset(sim_config);
+        uint64_t start = core_stats.committed;
+        run_detailed(sim_config.sample_warmup, print);
+        sampling_stats.warmup_insts += core_stats.committed - start;
+
+        uint64_t insts0 = core_stats.committed;
+        uint64_t cycles0 = core_stats.cycles;
+        run_detailed(sim_config.sample_window, print);
+        uint64_t insts = core_stats.committed - insts0;
+        uint64_t cycles = core_stats.cycles - cycles0;
+        // 程序在窗口中途结束时该单元不完整，不计入估计
+        if (insts >= static_cast<uint64_t>(sim_config.sample_window)) {
+            unit_cpi.push_back(static_cast<double>(cycles) / static_cast<double>(insts));
+            sampling_stats.units++;
+            sampling_stats.measured_insts += insts;
+            sampling_stats.measured_cycles += cycles;
+        }
+
+        // 3. 停止取指并排空（含 store buffer，功能模拟直接读写内存）；违例冲刷的指令留待功能模拟从 next_fetch_idx 重新执行
+        uint64_t drain0 = core_stats.cycles;
+        while (rob_count > 0 || !fetch_queue.empty() || !sb_empty()) {
+            simulate_cycle(false, print);
+        }
+        sampling_stats.drain_cycles += core_stats.cycles - drain0;
+    }
+}
+
+void print_sampling_stats(std::ostream& os) {
+    const SamplingStats& s = sampling_stats;
+    os << "--- sampling (period " << sim_config.sample_period << ", warm-up "
+       << sim_config.sample_warmup << ", window " << sim_config.sample_window << ") ---\n";
+    os << "units             : " << s.units << "\n";
+    os << "fast-forwarded    : " << s.fast_forwarded << "\n";
+    os << "detailed insts    : " << core_stats.committed << " (warm-up " << s.warmup_insts
+       << ", measured " << s.measured_insts << ")\n";
+    os << "drain cycles      : " << s.drain_cycles << "\n";
+    if (unit_cpi.empty()) {
+        os << "CPI estimate      : n/a (no complete sampling unit)\n";
+        return;
+    }
+
+    double n = static_cast<double>(unit_cpi.size());
+    double mean = 0.0;
+    for (double c : unit_cpi) mean += c;
+    mean /= n;
+    os << "CPI estimate      : " << mean << "\n";
+    uint64_t total_insts = s.fast_forwarded + core_stats.committed;
+    os << "est. total cycles : " << static_cast<uint64_t>(std::llround(mean * static_cast<double>(total_insts)))
+       << " (" << total_insts << " insts)\n";
+    if (unit_cpi.size() < 2) {
+        os << "CPI 95% CI        : n/a (need at least 2 units)\n";
+        return;
+    }
+    // 样本标准差与均值的标准误差；置信区间按正态近似 z = 1.96（95%）与 3（99.7%，SMARTS 的取法）
+    double var = 0.0;
+    for (double c : unit_cpi) var += (c - mean) * (c - mean);
+    var /= (n - 1.0);
+    double sd = std::sqrt(var);
+    double se = sd / std::sqrt(n);
+    os << "CPI std dev       : " << sd << " (CV " << (mean > 0 ? sd / mean : 0.0) << ")\n";
+    os << "CPI 95% CI        : " << mean << " +/- " << 1.96 * se
+       << " (+/- " << (mean > 0 ? 100.0 * 1.96 * se / mean : 0.0) << "%)\n";
+    os << "CPI 99.7% CI      : " << mean << " +/- " << 3.0 * se
+       << " (+/- " << (mean > 0 ? 100.0 * 3.0 * se / mean : 0.0) << "%)\n";
+}
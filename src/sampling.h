@@ -0,0 +1,13 @@
+// src/sampling.h
+#ifndef SAMPLING_H
+#define SAMPLING_H
+#include <iostream>
+
+// SMARTS 式系统采样：每个采样单元先功能快进（执行指令并预热 L1I / L1D / 预取器），
+// 再详细模拟 sample_warmup 条指令填满流水线，随后测量 sample_window 条指令的 CPI，
+// 最后停止取指排空流水线回到功能模拟。各单元 CPI 的均值作为整体 CPI 的估计
+void run_sampled(bool print);
+// 采样单元数、CPI 估计及其置信区间
+void print_sampling_stats(std::ostream& os);
+
+#endif
@@ -0,0 +1,480 @@
+// src/server.cpp
+#include "server.h"
+#include "sim_api.h"
+#include "sim_config.h"
+#include "sim_stats.h"
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <csignal>
+#include <cerrno>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+std::vector<Instruction> load_instructions_from_bin(const std::string& filename);
+
+// --- 最小 JSON 读取：对象 / 字符串 / 数字 / 布尔 / null，作业格式不需要数组 ---
+struct JsonValue {
+    enum class Type { NUL, BOOL, NUMBER, STRING, OBJECT };
+    Type type = Type::NUL;
+    bool boolean = false;
+    std::string text;   // 字符串内容，或数字原文（保留 64 位整数精度）
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    const JsonValue* find(const std::string& key) const {
+        for (const auto& [k, v] : members) {
+            if (k == key) return &v;
+        }
+        return nullptr;
+    }
+};
+
+class JsonReader {
+public:
+    explicit JsonReader(const std::string& s) : s_(s) {}
+
+    JsonValue parse() {
+        JsonValue v = value();
+        skip_ws();
+        if (i_ != s_.size()) fail("trailing characters");
+        return v;
+    }
+
+private:
+    const std::string& s_;
+    size_t i_ = 0;
+
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("bad JSON at offset " + std::to_string(i_) + ": " + what);
+    }
+    void skip_ws() {
+        while (i_ < s_.size() && std::isspace(static_cast<unsigned char>(s_[i_]))) ++i_;
+    }
+    bool consume(char c) {
+        skip_ws();
+        if (i_ < s_.size() && s_[i_] == c) {
+            ++i_;
+            return true;
+        }
+        return false;
+    }
+    void expect(char c) {
+        if (!consume(c)) fail(std::string("expected '") + c + "'");
+    }
+    bool literal(const char* word) {
+        size_t n = std::strlen(word);
+        if (s_.compare(i_, n, word) != 0) return false;
+        i_ += n;
+        return true;
+    }
+
+    JsonValue value() {
+        skip_ws();
+        if (i_ >= s_.size()) fail("unexpected end of input");
+        JsonValue v;
+        char c = s_[i_];
+        if (c == '{') {
+            ++i_;
+            v.type = JsonValue::Type::OBJECT;
+            if (consume('}')) return v;
+            do {
+                skip_ws();
+                std::string key = string();
+                expect(':');
+                v.members.emplace_back(key, value());
+            } while (consume(','));
+            expect('}');
+        } else if (c == '"') {
+            v.type = JsonValue::Type::STRING;
+            v.text = string();
+        } else if (c == '-' || std::isdigit(static_cast<unsigned char>(c))) {
+            size_t start = i_;
+            while (i_ < s_.size() && (std::isdigit(static_cast<unsigned char>(s_[i_])) ||
+                                      std::strchr("+-.eE", s_[i_]))) {
+                ++i_;
+            }
+            v.type = JsonValue::Type::NUMBER;
+            v.text = s_.substr(start, i_ - start);
+        } else if (literal("true")) {
+            v.type = JsonValue::Type::BOOL;
+            v.boolean = true;
+        } else if (literal("false")) {
+            v.type = JsonValue::Type::BOOL;
+        } else if (!literal("null")) {
+            fail("unexpected character");
+        }
+        return v;
+    }
+
+    std::string string() {
+        if (i_ >= s_.size() || s_[i_] != '"') fail("expected string");
+        ++i_;
+        std::string out;
+        while (i_ < s_.size() && s_[i_] != '"') {
+            char c = s_[i_++];
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (i_ >= s_.size()) break;
+            char e = s_[i_++];
+            switch (e) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u': {
+                    if (i_ + 4 > s_.size()) fail("bad \\u escape");
+                    unsigned cp = static_cast<unsigned>(std::stoul(s_.substr(i_, 4), nullptr, 16));
+                    i_ += 4;
+                    // 编码为 UTF-8（不处理代理对）
+                    if (cp < 0x80) {
+                        out += static_cast<char>(cp);
+                    } else if (cp < 0x800) {
+                        out += static_cast<char>(0xC0 | (cp >> 6));
+                        out += static_cast<char>(0x80 | (cp & 0x3F));
+                    } else {
+                        out += static_cast<char>(0xE0 | (cp >> 12));
+                        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                        out += static_cast<char>(0x80 | (cp & 0x3F));
+                    }
+                    break;
+                }
+                default: out += e; break;   // \" \\ \/
+            }
+        }
+        if (i_ >= s_.size()) fail("unterminated string");
+        ++i_;
+        return out;
+    }
+};
+
+// --- JSON 输出 ---
+static void write_json_string(std::ostream& os, const std::string& s) {
+    os << '"';
+    for (char c : s) {
+        switch (c) {
+            case '"': os << "\\\""; break;
+            case '\\': os << "\\\\"; break;
+            case '\n': os << "\\n"; break;
+            case '\t': os << "\\t"; break;
+            case '\r': os << "\\r"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                       << static_cast<int>(c) << std::dec << std::setfill(' ');
+                } else {
+                    os << c;
+                }
+        }
+    }
+    os << '"';
+}
+
+static void write_json_double(std::ostream& os, double v) {
+    if (std::isfinite(v)) os << std::setprecision(17) << v;
+    else os << "null";
+}
+
+// --- 作业字段转换 ---
+static std::string option_text(const std::string& key, const JsonValue& v) {
+    switch (v.type) {
+        case JsonValue::Type::BOOL: return v.boolean ? "on" : "off";
+        case JsonValue::Type::NUMBER:
+        case JsonValue::Type::STRING: return v.text;
+        default: throw std::runtime_error("option " + key + " must be a string, number or boolean");
+    }
+}
+
+// 十进制或 0x 前缀的整数；负数按补码存放
+static uint64_t parse_u64(const std::string& text) {
+    size_t pos = 0;
+    uint64_t v = (!text.empty() && text[0] == '-')
+                     ? static_cast<uint64_t>(std::stoll(text, &pos, 0))
+                     : std::stoull(text, &pos, 0);
+    if (pos != text.size()) throw std::runtime_error("not an integer: " + text);
+    return v;
+}
+
+static double parse_double(const JsonValue& v) {
+    if (v.type != JsonValue::Type::NUMBER) throw std::runtime_error("expected a number");
+    return std::stod(v.text);
+}
+
+static uint64_t parse_u64(const JsonValue& v) {
+    if (v.type != JsonValue::Type::NUMBER && v.type != JsonValue::Type::STRING) {
+        throw std::runtime_error("expected an integer");
+    }
+    return parse_u64(v.text);
+}
+
+static int parse_reg_index(const std::string& key) {
+    uint64_t idx = parse_u64(key);
+    if (idx >= 32) throw std::runtime_error("register index out of range: " + key);
+    return static_cast<int>(idx);
+}
+
+// 取出对象类型的可选字段
+static const JsonValue* object_field(const JsonValue& job, const std::string& key) {
+    const JsonValue* v = job.find(key);
+    if (v && v->type != JsonValue::Type::OBJECT) {
+        throw std::runtime_error("\"" + key + "\" must be an object");
+    }
+    return v;
+}
+
+// --- 已译码程序缓存（每个 worker 一份） ---
+struct CachedProgram {
+    off_t size = 0;
+    struct timespec mtime {};
+    std::vector<Instruction> instructions;
+};
+static std::unordered_map<std::string, CachedProgram> program_cache;
+
+static const std::vector<Instruction>& get_program(const std::string& path, bool& hit) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) throw std::runtime_error("Cannot open file: " + path);
+    auto it = program_cache.find(path);
+    hit = it != program_cache.end() && it->second.size == st.st_size &&
+          it->second.mtime.tv_sec == st.st_mtim.tv_sec && it->second.mtime.tv_nsec == st.st_mtim.tv_nsec;
+    if (hit) return it->second.instructions;
+
+    CachedProgram& entry = program_cache[path];
+    entry.size = st.st_size;
+    entry.mtime = st.st_mtim;
+    entry.instructions = load_instructions_from_bin(path);
+    return entry.instructions;
+}
+
+// 执行一个作业，返回一行 JSON（不含换行）
+static std::string run_job(const std::string& line, const SimConfig& base_config) {
+    std::ostringstream os;
+    try {
+        JsonValue job = JsonReader(line).parse();
+        if (job.type != JsonValue::Type::OBJECT) throw std::runtime_error("job must be a JSON object");
+        const JsonValue* program = job.find("program");
+        if (!program || program->type != JsonValue::Type::STRING) {
+            throw std::runtime_error("missing \"program\"");
+        }
+
+        sim_config = base_config;
+        if (const JsonValue* cfg = object_field(job, "config")) {
+            for (const auto& [key, v] : cfg->members) {
+                std::string value = option_text(key, v);
+                if (!set_config_option(sim_config, key, value)) {
+                    throw std::runtime_error("invalid option " + key + "=" + value);
+                }
+            }
+        }
+
+        bool cached = false;
+        const std::vector<Instruction>& instructions = get_program(program->text, cached);
+        MemoryInitData mem_init;
+        RegisterInitData reg_init;
+        make_default_init(instructions.size(), mem_init, reg_init);
+        if (const JsonValue* regs = object_field(job, "int_regs")) {
+            for (const auto& [key, v] : regs->members) reg_init.int_regs.push_back({parse_reg_index(key), parse_u64(v)});
+        }
+        if (const JsonValue* regs = object_field(job, "fp_regs")) {
+            for (const auto& [key, v] : regs->members) reg_init.fp_regs.push_back({parse_reg_index(key), parse_double(v)});
+        }
+        if (const JsonValue* mem = object_field(job, "mem_int")) {
+            for (const auto& [key, v] : mem->members) mem_init.int_data.push_back({parse_u64(key), parse_u64(v)});
+        }
+        if (const JsonValue* mem = object_field(job, "mem_fp")) {
+            for (const auto& [key, v] : mem->members) mem_init.fp_data.push_back({parse_u64(key), parse_double(v)});
+        }
+        uint64_t max_cycles = 0;
+        if (const JsonValue* v = job.find("max_cycles")) max_cycles = parse_u64(*v);
+        const JsonValue* dump = job.find("dump_memory");
+        bool dump_memory = dump && dump->type == JsonValue::Type::BOOL && dump->boolean;
+
+        sim_init(instructions, mem_init, reg_init);
+        sim_run(max_cycles);
+
+        os << "{\"ok\":true,\"program\":";
+        write_json_string(os, program->text);
+        os << ",\"cached\":" << (cached ? "true" : "false")
+           << ",\"finished\":" << (sim_finished() ? "true" : "false") << ",\"stats\":{";
+        bool first_block = true;
+        for (const StatBlock& b : stat_blocks()) {
+            os << (first_block ? "" : ",") << '"' << b.name << "\":{";
+            for (size_t i = 0; i < b.size; ++i) {
+                os << (i ? "," : "") << '"' << b.fields[i] << "\":" << b.data[i];
+            }
+            os << '}';
+            first_block = false;
+        }
+        os << '}';
+        if (dump_memory) {
+            os << ",\"memory_int\":{";
+            bool first = true;
+            for (const auto& [addr, val] : memory_int) {
+                os << (first ? "" : ",") << '"' << addr << "\":" << val;
+                first = false;
+            }
+            os << "},\"memory_fp\":{";
+            first = true;
+            for (const auto& [addr, val] : memory_fp) {
+                os << (first ? "" : ",") << '"' << addr << "\":";
+                write_json_double(os, val);
+                first = false;
+            }
+            os << '}';
+        }
+        os << '}';
+    } catch (const std::exception& e) {
+        os.str("");
+        os << "{\"ok\":false,\"error\":";
+        write_json_string(os, e.what());
+        os << '}';
+    }
+    return os.str();
+}
+
+// --- 套接字与进程池 ---
+static bool send_all(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+static bool is_blank(const std::string& s) {
+    for (char c : s) {
+        if (!std::isspace(static_cast<unsigned char>(c))) return false;
+    }
+    return true;
+}
+
+// 一个连接上按行处理作业，直到客户端关闭写端
+static void serve_connection(int fd, const SimConfig& base_config) {
+    std::string buffer;
+    char chunk[4096];
+    while (true) {
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        buffer.append(chunk, static_cast<size_t>(n));
+        size_t nl;
+        while ((nl = buffer.find('\n')) != std::string::npos) {
+            std::string line = buffer.substr(0, nl);
+            buffer.erase(0, nl + 1);
+            if (is_blank(line)) continue;
+            if (!send_all(fd, run_job(line, base_config) + "\n")) return;
+        }
+    }
+    // 最后一行可以不带换行符
+    if (!is_blank(buffer)) send_all(fd, run_job(buffer, base_config) + "\n");
+}
+
+static void worker_loop(int listen_fd, const SimConfig& base_config) {
+#ifdef __linux__
+    prctl(PR_SET_PDEATHSIG, SIGTERM);
+#endif
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    std::signal(SIGPIPE, SIG_IGN);
+    // 模拟过程中的调试输出（如 fsd 提交）不写到守护进程的终端
+    std::cout.setstate(std::ios::badbit);
+    while (true) {
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            std::perror("accept");
+            _exit(1);
+        }
+        serve_connection(fd, base_config);
+        close(fd);
+    }
+}
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void on_stop_signal(int) {
+    stop_requested = 1;
+}
+
+int run_server(const std::string& socket_path, int workers) {
+    if (workers <= 0) workers = static_cast<int>(std::max(1L, sysconf(_SC_NPROCESSORS_ONLN)));
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socket_path.empty() || socket_path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Invalid socket path: " << socket_path << "\n";
+        return 1;
+    }
+    std::strcpy(addr.sun_path, socket_path.c_str());
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        std::perror("socket");
+        return 1;
+    }
+    unlink(socket_path.c_str());
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listen_fd, SOMAXCONN) != 0) {
+        std::perror("bind/listen");
+        close(listen_fd);
+        return 1;
+    }
+
+    // 命令行上的 --key=value 作为所有作业的基础配置
+    const SimConfig base_config = sim_config;
+    auto spawn = [&]() -> pid_t {
+        pid_t pid = fork();
+        if (pid == 0) {
+            worker_loop(listen_fd, base_config);
+            _exit(0);
+        }
+        if (pid < 0) std::perror("fork");
+        return pid;
+    };
+    std::vector<pid_t> pids;
+    for (int w = 0; w < workers; ++w) pids.push_back(spawn());
+
+    struct sigaction sa {};
+    sa.sa_handler = on_stop_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, nullptr);   // 不设 SA_RESTART，wait() 被信号打断后检查退出标志
+    sigaction(SIGTERM, &sa, nullptr);
+    std::cerr << "tomasulo server: listening on " << socket_path << " with " << workers << " workers\n";
+
+    while (!stop_requested) {
+        int status = 0;
+        pid_t pid = wait(&status);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        // worker 异常退出时补一个，保持池大小
+        for (pid_t& p : pids) {
+            if (p == pid && !stop_requested) {
+                std::cerr << "tomasulo server: worker " << pid << " exited, restarting\n";
+                p = spawn();
+            }
+        }
+    }
+
+    for (pid_t p : pids) {
+        if (p > 0) kill(p, SIGTERM);
+    }
+    while (wait(nullptr) > 0) {}
+    close(listen_fd);
+    unlink(socket_path.c_str());
+    return 0;
+}
@@ -0,0 +1,17 @@
+// src/server.h
+#ifndef SERVER_H
+#define SERVER_H
+#include <string>
+
+// 常驻服务模式：在 Unix 域套接字上接收作业，预先 fork 的 worker 进程各自 accept 连接，
+// 未被取走的连接在 listen 队列中排队。每个连接可按行提交多个 JSON 作业，每行返回一行 JSON 结果。
+// 作业格式（除 program 外均可省略）：
+//   {"program": "tests/bin/x.bin", "config": {"dcache": true, "fetch_width": 2},
+//    "int_regs": {"5": 4160}, "fp_regs": {"2": 2.0},
+//    "mem_int": {"0x2000": 7}, "mem_fp": {"4096": 1.5},
+//    "max_cycles": 0, "dump_memory": false}
+// config 在启动服务时的命令行选项基础上逐项覆盖；寄存器 / 内存初值追加在默认初值之后。
+// 每个 worker 按路径缓存已译码的程序（文件大小或修改时间变化时重新译码）
+int run_server(const std::string& socket_path, int workers);
+
+#endif
@@ -0,0 +1,81 @@
+// src/sim_api.cpp
+#include "sim_api.h"
+#include "frontend.h"
+#include "sampling.h"
+#include "store_buffer.h"
+
+std::vector<Instruction> load_instructions_from_bin(const std::string& filename);
+
+void make_default_init(size_t num_instructions, MemoryInitData& mem_init, RegisterInitData& reg_init) {
+    std::vector<double> input_data = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0};
+    uint64_t base_addr = 0x1000;
+    uint64_t start_addr = base_addr + (input_data.size() - 1) * sizeof(double); // 0x1040
+    uint64_t end_addr = base_addr; // 0x1000
+
+    // 构建内存初始化数据
+    mem_init = MemoryInitData{};
+    for (size_t i = 0; i < input_data.size(); ++i) {
+        uint64_t addr = base_addr + i * sizeof(double);
+        mem_init.fp_data.push_back({addr, input_data[i]});
+    }
+
+    // 寄存器初始化
+    reg_init = RegisterInitData{};
+    reg_init.int_regs = {
+        {5, start_addr},   // R1 = x1 = 0x1040 (起始地址)
+        {6, end_addr}      // R2 = x2 = 0x1000 (终止地址)
+    };
+    reg_init.fp_regs = {
+        {2, 2.0}           // F2 = 2.0 (乘数)
+    };
+    // 编译出的 _start 以 ret 结束：ra 指向程序末尾即视为退出，sp 给一块栈空间
+    reg_init.int_regs.push_back({1, num_instructions * 4});
+    reg_init.int_regs.push_back({2, 0x10000});
+}
+
+size_t sim_load(const std::string& path) {
+    auto instructions = load_instructions_from_bin(path);
+    MemoryInitData mem_init;
+    RegisterInitData reg_init;
+    make_default_init(instructions.size(), mem_init, reg_init);
+    sim_init(instructions, mem_init, reg_init);
+    return instructions.size();
+}
+
+bool sim_finished() {
+    return frontend_drained() && rob_count == 0 && sb_empty();
+}
+
+uint64_t sim_run(uint64_t max_cycles, bool print) {
+    uint64_t start = core_stats.cycles;
+    if (sim_config.sample) {
+        if (!sim_finished()) run_sampled(print);
+        return core_stats.cycles - start;
+    }
+    while (!sim_finished() && (max_cycles == 0 || core_stats.cycles - start < max_cycles)) {
+        simulate_cycle(true, print);
+    }
+    return core_stats.cycles - start;
+}
+
+std::vector<RobSnapshotEntry> rob_snapshot() {
+    std::vector<RobSnapshotEntry> out;
+    out.reserve(rob_count);
+    for (int k = 0; k < rob_count; ++k) {
+        int idx = (rob_head + k) % ROB_SIZE;
+        const ROBEntry& e = rob[idx];
+        out.push_back({idx, e.op, e.state, rob_instr[idx].pc, e.is_load, e.is_store});
+    }
+    return out;
+}
+
+std::vector<LsqSnapshotEntry> lsq_snapshot() {
+    std::vector<LsqSnapshotEntry> out;
+    out.reserve(lsq_count);
+    for (int k = 0; k < lsq_count; ++k) {
+        int idx = (lsq_head + k) % LSQ_SIZE;
+        const LSQEntry& e = lsq[idx];
+        out.push_back({idx, e.rob_idx, e.is_store, e.addr_ready, e.executed, e.address});
+    }
+    return out;
+}
@@ -0,0 +1,40 @@
+// src/sim_api.h
+#ifndef SIM_API_H
+#define SIM_API_H
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "tomasulo_sim.h"
+
+// 逐步驱动模拟器的接口：命令行 main 与 Python 绑定（python/tomasulo_py.cpp）共用
+
+// 默认的内存 / 寄存器初值（测试程序的输入数组、ra 与 sp）
+void make_default_init(size_t num_instructions, MemoryInitData& mem_init, RegisterInitData& reg_init);
+// 读取 .bin 程序并按默认初值复位模拟器，返回指令条数
+size_t sim_load(const std::string& path);
+// 最多推进 max_cycles 个周期（0 表示运行到结束），返回实际推进的周期数。
+// 采样模式下总是运行到结束
+uint64_t sim_run(uint64_t max_cycles, bool print = false);
+bool sim_finished();
+
+// ROB / LSQ 占用快照，均从队头（最老）开始
+struct RobSnapshotEntry {
+    int index;
+    OpType op;
+    InstructionState state;
+    uint64_t pc;
+    bool is_load;
+    bool is_store;
+};
+struct LsqSnapshotEntry {
+    int index;
+    int rob_idx;
+    bool is_store;
+    bool addr_ready;
+    bool executed;
+    uint64_t address;
+};
+std::vector<RobSnapshotEntry> rob_snapshot();
+std::vector<LsqSnapshotEntry> lsq_snapshot();
+
+#endif
@@ -0,0 +1,203 @@
+// src/sim_config.cpp
+#include "sim_config.h"
+#include <cctype>
+#include <iostream>
+#include <stdexcept>
+
+SimConfig sim_config;
+
+// 解析并检查下限，全部通过后才写入 out：非法值不改动原配置
+static bool parse_int(const std::string& value, int& out, int min) {
+    try {
+        size_t pos = 0;
+        int v = std::stoi(value, &pos, 0);
+        if (pos != value.size() || v < min) return false;
+        out = v;
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+static bool parse_bool(const std::string& value, bool& out) {
+    if (value == "1" || value == "true" || value == "on") { out = true; return true; }
+    if (value == "0" || value == "false" || value == "off") { out = false; return true; }
+    return false;
+}
+
+// none / all / 逗号分隔的模式列表（lui_addi,auipc_jalr,slli_add,load_op）
+// 整个列表合法后才写入 cfg
+static bool parse_fusion(const std::string& value, SimConfig& cfg) {
+    bool all = (value == "all");
+    bool lui_addi = all, auipc_jalr = all, slli_add = all, load_op = all;
+    size_t start = 0;
+    while (!all && value != "none" && start <= value.size()) {
+        size_t end = value.find(',', start);
+        if (end == std::string::npos) end = value.size();
+        std::string name = value.substr(start, end - start);
+        if (name == "lui_addi") lui_addi = true;
+        else if (name == "auipc_jalr") auipc_jalr = true;
+        else if (name == "slli_add") slli_add = true;
+        else if (name == "load_op") load_op = true;
+        else return false;
+        start = end + 1;
+    }
+    cfg.fuse_lui_addi = lui_addi;
+    cfg.fuse_auipc_jalr = auipc_jalr;
+    cfg.fuse_slli_add = slli_add;
+    cfg.fuse_load_op = load_op;
+    return true;
+}
+
+static bool parse_select_policy(const std::string& name, SelectPolicy& out) {
+    if (name == "position") out = SelectPolicy::POSITION;
+    else if (name == "oldest") out = SelectPolicy::OLDEST;
+    else if (name == "random") out = SelectPolicy::RANDOM;
+    else return false;
+    return true;
+}
+
+static const char* const select_pools[] = {
+    "intalu", "muldiv", "load", "store", "fpadd", "fpmul", "fpdiv", "fpfma", "vec", "vmem"};
+
+// 逗号分隔：不带池名的一项是所有池的默认策略，"池:策略" 覆盖单个池；
+// 找到 pool 对应的策略时写入 out。pool 为空只检查格式
+static bool lookup_select(const std::string& value, const std::string& pool, SelectPolicy& out) {
+    size_t start = 0;
+    while (start <= value.size()) {
+        size_t end = value.find(',', start);
+        if (end == std::string::npos) end = value.size();
+        std::string item = value.substr(start, end - start);
+        size_t colon = item.find(':');
+        std::string name = colon == std::string::npos ? "" : item.substr(0, colon);
+        SelectPolicy policy;
+        if (!parse_select_policy(item.substr(colon == std::string::npos ? 0 : colon + 1), policy)) return false;
+        if (!name.empty()) {
+            bool known = false;
+            for (const char* p : select_pools) known = known || name == p;
+            if (!known) return false;
+        }
+        if (name.empty() || name == pool) out = policy;
+        start = end + 1;
+    }
+    return true;
+}
+
+SelectPolicy select_policy(const SimConfig& cfg, const std::string& pool_type) {
+    std::string pool;
+    for (char c : pool_type) pool += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    SelectPolicy policy = SelectPolicy::POSITION;
+    lookup_select(cfg.select, pool, policy);
+    return policy;
+}
+
+bool set_config_option(SimConfig& cfg, const std::string& key, const std::string& value) {
+    if (key == "dcache") return parse_bool(value, cfg.dcache_enabled);
+    if (key == "dcache_sets") return parse_int(value, cfg.dcache_sets, 1);
+    if (key == "dcache_ways") return parse_int(value, cfg.dcache_ways, 1);
+    if (key == "dcache_line") return parse_int(value, cfg.dcache_line, 8);
+    if (key == "mem_latency") return parse_int(value, cfg.mem_latency, 0);
+    if (key == "mshrs") {
+        if (!parse_int(value, cfg.dcache_mshrs, 0)) return false;
+        // MSHR 属于 L1D
+        if (cfg.dcache_mshrs > 0) cfg.dcache_enabled = true;
+        return true;
+    }
+    if (key == "mshr_targets") return parse_int(value, cfg.mshr_targets, 1);
+
+    if (key == "dram") return parse_bool(value, cfg.dram_enabled);
+    if (key == "dram_channels") return parse_int(value, cfg.dram_channels, 1);
+    if (key == "dram_ranks") return parse_int(value, cfg.dram_ranks, 1);
+    if (key == "dram_banks") return parse_int(value, cfg.dram_banks, 1);
+    if (key == "dram_row_size") return parse_int(value, cfg.dram_row_size, 1);
+    if (key == "dram_page") {
+        if (value != "open" && value != "closed") return false;
+        cfg.dram_page = value;
+        return true;
+    }
+    if (key == "dram_sched") {
+        if (value != "frfcfs" && value != "fcfs") return false;
+        cfg.dram_sched = value;
+        return true;
+    }
+    if (key == "dram_queue_size") return parse_int(value, cfg.dram_queue_size, 1);
+    if (key == "dram_tcas") return parse_int(value, cfg.dram_tcas, 1);
+    if (key == "dram_trcd") return parse_int(value, cfg.dram_trcd, 0);
+    if (key == "dram_trp") return parse_int(value, cfg.dram_trp, 0);
+    if (key == "dram_tburst") return parse_int(value, cfg.dram_tburst, 1);
+
+    if (key == "rename") {
+        if (value != "rob" && value != "prf") return false;
+        cfg.rename = value;
+        return true;
+    }
+    // 至少要比体系结构寄存器多一个，否则无法发射任何写寄存器的指令
+    if (key == "prf_int_size") return parse_int(value, cfg.prf_int_size, 33);
+    if (key == "prf_fp_size") return parse_int(value, cfg.prf_fp_size, 33);
+    if (key == "move_elim") return parse_bool(value, cfg.move_elim);
+    if (key == "fusion") return parse_fusion(value, cfg);
+
+    if (key == "fetch_width") return parse_int(value, cfg.fetch_width, 1);
+    if (key == "fetch_queue_size") return parse_int(value, cfg.fetch_queue_size, 1);
+    if (key == "icache") return parse_bool(value, cfg.icache_enabled);
+    if (key == "icache_sets") return parse_int(value, cfg.icache_sets, 1);
+    if (key == "icache_ways") return parse_int(value, cfg.icache_ways, 1);
+    if (key == "icache_line") return parse_int(value, cfg.icache_line, 4);
+    if (key == "loop_buffer") return parse_int(value, cfg.loop_buffer, 0);
+
+    if (key == "sample") return parse_bool(value, cfg.sample);
+    if (key == "sample_period") return parse_int(value, cfg.sample_period, 1);
+    if (key == "sample_warmup") return parse_int(value, cfg.sample_warmup, 0);
+    if (key == "sample_window") return parse_int(value, cfg.sample_window, 1);
+
+    if (key == "prefetcher") {
+        if (value != "none" && value != "next_line" && value != "stride" && value != "stream") return false;
+        cfg.prefetcher = value;
+        // 预取需要 cache 才有意义
+        if (value != "none") cfg.dcache_enabled = true;
+        return true;
+    }
+    if (key == "pf_degree") return parse_int(value, cfg.pf_degree, 1);
+    if (key == "pf_distance") return parse_int(value, cfg.pf_distance, 1);
+    if (key == "pf_table_size") return parse_int(value, cfg.pf_table_size, 1);
+    if (key == "pf_streams") return parse_int(value, cfg.pf_streams, 1);
+
+    if (key == "mem_dep") {
+        if (value != "store_set" && value != "conservative" && value != "aggressive") return false;
+        cfg.mem_dep = value;
+        return true;
+    }
+    if (key == "select") {
+        SelectPolicy unused;
+        if (!lookup_select(value, "", unused)) return false;
+        cfg.select = value;
+        return true;
+    }
+    if (key == "cdbs") return parse_int(value, cfg.cdbs, 0);
+    if (key == "cdb_priority") {
+        if (value != "oldest" && value != "fu_class") return false;
+        cfg.cdb_priority = value;
+        return true;
+    }
+    if (key == "store_buffer") return parse_int(value, cfg.store_buffer, 0);
+    if (key == "sb_drain") return parse_int(value, cfg.sb_drain_width, 1);
+    if (key == "critpath") return parse_bool(value, cfg.critpath);
+    // 窗口至少要能容纳 ROB 满时回溯到的更老指令
+    if (key == "critpath_window") return parse_int(value, cfg.critpath_window, 256);
+    if (key == "critpath_top") return parse_int(value, cfg.critpath_top, 0);
+    if (key == "history") return parse_int(value, cfg.history, 0);
+    if (key == "energy") {
+        EnergyModel model;
+        std::string error;
+        if (value != "off" && value != "default" && !load_energy_model(value, model, error)) {
+            std::cerr << "Energy model: " << error << "\n";
+            return false;
+        }
+        cfg.energy = model;
+        cfg.energy_enabled = value != "off";
+        return true;
+    }
+    if (key == "ssit_size") return parse_int(value, cfg.ssit_size, 1);
+    if (key == "lfst_size") return parse_int(value, cfg.lfst_size, 1);
+    return false;
+}
@@ -0,0 +1,114 @@
+// src/sim_config.h
+#ifndef SIM_CONFIG_H
+#define SIM_CONFIG_H
+#include <string>
+#include "energy.h"
+
+// 保留站发往 FU 的选择策略：按条目位置（下标小者优先）/ 按年龄（最老者优先）/ 随机
+enum class SelectPolicy { POSITION, OLDEST, RANDOM };
+
+// 运行时可调参数（结构尺寸仍在 tomasulo_sim.h 中以常量给出）
+struct SimConfig {
+    // L1 数据 cache：关闭时访存为固定延迟的平坦内存
+    bool dcache_enabled = false;
+    int dcache_sets = 64;
+    int dcache_ways = 4;
+    int dcache_line = 64;          // 字节
+    int mem_latency = 20;          // 缺失时额外的周期数（未开启 DRAM 模型时）
+    int dcache_mshrs = 0;          // MSHR 个数；0 为阻塞 cache（缺失期间 load 单元一直被占用）
+    int mshr_targets = 4;          // 每个 MSHR 可合并的 load 数（含首次缺失）
+
+    // DRAM 时序模型：开启后 L1D 缺失（未开 cache 时为每次访存）经内存控制器排队，取代固定的 mem_latency
+    bool dram_enabled = false;
+    int dram_channels = 1;
+    int dram_ranks = 1;
+    int dram_banks = 8;            // 每个 rank 的 bank 数
+    int dram_row_size = 2048;      // 行缓冲字节数
+    std::string dram_page = "open";     // open：访问后保持行打开 / closed：突发后自动预充电
+    std::string dram_sched = "frfcfs";  // frfcfs：行命中优先 / fcfs：严格按到达顺序
+    int dram_queue_size = 32;      // 每通道请求队列容量
+    int dram_tcas = 14;            // 列访问到数据返回
+    int dram_trcd = 14;            // 行激活到列访问
+    int dram_trp = 14;             // 预充电
+    int dram_tburst = 4;           // 一次突发占用数据总线的周期
+
+    // 重命名方式：rob（值保存在 ROB，发射时捕获）/ prf（合并物理寄存器堆）
+    std::string rename = "rob";
+    int prf_int_size = 64;         // 整数物理寄存器数（含 32 个体系结构映射）
+    int prf_fp_size = 64;          // 浮点物理寄存器数
+    bool move_elim = true;         // 重命名时消除 move / 零习语 / nop
+
+    // 宏融合：发射时把取指队列头部可融合的相邻指令对合并为一个 ROB / RS 条目
+    bool fuse_lui_addi = false;
+    bool fuse_auipc_jalr = false;
+    bool fuse_slli_add = false;
+    bool fuse_load_op = false;
+    bool fusion_enabled() const {
+        return fuse_lui_addi || fuse_auipc_jalr || fuse_slli_add || fuse_load_op;
+    }
+
+    // 前端：每周期取指条数、取指队列容量、L1 指令 cache
+    int fetch_width = 1;
+    int fetch_queue_size = 8;
+    bool icache_enabled = false;
+    int icache_sets = 64;
+    int icache_ways = 4;
+    int icache_line = 64;
+    // 循环缓冲容量（指令条数），0 为关闭
+    int loop_buffer = 0;
+
+    // SMARTS 式采样：每 sample_period 条指令中，先功能快进（预热 cache 与预取器），
+    // 再详细模拟 sample_warmup 条预热流水线、sample_window 条测量 CPI
+    bool sample = false;
+    int sample_period = 100000;
+    int sample_warmup = 2000;
+    int sample_window = 1000;
+
+    // 数据预取：none / next_line / stride / stream
+    std::string prefetcher = "none";
+    int pf_degree = 2;             // 每次触发预取的行数
+    int pf_distance = 1;           // 领先 demand 访问的行数（stride 为步长数）
+    int pf_table_size = 64;        // stride 预取的 PC 表项数
+    int pf_streams = 4;            // stream buffer 个数
+
+    // load 越过更老 store 的策略：
+    //   store_set    按 store-set 预测等待可能冲突的 store，其余推测执行
+    //   conservative 等所有更老 store 的地址解析后才执行
+    //   aggressive   总是推测执行
+    std::string mem_dep = "store_set";
+    int ssit_size = 1024;          // store set ID 表项数（按 PC 索引）
+    int lfst_size = 128;           // 最近发射 store 表项数（即最多的 store set 数）
+
+    // 保留站发往 FU 的选择策略：position（下标小者优先）/ oldest（年龄矩阵，最老优先）/ random，
+    // 可用 "池:策略" 为单个池指定，如 "oldest,load:position"
+    std::string select = "position";
+
+    // 结果总线（CDB）条数，0 为不限；每周期最多 cdbs 个结果广播，其余留在 FU 中等待
+    int cdbs = 0;
+    std::string cdb_priority = "oldest";   // oldest：最老指令优先 / fu_class：长延迟 FU 优先
+
+    // 提交后 store buffer 的行数，0 为关闭（store 在提交时直接写内存）；每周期排空 sb_drain_width 行
+    int store_buffer = 0;
+    int sb_drain_width = 1;
+
+    // 动态关键路径分析：按 critpath_window 条提交指令一个窗口流式分析，报告前 critpath_top 条静态指令
+    bool critpath = false;
+    int critpath_window = 10000;
+    int critpath_top = 10;
+
+    // 时间回溯调试：保留最近 history 个周期的状态变化（0 为关闭），供 --step 单步器回看
+    int history = 0;
+
+    // 事件能耗模型：--energy=default 使用内置系数，--energy=FILE 从文件读取
+    bool energy_enabled = false;
+    EnergyModel energy;
+};
+
+extern SimConfig sim_config;
+
+// 按 "key=value" 设置一项，未知 key 或非法值返回 false，此时 cfg 不变
+bool set_config_option(SimConfig& cfg, const std::string& key, const std::string& value);
+// 保留站池（类型名如 "INTALU"）使用的选择策略
+SelectPolicy select_policy(const SimConfig& cfg, const std::string& pool_type);
+
+#endif
@@ -0,0 +1,290 @@
+// src/sim_stats.cpp
+#include "sim_stats.h"
+#include "sim_config.h"
+#include "sampling.h"
+#include "critpath.h"
+#include <iomanip>
+
+CoreStats core_stats;
+FrontendStats frontend_stats;
+PrfStats prf_stats;
+RenameStats rename_stats;
+FusionStats fusion_stats;
+SamplingStats sampling_stats;
+CacheStats cache_stats;
+PrefetchStats prefetch_stats;
+MemDepStats mem_dep_stats;
+DramStats dram_stats;
+EnergyStats energy_stats;
+CritPathStats critpath_stats;
+SelectStats select_stats;
+CdbStats cdb_stats;
+StoreBufferStats store_buffer_stats;
+TraceStats trace_stats;
+
+void reset_stats() {
+    core_stats = CoreStats{};
+    frontend_stats = FrontendStats{};
+    prf_stats = PrfStats{};
+    rename_stats = RenameStats{};
+    fusion_stats = FusionStats{};
+    sampling_stats = SamplingStats{};
+    cache_stats = CacheStats{};
+    prefetch_stats = PrefetchStats{};
+    mem_dep_stats = MemDepStats{};
+    dram_stats = DramStats{};
+    energy_stats = EnergyStats{};
+    critpath_stats = CritPathStats{};
+    select_stats = SelectStats{};
+    cdb_stats = CdbStats{};
+    store_buffer_stats = StoreBufferStats{};
+    trace_stats = TraceStats{};
+}
+
+// 字段名顺序须与结构体声明一致；static_assert 保证字段数不漏
+static const char* const core_fields[] = {"cycles", "committed"};
+static const char* const frontend_fields[] = {
+    "fetched", "icache_accesses", "icache_misses", "icache_stall_cycles",
+    "branch_stall_cycles", "queue_full_cycles", "issue_starved_cycles",
+    "lb_insts", "lb_cycles", "lb_captures", "lb_iterations", "lb_exits"};
+static const char* const prf_fields[] = {
+    "int_allocs", "fp_allocs", "rename_stalls", "int_in_use_sum", "fp_in_use_sum",
+    "int_in_use_max", "fp_in_use_max"};
+static const char* const rename_fields[] = {"moves_eliminated", "zeros_eliminated", "nops_eliminated"};
+static const char* const fusion_fields[] = {"lui_addi", "auipc_jalr", "slli_add", "load_op"};
+static const char* const sampling_fields[] = {
+    "units", "fast_forwarded", "warmup_insts", "measured_insts", "measured_cycles", "drain_cycles"};
+static const char* const cache_fields[] = {
+    "load_accesses", "load_hits", "load_misses", "pending_hits", "store_accesses",
+    "store_misses", "evictions", "mshr_allocs", "mshr_merges", "mshr_full_stalls",
+    "mshr_in_use_sum", "mshr_in_use_max"};
+static const char* const prefetch_fields[] = {"issued", "redundant", "useful", "late", "useless"};
+static const char* const mem_dep_fields[] = {
+    "forwarded", "speculative", "predicted_waits", "violations", "squashed",
+    "sets_allocated", "sets_merged"};
+static const char* const dram_fields[] = {
+    "reads", "writes", "row_hits", "row_empty", "row_conflicts", "bytes", "latency_sum",
+    "queue_depth_sum", "queue_depth_max", "queue_full_cycles"};
+static const char* const energy_fields[] = {
+    "rs_writes", "wakeup_compares", "cdb_broadcasts", "rob_writes", "rob_reads", "int_alu_ops",
+    "muldiv_ops", "load_ops", "store_ops", "fp_add_ops", "fp_mul_ops", "fp_div_ops", "fp_fma_ops",
+    "vec_ops", "vec_mem_ops", "mem_accesses"};
+static const char* const critpath_fields[] = {
+    "windows", "path_cycles", "issue", "fetch", "branch", "rob_full", "rs_full", "lsq_full",
+    "prf_full", "data", "dispatch", "fu_wait", "execute", "memory", "commit"};
+static const char* const select_fields[] = {"dispatched", "delay_sum", "delayed", "delay_max"};
+static const char* const cdb_fields[] = {"granted", "denied", "saturated_cycles", "requests_max"};
+static const char* const store_buffer_fields[] = {
+    "writes", "coalesced", "drained", "full_stalls", "forwarded", "occupancy_sum", "occupancy_max"};
+static const char* const trace_fields[] = {"records", "taken", "skipped", "bytes", "written", "queue_full"};
+
+template <typename T, size_t N>
+static StatBlock make_block(const char* name, T& stats, const char* const (&fields)[N]) {
+    static_assert(sizeof(T) == N * sizeof(uint64_t), "stat field names out of sync with struct");
+    return StatBlock{name, reinterpret_cast<uint64_t*>(&stats), N, fields};
+}
+
+const std::vector<StatBlock>& stat_blocks() {
+    static const std::vector<StatBlock> blocks = {
+        make_block("core", core_stats, core_fields),
+        make_block("frontend", frontend_stats, frontend_fields),
+        make_block("prf", prf_stats, prf_fields),
+        make_block("rename", rename_stats, rename_fields),
+        make_block("fusion", fusion_stats, fusion_fields),
+        make_block("sampling", sampling_stats, sampling_fields),
+        make_block("cache", cache_stats, cache_fields),
+        make_block("prefetch", prefetch_stats, prefetch_fields),
+        make_block("mem_dep", mem_dep_stats, mem_dep_fields),
+        make_block("dram", dram_stats, dram_fields),
+        make_block("energy", energy_stats, energy_fields),
+        make_block("critpath", critpath_stats, critpath_fields),
+        make_block("select", select_stats, select_fields),
+        make_block("cdb", cdb_stats, cdb_fields),
+        make_block("store_buffer", store_buffer_stats, store_buffer_fields),
+        make_block("trace", trace_stats, trace_fields),
+    };
+    return blocks;
+}
+
+static double ratio(uint64_t a, uint64_t b) {
+    return b ? static_cast<double>(a) / static_cast<double>(b) : 0.0;
+}
+
+void print_stats(std::ostream& os) {
+    os << "===================  statistics =====================\n";
+    os << std::fixed << std::setprecision(3);
+    os << "cycles            : " << core_stats.cycles << "\n";
+    os << "committed         : " << core_stats.committed << "\n";
+    os << "IPC               : " << ratio(core_stats.committed, core_stats.cycles) << "\n";
+
+    if (sim_config.sample) print_sampling_stats(os);
+
+    if (trace_stats.records > 0) {
+        const TraceStats& t = trace_stats;
+        os << "--- trace-driven ---\n";
+        os << "records           : " << t.records << " (taken " << t.taken << ", skipped " << t.skipped << ")\n";
+        // 平均每条记录的压缩后字节数
+        os << "bytes per record  : " << ratio(t.bytes, t.records) << "\n";
+    }
+    if (trace_stats.written > 0) {
+        os << "--- trace capture ---\n";
+        os << "records written   : " << trace_stats.written << " (queue full waits " << trace_stats.queue_full << ")\n";
+    }
+
+    if (sim_config.move_elim) {
+        const RenameStats& r = rename_stats;
+        uint64_t eliminated = r.moves_eliminated + r.zeros_eliminated + r.nops_eliminated;
+        os << "--- rename-time elimination ---\n";
+        os << "moves             : " << r.moves_eliminated << "\n";
+        os << "zero idioms       : " << r.zeros_eliminated << "\n";
+        os << "nops              : " << r.nops_eliminated << "\n";
+        // 没有占用 RS / FU 的指令比例；每条执行的指令平均对应的提交指令数即有效宽度增益
+        os << "eliminated ratio  : " << ratio(eliminated, core_stats.committed) << "\n";
+        os << "width gain        : " << ratio(core_stats.committed, core_stats.committed - eliminated) << "\n";
+    }
+
+    if (sim_config.fusion_enabled()) {
+        const FusionStats& u = fusion_stats;
+        uint64_t pairs = u.lui_addi + u.auipc_jalr + u.slli_add + u.load_op;
+        os << "--- macro-op fusion ---\n";
+        os << "lui+addi          : " << u.lui_addi << "\n";
+        os << "auipc+jalr        : " << u.auipc_jalr << "\n";
+        os << "slli+add          : " << u.slli_add << "\n";
+        os << "load+op           : " << u.load_op << "\n";
+        // 被融合的指令占提交指令的比例，以及每个 ROB 条目平均代表的指令数
+        os << "fused ratio       : " << ratio(2 * pairs, core_stats.committed) << "\n";
+        os << "insts per entry   : " << ratio(core_stats.committed, core_stats.committed - pairs) << "\n";
+    }
+
+    if (sim_config.rename == "prf") {
+        const PrfStats& r = prf_stats;
+        os << "--- physical register file (int " << sim_config.prf_int_size
+           << ", fp " << sim_config.prf_fp_size << ") ---\n";
+        os << "allocations       : int " << r.int_allocs << ", fp " << r.fp_allocs << "\n";
+        os << "avg in use        : int " << ratio(r.int_in_use_sum, core_stats.cycles)
+           << ", fp " << ratio(r.fp_in_use_sum, core_stats.cycles) << "\n";
+        os << "max in use        : int " << r.int_in_use_max << ", fp " << r.fp_in_use_max << "\n";
+        os << "rename stalls     : " << r.rename_stalls << "\n";
+    }
+
+    const FrontendStats& f = frontend_stats;
+    os << "--- front end (width " << sim_config.fetch_width << ", queue "
+       << sim_config.fetch_queue_size << ") ---\n";
+    os << "fetched           : " << f.fetched << "\n";
+    if (sim_config.icache_enabled) {
+        os << "L1I accesses      : " << f.icache_accesses << " (misses " << f.icache_misses << ")\n";
+    }
+    os << "fetch stalls      : icache " << f.icache_stall_cycles << ", branch " << f.branch_stall_cycles
+       << ", queue full " << f.queue_full_cycles << "\n";
+    os << "issue starved     : " << f.issue_starved_cycles << "\n";
+    if (sim_config.loop_buffer > 0) {
+        os << "loop buffer       : " << sim_config.loop_buffer << " entries, hit rate "
+           << ratio(f.lb_insts, f.fetched) << " (" << f.lb_insts << " insts)\n";
+        os << "loops             : captured " << f.lb_captures << ", iterations " << f.lb_iterations
+           << ", exits " << f.lb_exits << "\n";
+        os << "front end saved   : " << f.lb_cycles << " fetch cycles served by loop buffer\n";
+    }
+
+    const SelectStats& sel = select_stats;
+    os << "--- dispatch select: " << sim_config.select << " ---\n";
+    os << "dispatched        : " << sel.dispatched << "\n";
+    // 就绪后下一周期即发出记为 0，多出的周期是 FU 冲突、访存顺序或选择策略造成的损失
+    os << "avg delay         : " << ratio(sel.delay_sum, sel.dispatched) << " cycles after wakeup (max "
+       << sel.delay_max << ")\n";
+    os << "delayed           : " << sel.delayed << " (" << ratio(sel.delayed, sel.dispatched) << ")\n";
+
+    if (sim_config.cdbs > 0) {
+        const CdbStats& c = cdb_stats;
+        os << "--- CDB (" << sim_config.cdbs << (sim_config.cdbs == 1 ? " bus, " : " buses, ") << sim_config.cdb_priority << ") ---\n";
+        os << "broadcasts        : " << c.granted << "\n";
+        // 每周期平均占用的总线比例；饱和周期多说明写回带宽是瓶颈
+        os << "bus utilization   : " << ratio(c.granted, core_stats.cycles * sim_config.cdbs) << "\n";
+        os << "conflict stalls   : " << c.denied << " (results held a cycle for a bus)\n";
+        os << "saturated cycles  : " << c.saturated_cycles << " (max " << c.requests_max << " requests)\n";
+    }
+
+    if (sim_config.dcache_enabled) {
+        os << "--- L1D (" << sim_config.dcache_sets << " sets x " << sim_config.dcache_ways
+           << " ways x " << sim_config.dcache_line << "B) ---\n";
+        os << "load accesses     : " << cache_stats.load_accesses << "\n";
+        os << "load hits         : " << cache_stats.load_hits
+           << " (pending " << cache_stats.pending_hits << ")\n";
+        os << "load misses       : " << cache_stats.load_misses << "\n";
+        os << "load miss rate    : " << ratio(cache_stats.load_misses, cache_stats.load_accesses) << "\n";
+        os << "store accesses    : " << cache_stats.store_accesses
+           << " (misses " << cache_stats.store_misses << ")\n";
+        os << "evictions         : " << cache_stats.evictions << "\n";
+        if (sim_config.dcache_mshrs > 0) {
+            const CacheStats& c = cache_stats;
+            os << "MSHRs             : " << sim_config.dcache_mshrs << " x " << sim_config.mshr_targets
+               << " targets\n";
+            os << "MSHR allocations  : " << c.mshr_allocs << " (merged " << c.mshr_merges << ")\n";
+            // 平均占用即平均在途缺失数（访存级并行度）
+            os << "avg MSHR in use   : " << ratio(c.mshr_in_use_sum, core_stats.cycles)
+               << " (max " << c.mshr_in_use_max << ")\n";
+            os << "MSHR full stalls  : " << c.mshr_full_stalls << "\n";
+        }
+    }
+
+    if (sim_config.store_buffer > 0) {
+        const StoreBufferStats& b = store_buffer_stats;
+        os << "--- store buffer (" << sim_config.store_buffer << " lines, drain "
+           << sim_config.sb_drain_width << "/cycle) ---\n";
+        os << "writes            : " << b.writes << " (coalesced " << b.coalesced << ")\n";
+        // 每次排空写一行；合并越多，排空的行数比写入少得越多
+        os << "lines drained     : " << b.drained << "\n";
+        os << "avg occupancy     : " << ratio(b.occupancy_sum, core_stats.cycles) << " (max "
+           << b.occupancy_max << ")\n";
+        os << "full stalls       : " << b.full_stalls << " (commit cycles blocked by a full buffer)\n";
+        os << "forwarded loads   : " << b.forwarded << "\n";
+    }
+
+    if (sim_config.prefetcher != "none") {
+        const PrefetchStats& p = prefetch_stats;
+        os << "--- prefetcher: " << sim_config.prefetcher << " (degree " << sim_config.pf_degree
+           << ", distance " << sim_config.pf_distance << ") ---\n";
+        os << "issued            : " << p.issued << " (redundant " << p.redundant << ")\n";
+        os << "useful            : " << p.useful << " (late " << p.late << ")\n";
+        os << "useless           : " << p.useless << "\n";
+        // 准确率：有用预取 / 发出的预取
+        os << "accuracy          : " << ratio(p.useful, p.issued) << "\n";
+        // 覆盖率：被预取消除的缺失 / 无预取时的缺失（有用预取 + 剩余缺失）
+        os << "coverage          : " << ratio(p.useful, p.useful + cache_stats.load_misses) << "\n";
+        // 及时性：有用预取中在 demand 到达前已返回的比例
+        os << "timeliness        : " << ratio(p.useful - p.late, p.useful) << "\n";
+    }
+    if (sim_config.dram_enabled) {
+        const DramStats& d = dram_stats;
+        uint64_t requests = d.reads + d.writes;
+        os << "--- DRAM (" << sim_config.dram_channels << " ch x " << sim_config.dram_ranks << " ranks x "
+           << sim_config.dram_banks << " banks, " << sim_config.dram_page << " page, "
+           << sim_config.dram_sched << ") ---\n";
+        os << "requests          : " << requests << " (reads " << d.reads << ", writes " << d.writes << ")\n";
+        os << "row buffer        : hits " << d.row_hits << ", empty " << d.row_empty
+           << ", conflicts " << d.row_conflicts << "\n";
+        os << "row hit rate      : " << ratio(d.row_hits, requests) << "\n";
+        os << "avg latency       : " << ratio(d.latency_sum, requests) << "\n";
+        // 队列深度与带宽按模拟时钟（含快进）平均
+        os << "avg queue depth   : " << ratio(d.queue_depth_sum, sim_now())
+           << " (max " << d.queue_depth_max << ", full " << d.queue_full_cycles << " cycles)\n";
+        // 峰值：每通道每 tBURST 周期一次突发
+        uint64_t burst = requests ? d.bytes / requests : 0;
+        double peak = ratio(burst * sim_config.dram_channels, sim_config.dram_tburst);
+        double bandwidth = ratio(d.bytes, sim_now());
+        os << "bandwidth         : " << bandwidth << " B/cycle ("
+           << 100.0 * (peak > 0 ? bandwidth / peak : 0.0) << "% of peak)\n";
+    }
+    const MemDepStats& m = mem_dep_stats;
+    os << "--- memory dependence: " << sim_config.mem_dep << " ---\n";
+    os << "store forwarded   : " << m.forwarded << "\n";
+    os << "speculative loads : " << m.speculative << "\n";
+    os << "predicted waits   : " << m.predicted_waits << "\n";
+    os << "violations        : " << m.violations << "\n";
+    os << "squashed insts    : " << m.squashed << "\n";
+    if (sim_config.mem_dep == "store_set") {
+        os << "store sets        : " << m.sets_allocated << " allocated, " << m.sets_merged << " merged\n";
+    }
+    if (sim_config.energy_enabled) print_energy_report(os);
+    if (sim_config.critpath) print_critpath_report(os);
+    os << std::defaultfloat;
+}
@@ -0,0 +1,211 @@
+// src/sim_stats.h
+#ifndef SIM_STATS_H
+#define SIM_STATS_H
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+// 统计计数器：每个结构体只含 uint64_t，便于整体导出
+
+struct CoreStats {
+    uint64_t cycles = 0;
+    uint64_t committed = 0;        // 提交的指令数
+};
+
+struct PrfStats {
+    uint64_t int_allocs = 0;
+    uint64_t fp_allocs = 0;
+    uint64_t rename_stalls = 0;    // 空闲表为空导致发射停顿的周期
+    uint64_t int_in_use_sum = 0;   // 每周期占用之和，除以 cycles 得平均占用
+    uint64_t fp_in_use_sum = 0;
+    uint64_t int_in_use_max = 0;
+    uint64_t fp_in_use_max = 0;
+};
+
+struct RenameStats {
+    uint64_t moves_eliminated = 0;  // addi rd,rs,0 / add rd,rs,x0 / fmv.d 等
+    uint64_t zeros_eliminated = 0;  // li rd,0 / xor rd,rs,rs / sub rd,rs,rs 等
+    uint64_t nops_eliminated = 0;   // 目的寄存器为 x0 的 ALU 习语
+};
+
+struct SamplingStats {
+    uint64_t units = 0;                // 完成测量的采样单元数
+    uint64_t fast_forwarded = 0;       // 功能模拟（含 cache 预热）的指令数
+    uint64_t warmup_insts = 0;         // 测量前详细预热提交的指令数
+    uint64_t measured_insts = 0;       // 测量窗口内提交的指令数
+    uint64_t measured_cycles = 0;
+    uint64_t drain_cycles = 0;         // 退出详细模拟前排空流水线的周期
+};
+
+struct FusionStats {                // 提交的融合对（每对两条指令）
+    uint64_t lui_addi = 0;
+    uint64_t auipc_jalr = 0;
+    uint64_t slli_add = 0;
+    uint64_t load_op = 0;
+};
+
+struct FrontendStats {
+    uint64_t fetched = 0;              // 进入取指队列的指令数
+    uint64_t icache_accesses = 0;
+    uint64_t icache_misses = 0;
+    uint64_t icache_stall_cycles = 0;  // 取指因 L1I 缺失停顿
+    uint64_t branch_stall_cycles = 0;  // 取指等待分支 / JALR 解析
+    uint64_t queue_full_cycles = 0;    // 取指队列满（后端阻塞）
+    uint64_t issue_starved_cycles = 0; // 发射阶段取指队列为空（前端瓶颈）
+    uint64_t lb_insts = 0;             // 由循环缓冲送入取指队列的指令
+    uint64_t lb_cycles = 0;            // 由循环缓冲供指、L1I 与译码空闲的周期
+    uint64_t lb_captures = 0;          // 锁定的循环
+    uint64_t lb_iterations = 0;        // 按跳转预测送出的循环分支（省去的分支等待）
+    uint64_t lb_exits = 0;             // 循环分支实际不跳转、冲刷后退出循环缓冲
+};
+
+struct CacheStats {
+    uint64_t load_accesses = 0;
+    uint64_t load_hits = 0;
+    uint64_t load_misses = 0;
+    uint64_t pending_hits = 0;     // 命中但数据仍在途（等待剩余延迟）
+    uint64_t store_accesses = 0;
+    uint64_t store_misses = 0;
+    uint64_t evictions = 0;
+    uint64_t mshr_allocs = 0;      // 首次缺失分配的 MSHR
+    uint64_t mshr_merges = 0;      // 同一行的后续缺失合并到已有 MSHR
+    uint64_t mshr_full_stalls = 0; // load 因无可用 MSHR（或目标已满）留在 RS 中的次数
+    uint64_t mshr_in_use_sum = 0;  // 每周期占用之和，除以 cycles 得平均在途缺失数
+    uint64_t mshr_in_use_max = 0;
+};
+
+struct PrefetchStats {
+    uint64_t issued = 0;           // 发往内存的预取
+    uint64_t redundant = 0;        // 目标行已在 cache 中，被丢弃
+    uint64_t useful = 0;           // 预取行被 demand 访问命中
+    uint64_t late = 0;             // 命中时预取尚未返回
+    uint64_t useless = 0;          // 未被访问就被替换
+};
+
+struct MemDepStats {
+    uint64_t forwarded = 0;        // 从 LSQ 中更老的 store 直接取得数据的 load
+    uint64_t speculative = 0;      // 越过地址未知的更老 store 执行的 load
+    uint64_t predicted_waits = 0;  // 因预测依赖而推迟的 load（每条 load 计一次）
+    uint64_t violations = 0;       // store 地址解析时发现已执行的更年轻 load 读了旧值
+    uint64_t squashed = 0;         // 因违例被冲刷并重新取指的指令数（含该 load）
+    uint64_t sets_allocated = 0;
+    uint64_t sets_merged = 0;
+};
+
+struct DramStats {
+    uint64_t reads = 0;
+    uint64_t writes = 0;
+    uint64_t row_hits = 0;         // 目标行已在行缓冲中
+    uint64_t row_empty = 0;        // bank 已预充电，只需激活
+    uint64_t row_conflicts = 0;    // 需先关闭另一行再激活
+    uint64_t bytes = 0;            // 数据总线上传输的字节数
+    uint64_t latency_sum = 0;      // 到达控制器到数据返回的周期之和
+    uint64_t queue_depth_sum = 0;  // 每周期队列中请求数之和
+    uint64_t queue_depth_max = 0;
+    uint64_t queue_full_cycles = 0;// 请求因队列满推迟进入的周期
+};
+
+struct EnergyStats {                // 能耗模型用的活动计数（cache / DRAM 事件取自上面的统计）
+    uint64_t rs_writes = 0;
+    uint64_t wakeup_compares = 0;      // CDB 广播时与等待中的源操作数标签比较
+    uint64_t cdb_broadcasts = 0;
+    uint64_t rob_writes = 0;           // 发射分配 + 结果写回
+    uint64_t rob_reads = 0;            // 提交
+    uint64_t int_alu_ops = 0;
+    uint64_t muldiv_ops = 0;
+    uint64_t load_ops = 0;
+    uint64_t store_ops = 0;
+    uint64_t fp_add_ops = 0;
+    uint64_t fp_mul_ops = 0;
+    uint64_t fp_div_ops = 0;
+    uint64_t fp_fma_ops = 0;
+    uint64_t vec_ops = 0;
+    uint64_t vec_mem_ops = 0;
+    uint64_t mem_accesses = 0;         // 未开 DRAM 模型时访问平坦内存的次数
+};
+
+struct SelectStats {                // 保留站发往 FU 的选择
+    uint64_t dispatched = 0;
+    uint64_t delay_sum = 0;        // 就绪到发出多等的周期之和（就绪后下一周期发出为 0）
+    uint64_t delayed = 0;          // 就绪后没能在下一周期发出的操作数
+    uint64_t delay_max = 0;
+};
+
+struct CdbStats {                   // 有限条结果总线时的仲裁（不含被消除 move 的转发）
+    uint64_t granted = 0;          // 获得总线的结果
+    uint64_t denied = 0;           // 未获授权、留在 FU / MSHR 中的结果周期数
+    uint64_t saturated_cycles = 0; // 申请数超过总线数的周期
+    uint64_t requests_max = 0;     // 单周期最多的申请数
+};
+
+struct StoreBufferStats {           // 提交后 store buffer
+    uint64_t writes = 0;           // 进入缓冲的 64 位写入
+    uint64_t coalesced = 0;        // 合并进已有行条目的写入
+    uint64_t drained = 0;          // 写入内存的行条目
+    uint64_t full_stalls = 0;      // 缓冲满导致 store 不能提交的周期
+    uint64_t forwarded = 0;        // 从缓冲取数的 load
+    uint64_t occupancy_sum = 0;
+    uint64_t occupancy_max = 0;
+};
+
+struct TraceStats {                 // trace 驱动模式
+    uint64_t records = 0;          // 从 trace 读出的记录
+    uint64_t taken = 0;            // 其中分支 / 跳转发生的记录
+    uint64_t skipped = 0;          // 模拟器不支持而跳过的指令（系统指令、CSR 等）
+    uint64_t bytes = 0;            // trace 文件大小
+    uint64_t written = 0;          // --trace_out 写出的记录
+    uint64_t queue_full = 0;       // 写线程跟不上、提交等待环形队列空位的次数
+};
+
+struct CritPathStats {              // 关键路径上各类边的周期
+    uint64_t windows = 0;
+    uint64_t path_cycles = 0;
+    uint64_t issue = 0;
+    uint64_t fetch = 0;
+    uint64_t branch = 0;
+    uint64_t rob_full = 0;
+    uint64_t rs_full = 0;
+    uint64_t lsq_full = 0;
+    uint64_t prf_full = 0;
+    uint64_t data = 0;
+    uint64_t dispatch = 0;
+    uint64_t fu_wait = 0;
+    uint64_t execute = 0;
+    uint64_t memory = 0;
+    uint64_t commit = 0;
+};
+
+extern CoreStats core_stats;
+extern FrontendStats frontend_stats;
+extern PrfStats prf_stats;
+extern RenameStats rename_stats;
+extern FusionStats fusion_stats;
+extern SamplingStats sampling_stats;
+extern CacheStats cache_stats;
+extern PrefetchStats prefetch_stats;
+extern MemDepStats mem_dep_stats;
+extern DramStats dram_stats;
+extern EnergyStats energy_stats;
+extern CritPathStats critpath_stats;
+extern SelectStats select_stats;
+extern CdbStats cdb_stats;
+extern StoreBufferStats store_buffer_stats;
+extern TraceStats trace_stats;
+
+// 模拟时钟：详细模拟的周期数加功能快进的指令数（快进按每条指令一拍推进 cache 的 LRU 与填充时间）
+inline uint64_t sim_now() { return core_stats.cycles + sampling_stats.fast_forwarded; }
+
+// 一个统计块：连续的 uint64_t 计数器及其字段名，外部可按地址直接映射为数组（不拷贝）。
+// reset_stats() 原地清零，地址在整个进程生命周期内不变
+struct StatBlock {
+    const char* name;
+    uint64_t* data;
+    size_t size;
+    const char* const* fields;
+};
+const std::vector<StatBlock>& stat_blocks();
+
+void reset_stats();
+void print_stats(std::ostream& os);
+
+#endif
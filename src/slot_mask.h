@@ -0,0 +1,58 @@
+// src/slot_mask.h
+#ifndef SLOT_MASK_H
+#define SLOT_MASK_H
+#include <cstdint>
+
+// 定长位图：记录 ROB / 保留站等结构中哪些条目被占用、就绪或在等待。
+// 分配与选择用 find-first-set，代价与字数成正比，条目增加到数百个时每周期开销基本不变
+template <int N>
+struct SlotMask {
+    static constexpr int WORDS = (N + 63) / 64;
+    uint64_t w[WORDS] = {};
+
+    void set(int i) { w[i >> 6] |= 1ULL << (i & 63); }
+    void reset(int i) { w[i >> 6] &= ~(1ULL << (i & 63)); }
+    bool test(int i) const { return (w[i >> 6] >> (i & 63)) & 1; }
+    void clear() {
+        for (auto& x : w) x = 0;
+    }
+    bool none() const {
+        for (auto x : w) {
+            if (x) return false;
+        }
+        return true;
+    }
+    SlotMask operator&(const SlotMask& o) const {
+        SlotMask r;
+        for (int k = 0; k < WORDS; ++k) r.w[k] = w[k] & o.w[k];
+        return r;
+    }
+    int count() const {
+        int n = 0;
+        for (auto x : w) n += __builtin_popcountll(x);
+        return n;
+    }
+    // 下标不小于 from 的第一个置位，没有返回 -1；遍历写作 for (i = next(0); i >= 0; i = next(i + 1))
+    int next(int from = 0) const {
+        if (from >= N) return -1;
+        int k = from >> 6;
+        uint64_t x = w[k] & (~0ULL << (from & 63));
+        while (true) {
+            if (x) return k * 64 + __builtin_ctzll(x);
+            if (++k >= WORDS) return -1;
+            x = w[k];
+        }
+    }
+    // 前 size 个条目中第一个空位，没有返回 -1
+    int first_free(int size) const {
+        for (int k = 0; k * 64 < size; ++k) {
+            uint64_t x = ~w[k];
+            if (!x) continue;
+            int i = k * 64 + __builtin_ctzll(x);
+            return i < size ? i : -1;
+        }
+        return -1;
+    }
+};
+
+#endif
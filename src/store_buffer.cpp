@@ -0,0 +1,131 @@
+// src/store_buffer.cpp
+#include "store_buffer.h"
+#include "cache.h"
+#include "dram.h"
+#include "sim_stats.h"
+#include "tomasulo_sim.h"
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+// 一个条目对应一行，保存合并后的各个写入
+struct SbEntry {
+    uint64_t line;
+    std::vector<StoreWrite> writes;
+};
+
+static std::deque<SbEntry> entries;
+static size_t capacity = 0;
+static int drain_width = 1;
+static uint64_t line_size = 64;
+static uint64_t port_free = 0;   // 排空端口下次可用的周期
+static uint64_t port_req = 0;    // 端口在等待的 DRAM 请求（写分配填充），0 表示没有
+
+void sb_reset(const SimConfig& cfg) {
+    entries.clear();
+    capacity = static_cast<size_t>(cfg.store_buffer);
+    drain_width = cfg.sb_drain_width;
+    line_size = static_cast<uint64_t>(cfg.dcache_line);
+    port_free = 0;
+    port_req = 0;
+}
+
+bool sb_enabled() {
+    return capacity > 0;
+}
+
+bool sb_empty() {
+    return entries.empty();
+}
+
+static SbEntry* find_line(uint64_t line) {
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        if (it->line == line) return &*it;
+    }
+    return nullptr;
+}
+
+bool sb_insert(const StoreWrite* writes, int n) {
+    StoreBufferStats& s = store_buffer_stats;
+    // 先数需要的新行；一条向量 store 跨的行比整个缓冲还多时，只在缓冲为空时放行，避免永久停顿
+    std::vector<uint64_t> fresh;
+    for (int i = 0; i < n; ++i) {
+        uint64_t line = writes[i].addr / line_size;
+        if (!find_line(line) && std::find(fresh.begin(), fresh.end(), line) == fresh.end()) {
+            fresh.push_back(line);
+        }
+    }
+    if (!entries.empty() && entries.size() + fresh.size() > capacity) {
+        s.full_stalls++;
+        return false;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        const StoreWrite& w = writes[i];
+        s.writes++;
+        uint64_t line = w.addr / line_size;
+        SbEntry* e = find_line(line);
+        if (!e) {
+            entries.push_back(SbEntry{line, {}});
+            entries.back().writes.push_back(w);
+            continue;
+        }
+        s.coalesced++;
+        auto same = std::find_if(e->writes.begin(), e->writes.end(), [&](const StoreWrite& o) {
+            return o.addr == w.addr;
+        });
+        if (same == e->writes.end()) {
+            e->writes.push_back(w);
+            continue;
+        }
+        // 部分写入合并进已有的字；整字写入才保留浮点类别
+        uint64_t m = expand_byte_mask(w.mask);
+        same->bits = (same->bits & ~m) | (w.bits & m);
+        same->mask |= w.mask;
+        same->fp = w.mask == 0xFF && w.fp;
+    }
+    return true;
+}
+
+static void write_line(const SbEntry& e) {
+    for (const StoreWrite& w : e.writes) write_mem_word(w.addr, w.bits, w.mask, w.fp);
+}
+
+void sb_drain(uint64_t now) {
+    if (!sb_enabled()) return;
+    StoreBufferStats& s = store_buffer_stats;
+    // 占用按周期开始时计，即上一周期提交后留在缓冲中的行数
+    s.occupancy_sum += entries.size();
+    s.occupancy_max = std::max<uint64_t>(s.occupancy_max, entries.size());
+    if (port_req && dram_ready({port_req}, now)) port_req = 0;
+    for (int k = 0; k < drain_width && !entries.empty() && !port_req && port_free <= now; ++k) {
+        const SbEntry& e = entries.front();
+        write_line(e);
+        uint64_t req = 0;
+        int extra = dcache_store_access(e.writes.front().addr, now, &req);
+        entries.pop_front();
+        s.drained++;
+        // 写分配缺失：行填充回来之前不再排空
+        if (extra > 0) port_free = now + extra;
+        port_req = req;
+    }
+}
+
+bool sb_forward(uint64_t word, uint64_t& bits, uint8_t& mask, bool* fp) {
+    bits = 0;
+    mask = 0;
+    if (entries.empty()) return false;
+    // 同一行可能有多个条目（较老的条目已不再接受合并），从老到新叠加
+    uint64_t line = word / line_size;
+    for (const SbEntry& e : entries) {
+        if (e.line != line) continue;
+        for (const StoreWrite& w : e.writes) {
+            if (w.addr != word) continue;
+            uint64_t m = expand_byte_mask(w.mask);
+            bits = (bits & ~m) | (w.bits & m);
+            mask |= w.mask;
+            if (fp) *fp = w.mask == 0xFF && w.fp;
+        }
+    }
+    return mask != 0;
+}
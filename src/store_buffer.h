@@ -0,0 +1,42 @@
+// src/store_buffer.h
+#ifndef STORE_BUFFER_H
+#define STORE_BUFFER_H
+#include <cstdint>
+#include "sim_config.h"
+
+// 提交后 store buffer（--store_buffer > 0 时启用）：store 提交时只把写入放进缓冲就释放 ROB / LSQ，
+// 缓冲按 L1D 行组织，写到已有同一行条目的写入就地合并（write-combining），
+// 每周期从头部按 sb_drain_width 行的带宽写入内存；写分配缺失时排空端口等待该行填充。
+// 缓冲满时提交停顿。load 先查 LSQ，再查缓冲（最年轻者优先），最后读内存
+
+// 对一个 8 字节对齐的字的写入，mask 为写到的字节（第 b 位对应字内第 b 字节），bits 中其余字节无意义。
+// fp 为 true 时是整字浮点写入，写入 memory_fp（位模式），否则与原值合并后写入 memory_int。
+// 同一行中对同一字的写入合并为一个，新写入的字节覆盖旧的
+struct StoreWrite {
+    uint64_t addr;
+    uint64_t bits;
+    uint8_t mask;
+    bool fp;
+};
+
+// 字节掩码展开成 64 位位掩码
+inline uint64_t expand_byte_mask(uint8_t mask) {
+    uint64_t m = 0;
+    for (int b = 0; b < 8; ++b) {
+        if ((mask >> b) & 1) m |= 0xFFULL << (b * 8);
+    }
+    return m;
+}
+
+void sb_reset(const SimConfig& cfg);
+bool sb_enabled();
+bool sb_empty();
+// 一条 store 的全部写入一起进入缓冲；需要的新行超过空闲条目时不写入并返回 false（提交停顿）
+bool sb_insert(const StoreWrite* writes, int n);
+// 每周期提交之前调用：统计占用，再把头部条目写入内存与 L1D
+void sb_drain(uint64_t now);
+// 缓冲中对字 word 尚未写回的字节（不计统计）：按从老到新合并，mask 为其中有数据的字节；
+// fp 非空时返回最终是否为整字浮点写入
+bool sb_forward(uint64_t word, uint64_t& bits, uint8_t& mask, bool* fp = nullptr);
+
+#endif
@@ -1,15 +1,35 @@
 // src/tomasulo_sim.cpp
 #include "tomasulo_sim.h"
+#include "cache.h"
+#include "dram.h"
+#include "energy.h"
+#include "critpath.h"
+#include "history.h"
+#include "mem_dep.h"
+#include "frontend.h"
+#include "prf.h"
+#include "fusion.h"
+#include "sampling.h"
+#include "store_buffer.h"
+#include "trace.h"
+#include "vector_unit.h"
 #include <iostream>
 #include <cmath>
+#include <cstring>
+#include <algorithm>
 #include <limits>
+#include <random>
 #include <stdexcept>
 
 uint64_t regs_int[32] = {0};
 double regs_fp[32] = {0.0};
+VecData regs_vec[32];
+uint64_t vec_vl = 0;
 
-std::string regs_int_status[32] = {};
-std::string regs_fp_status[32] = {};
+int regs_int_status[32];
+int regs_fp_status[32];
+int regs_vec_status[32];
+int vec_vl_status = NO_TAG;
 
 std::unordered_map<uint64_t, uint64_t> memory_int;
 std::unordered_map<uint64_t, double> memory_fp;
@@ -21,6 +41,26 @@ ReservationStation store_rs[NUM_STORE_RS];
 ReservationStation fpadd_rs[NUM_FPADD_RS];
 ReservationStation fpmul_rs[NUM_FPMUL_RS];
 ReservationStation fpdiv_rs[NUM_FPDIV_RS];
+ReservationStation fpfma_rs[NUM_FPFMA_RS];
+ReservationStation vec_rs[NUM_VEC_RS];
+ReservationStation vec_mem_rs[NUM_VEC_MEM_RS];
+
+RsPool rs_pools[NUM_RS_POOLS] = {
+    {"INTALU", intalu_rs, NUM_INTALU_RS},
+    {"MULDIV", muldiv_rs, NUM_MULDIV_RS},
+    {"LOAD", load_rs, NUM_LOAD_RS},
+    {"STORE", store_rs, NUM_STORE_RS},
+    {"FPADD", fpadd_rs, NUM_FPADD_RS},
+    {"FPMUL", fpmul_rs, NUM_FPMUL_RS},
+    {"FPDIV", fpdiv_rs, NUM_FPDIV_RS},
+    {"FPFMA", fpfma_rs, NUM_FPFMA_RS},
+    {"VEC", vec_rs, NUM_VEC_RS},
+    {"VMEM", vec_mem_rs, NUM_VEC_MEM_RS},
+};
+static_assert(NUM_INTALU_RS <= RS_POOL_MAX && NUM_MULDIV_RS <= RS_POOL_MAX && NUM_LOAD_RS <= RS_POOL_MAX &&
+              NUM_STORE_RS <= RS_POOL_MAX && NUM_FPADD_RS <= RS_POOL_MAX && NUM_FPMUL_RS <= RS_POOL_MAX &&
+              NUM_FPDIV_RS <= RS_POOL_MAX && NUM_FPFMA_RS <= RS_POOL_MAX && NUM_VEC_RS <= RS_POOL_MAX &&
+              NUM_VEC_MEM_RS <= RS_POOL_MAX, "RS pool exceeds RS_POOL_MAX (raise it in tomasulo_sim.h)");
 
 std::array<FunctionalUnit, NUM_INT_ALUS> int_alu_fus;
 std::array<FunctionalUnit, NUM_LOAD_UNITS> load_fus;
@@ -29,8 +69,13 @@ std::array<FunctionalUnit, NUM_FP_MULTIPLIERS> fp_mul_fus;
 std::array<FunctionalUnit, 1> store_fus;
 std::array<FunctionalUnit, 1> int_muldiv_fu;
 std::array<FunctionalUnit, 1> fp_div_fu;
+std::array<FunctionalUnit, NUM_FP_FMA_UNITS> fp_fma_fus;
+std::array<FunctionalUnit, NUM_VEC_UNITS> vec_fus;
+std::array<FunctionalUnit, NUM_VEC_MEM_UNITS> vec_mem_fus;
 
 ROBEntry rob[ROB_SIZE];
+Instruction rob_instr[ROB_SIZE];
+SlotMask<ROB_SIZE> rob_move_wait;
 int rob_head = 0;
 int rob_tail = 0;
 int rob_count = 0;
@@ -45,6 +90,8 @@ int lsq_count = 0;
 std::vector<Instruction> instruction_queue;
 size_t next_fetch_idx = 0;
 size_t next_fetch_branch = 0;
+bool fetch_redirect = false;
+bool fetch_barrier = false;
 
 std::string get_rs_id(const std::string& type, int idx) {
     return type + std::to_string(idx);
@@ -58,8 +105,12 @@ bool is_alu_op(OpType op) {
         case OpType::ADDI: case OpType::ANDI: case OpType::ORI: case OpType::XORI:
         case OpType::SLTI: case OpType::SLTIU:
         case OpType::SLL: case OpType::SRL: case OpType::SRA:
-        case OpType::LUI: case OpType::AUIPC: case OpType::JALR:
-        case OpType::BNE:
+        case OpType::SLLI: case OpType::SRLI: case OpType::SRAI:
+        case OpType::ADDW: case OpType::SUBW: case OpType::SLLW: case OpType::SRLW: case OpType::SRAW:
+        case OpType::ADDIW: case OpType::SLLIW: case OpType::SRLIW: case OpType::SRAIW:
+        case OpType::LUI: case OpType::AUIPC: case OpType::JAL: case OpType::JALR:
+        case OpType::BEQ: case OpType::BNE: case OpType::BLT: case OpType::BGE:
+        case OpType::BLTU: case OpType::BGEU: case OpType::VSETVLI:
             return true;
         default: return false;
     }
@@ -69,22 +120,75 @@ bool is_muldiv_op(OpType op) {
     switch (op) {
         case OpType::MUL: case OpType::MULH: case OpType::MULHSU: case OpType::MULHU:
         case OpType::DIV: case OpType::DIVU: case OpType::REM: case OpType::REMU:
+        case OpType::MULW: case OpType::DIVW: case OpType::DIVUW: case OpType::REMW: case OpType::REMUW:
             return true;
         default: return false;
     }
 }
 
 bool is_load_op(OpType op) {
-    return op == OpType::LD || op == OpType::LW || op == OpType::FLD;
+    switch (op) {
+        case OpType::LB: case OpType::LH: case OpType::LW: case OpType::LD:
+        case OpType::LBU: case OpType::LHU: case OpType::LWU: case OpType::FLD:
+            return true;
+        default: return false;
+    }
 }
 
 bool is_store_op(OpType op) {
-    return op == OpType::SD || op == OpType::SW || op == OpType::FSD;
+    switch (op) {
+        case OpType::SB: case OpType::SH: case OpType::SW: case OpType::SD: case OpType::FSD:
+            return true;
+        default: return false;
+    }
+}
+
+bool is_branch_op(OpType op) {
+    switch (op) {
+        case OpType::BEQ: case OpType::BNE: case OpType::BLT: case OpType::BGE:
+        case OpType::BLTU: case OpType::BGEU:
+            return true;
+        default: return false;
+    }
+}
+
+// 整数访存宽度（字节）
+static int int_mem_width(OpType op) {
+    switch (op) {
+        case OpType::LB: case OpType::LBU: case OpType::SB: return 1;
+        case OpType::LH: case OpType::LHU: case OpType::SH: return 2;
+        case OpType::LW: case OpType::LWU: case OpType::SW: return 4;
+        default: return 8;
+    }
+}
+
+// load 从内存取 width 字节后按宽度符号/零扩展
+static uint64_t extend_loaded_value(OpType op, uint64_t raw) {
+    switch (op) {
+        case OpType::LB:  return static_cast<uint64_t>(static_cast<int64_t>(static_cast<int8_t>(raw)));
+        case OpType::LH:  return static_cast<uint64_t>(static_cast<int64_t>(static_cast<int16_t>(raw)));
+        case OpType::LW:  return static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(raw)));
+        case OpType::LBU: return raw & 0xFFULL;
+        case OpType::LHU: return raw & 0xFFFFULL;
+        case OpType::LWU: return raw & 0xFFFFFFFFULL;
+        default: return raw;
+    }
+}
+
+static uint64_t truncate_store_value(OpType op, uint64_t value) {
+    int width = int_mem_width(op);
+    return width == 8 ? value : value & ((1ULL << (width * 8)) - 1);
+}
+
+static uint64_t sext32(uint64_t v) {
+    return static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(v)));
 }
 
 bool is_fp_add_op(OpType op) {
     return op == OpType::FADD_D || op == OpType::FSUB_D ||
-           op == OpType::FEQ_D || op == OpType::FLT_D || op == OpType::FLE_D;
+           op == OpType::FEQ_D || op == OpType::FLT_D || op == OpType::FLE_D ||
+           op == OpType::FMIN_D || op == OpType::FMAX_D ||
+           op == OpType::FSGNJ_D || op == OpType::FSGNJN_D || op == OpType::FSGNJX_D;
 }
 
 bool is_fp_mul_op(OpType op) {
@@ -92,7 +196,40 @@ bool is_fp_mul_op(OpType op) {
 }
 
 bool is_fp_div_op(OpType op) {
-    return op == OpType::FDIV_D;
+    return op == OpType::FDIV_D || op == OpType::FSQRT_D;
+}
+
+bool is_fp_fma_op(OpType op) {
+    return op == OpType::FMADD_D || op == OpType::FMSUB_D ||
+           op == OpType::FNMSUB_D || op == OpType::FNMADD_D;
+}
+
+bool is_vec_arith_op(OpType op) {
+    switch (op) {
+        case OpType::VADD_VV: case OpType::VADD_VX: case OpType::VMUL_VV: case OpType::VMUL_VX:
+        case OpType::VMACC_VV: case OpType::VMACC_VX:
+        case OpType::VFADD_VV: case OpType::VFADD_VF: case OpType::VFMUL_VV: case OpType::VFMUL_VF:
+        case OpType::VFMACC_VV: case OpType::VFMACC_VF:
+            return true;
+        default: return false;
+    }
+}
+
+bool is_vec_load_op(OpType op) {
+    return op == OpType::VLE64_V || op == OpType::VLSE64_V;
+}
+
+bool is_vec_store_op(OpType op) {
+    return op == OpType::VSE64_V || op == OpType::VSSE64_V;
+}
+
+bool is_vec_op(OpType op) {
+    return is_vec_arith_op(op) || is_vec_load_op(op) || is_vec_store_op(op);
+}
+
+static bool is_vec_macc_op(OpType op) {
+    return op == OpType::VMACC_VV || op == OpType::VMACC_VX ||
+           op == OpType::VFMACC_VV || op == OpType::VFMACC_VF;
 }
 
 int get_latency(OpType op) {
@@ -103,14 +240,30 @@ int get_latency(OpType op) {
     if (is_fp_add_op(op)) return 2;
     if (op == OpType::FMUL_D || op == OpType::FCVT_D_W || op == OpType::FCVT_W_D) return 4;
     if (op == OpType::FDIV_D) return 8;
+    if (op == OpType::FSQRT_D) return 12;
+    if (is_fp_fma_op(op)) return 5;
+    if (is_vec_load_op(op)) return 2;
+    if (is_vec_store_op(op)) return 1;
+    if (op == OpType::VADD_VV || op == OpType::VADD_VX) return 1;
+    if (op == OpType::VMUL_VV || op == OpType::VMUL_VX || op == OpType::VMACC_VV || op == OpType::VMACC_VX) return 3;
+    if (op == OpType::VFADD_VV || op == OpType::VFADD_VF) return 2;
+    if (op == OpType::VFMUL_VV || op == OpType::VFMUL_VF || op == OpType::VFMACC_VV || op == OpType::VFMACC_VF) return 4;
     return 1;
 }
 
+// 向量指令按 NUM_VEC_LANES 条 lane 流水处理，每多一组元素多占一拍
+int get_vec_latency(OpType op, uint64_t vl) {
+    uint64_t groups = (vl + NUM_VEC_LANES - 1) / NUM_VEC_LANES;
+    return get_latency(op) + (groups > 1 ? static_cast<int>(groups - 1) : 0);
+}
+
 static DestReg get_dest_reg_from_instruction(const Instruction& instr) {
-    if (instr.rd >= 0) {
+    if (instr.rd > 0) {
         return IntReg{static_cast<uint8_t>(instr.rd)};
     } else if (instr.fd >= 0) {
         return FpReg{static_cast<uint8_t>(instr.fd)};
+    } else if (instr.vd >= 0) {
+        return VecReg{static_cast<uint8_t>(instr.vd)};
     } else {
         return std::monostate{};
     }
@@ -130,6 +283,13 @@ std::string format_operand_value(const OperandValue& val) {
             s.erase(s.find_last_not_of('0') + 1, std::string::npos);
             s.erase(s.find_last_not_of('.') + 1, std::string::npos);
             return s;
+        } else if constexpr (std::is_same_v<T, VecData>) {
+            std::string s = "[";
+            for (int i = 0; i < VLMAX; ++i) {
+                if (i) s += ", ";
+                s += std::to_string(v.e[i]);
+            }
+            return s + "]";
         } else {
             return "?";
         }
@@ -158,25 +318,54 @@ static OperandValue execute_alu_op(const ReservationStation& rs) {
         case OpType::SLTIU:return OperandValue(j < k ? 1ULL : 0ULL);
         case OpType::SLL:  return OperandValue(j << (k & 0x3F));
         case OpType::SRL:  return OperandValue(j >> (k & 0x3F));
-        case OpType::SRA:  return OperandValue(static_cast<uint64_t>(j) >> (k & 0x3F));
+        case OpType::SRA:  return OperandValue(static_cast<uint64_t>(static_cast<int64_t>(j) >> (k & 0x3F)));
+        case OpType::SLLI: return OperandValue(j << (k & 0x3F));
+        case OpType::SRLI: return OperandValue(j >> (k & 0x3F));
+        case OpType::SRAI: return OperandValue(static_cast<uint64_t>(static_cast<int64_t>(j) >> (k & 0x3F)));
+        // *W：低 32 位运算，结果符号扩展
+        case OpType::ADDW: case OpType::ADDIW: return OperandValue(sext32(j + k));
+        case OpType::SUBW: return OperandValue(sext32(j - k));
+        case OpType::SLLW: case OpType::SLLIW:
+            return OperandValue(sext32(static_cast<uint32_t>(j) << (k & 0x1F)));
+        case OpType::SRLW: case OpType::SRLIW:
+            return OperandValue(sext32(static_cast<uint32_t>(j) >> (k & 0x1F)));
+        case OpType::SRAW: case OpType::SRAIW:
+            return OperandValue(sext32(static_cast<uint32_t>(static_cast<int32_t>(j) >> (k & 0x1F))));
         case OpType::LUI:  return vk;
         case OpType::AUIPC: {
-            uint64_t pc = static_cast<uint64_t>(rs.A);
             uint64_t uimm = to_int(vk);
-            return OperandValue(pc + uimm);
+            return OperandValue(rs.pc + uimm);
         }
+        case OpType::JAL:
         case OpType::JALR: {
-            return OperandValue(static_cast<uint64_t>(rs.A)); // 返回地址 = PC+4
+            return OperandValue(rs.pc + 4); // 返回地址 = PC+4
         }
-        case OpType::BNE: {
-            // BNE: if (rs1 != rs2) then branch (result is 1), else 0.
-            return OperandValue((j != k) ? 1ULL : 0ULL);
+        // 分支：条件成立结果为 1，目标在 executeFU 中计算
+        case OpType::BEQ:  return OperandValue((j == k) ? 1ULL : 0ULL);
+        case OpType::BNE:  return OperandValue((j != k) ? 1ULL : 0ULL);
+        case OpType::BLT:  return OperandValue(static_cast<int64_t>(j) < static_cast<int64_t>(k) ? 1ULL : 0ULL);
+        case OpType::BGE:  return OperandValue(static_cast<int64_t>(j) >= static_cast<int64_t>(k) ? 1ULL : 0ULL);
+        case OpType::BLTU: return OperandValue(j < k ? 1ULL : 0ULL);
+        case OpType::BGEU: return OperandValue(j >= k ? 1ULL : 0ULL);
+        case OpType::VSETVLI: {
+            // j = AVL, k = vtypei；只支持 e64/m1，其余 vtype 视为非法，vl 置 0
+            bool legal = ((k >> 3) & 0x7) == 3 && (k & 0x7) == 0;
+            return OperandValue(legal ? std::min<uint64_t>(j, VLMAX) : 0ULL);
         }
         default:
             throw std::runtime_error("Unsupported ALU op");
     }
 }
 
+// 宏融合的第二个操作：first 为主操作（load / ALU）的结果
+static OperandValue execute_post_op(OpType op, const OperandValue& first, const OperandValue& other) {
+    ReservationStation rs;
+    rs.op = op;
+    rs.Vj = first;
+    rs.Vk = other;
+    return execute_alu_op(rs);
+}
+
 static OperandValue execute_muldiv_op(const ReservationStation& rs) {
     auto vj = rs.Vj.value();
     auto vk = rs.Vk.value();
@@ -192,16 +381,44 @@ static OperandValue execute_muldiv_op(const ReservationStation& rs) {
         case OpType::MULHU:  return OperandValue(static_cast<uint64_t>((unsigned __int128)uj * uk >> 64));
         case OpType::DIV:
             if (k == 0) return OperandValue(static_cast<uint64_t>(-1));
+            if (j == std::numeric_limits<int64_t>::min() && k == -1) return vj;
             return OperandValue(static_cast<uint64_t>(j / k));
         case OpType::DIVU:
             if (uk == 0) return OperandValue(~0ULL);
             return OperandValue(uj / uk);
         case OpType::REM:
             if (k == 0) return vj;
+            if (j == std::numeric_limits<int64_t>::min() && k == -1) return OperandValue(0ULL);
             return OperandValue(static_cast<uint64_t>(j % k));
         case OpType::REMU:
             if (uk == 0) return vj;
             return OperandValue(uj % uk);
+        default:
+            break;
+    }
+
+    // *W：低 32 位运算，结果符号扩展
+    int32_t wj = static_cast<int32_t>(uj);
+    int32_t wk = static_cast<int32_t>(uk);
+    uint32_t uwj = static_cast<uint32_t>(uj);
+    uint32_t uwk = static_cast<uint32_t>(uk);
+    bool w_overflow = (wj == std::numeric_limits<int32_t>::min() && wk == -1);
+    switch (rs.op) {
+        case OpType::MULW:  return OperandValue(sext32(uwj * uwk));
+        case OpType::DIVW:
+            if (wk == 0) return OperandValue(~0ULL);
+            if (w_overflow) return OperandValue(sext32(uwj));
+            return OperandValue(sext32(static_cast<uint32_t>(wj / wk)));
+        case OpType::DIVUW:
+            if (uwk == 0) return OperandValue(~0ULL);
+            return OperandValue(sext32(uwj / uwk));
+        case OpType::REMW:
+            if (wk == 0) return OperandValue(sext32(uwj));
+            if (w_overflow) return OperandValue(0ULL);
+            return OperandValue(sext32(static_cast<uint32_t>(wj % wk)));
+        case OpType::REMUW:
+            if (uwk == 0) return OperandValue(sext32(uwj));
+            return OperandValue(sext32(uwj % uwk));
         default:
             throw std::runtime_error("Unsupported MUL/DIV op");
     }
@@ -213,9 +430,36 @@ static OperandValue execute_fp_add_op(const ReservationStation& rs) {
     switch (rs.op) {
         case OpType::FADD_D: return OperandValue(fj + fk);
         case OpType::FSUB_D: return OperandValue(fj - fk);
-        case OpType::FEQ_D:  return OperandValue(fj == fk ? 1.0 : 0.0);
-        case OpType::FLT_D:  return OperandValue(fj < fk ? 1.0 : 0.0);
-        case OpType::FLE_D:  return OperandValue(fj <= fk ? 1.0 : 0.0);
+        // 比较结果写整数寄存器
+        case OpType::FEQ_D:  return OperandValue(fj == fk ? 1ULL : 0ULL);
+        case OpType::FLT_D:  return OperandValue(fj < fk ? 1ULL : 0ULL);
+        case OpType::FLE_D:  return OperandValue(fj <= fk ? 1ULL : 0ULL);
+        case OpType::FMIN_D:
+        case OpType::FMAX_D: {
+            // 一个是 NaN 时返回另一个；两个都是 NaN 返回规范 NaN；-0.0 < +0.0
+            if (std::isnan(fj) && std::isnan(fk)) return OperandValue(std::numeric_limits<double>::quiet_NaN());
+            if (std::isnan(fj)) return OperandValue(fk);
+            if (std::isnan(fk)) return OperandValue(fj);
+            bool pick_j = (rs.op == OpType::FMIN_D)
+                ? (fj < fk || (fj == fk && std::signbit(fj)))
+                : (fj > fk || (fj == fk && !std::signbit(fj)));
+            return OperandValue(pick_j ? fj : fk);
+        }
+        case OpType::FSGNJ_D:
+        case OpType::FSGNJN_D:
+        case OpType::FSGNJX_D: {
+            const uint64_t sign_mask = 1ULL << 63;
+            uint64_t bj, bk;
+            std::memcpy(&bj, &fj, sizeof(bj));
+            std::memcpy(&bk, &fk, sizeof(bk));
+            uint64_t sign = bk & sign_mask;
+            if (rs.op == OpType::FSGNJN_D) sign ^= sign_mask;
+            if (rs.op == OpType::FSGNJX_D) sign = (bj ^ bk) & sign_mask;
+            uint64_t bits = (bj & ~sign_mask) | sign;
+            double r;
+            std::memcpy(&r, &bits, sizeof(r));
+            return OperandValue(r);
+        }
         default: throw std::runtime_error("Unsupported FP add op");
     }
 }
@@ -237,34 +481,304 @@ static OperandValue execute_fp_mul_op(const ReservationStation& rs) {
         double fk = to_fp(rs.Vk.value());
         if (fk == 0.0) return OperandValue(std::numeric_limits<double>::quiet_NaN());
         return OperandValue(fj / fk);
+    } else if (rs.op == OpType::FSQRT_D) {
+        return OperandValue(std::sqrt(to_fp(rs.Vj.value())));
     }
     throw std::runtime_error("Unsupported FP mul/div op");
 }
 
-static int get_rob_index(const std::string& tag) {
-    if (tag.empty()) return -1;
-    return std::stoi(tag.substr(3));
+static OperandValue execute_fp_fma_op(const ReservationStation& rs) {
+    // 融合乘加只舍入一次：fs1 * fs2 ± fs3
+    double a = to_fp(rs.Vj.value());
+    double b = to_fp(rs.Vk.value());
+    double c = to_fp(rs.Vr.value());
+    switch (rs.op) {
+        case OpType::FMADD_D:  return OperandValue(std::fma(a, b, c));
+        case OpType::FMSUB_D:  return OperandValue(std::fma(a, b, -c));
+        case OpType::FNMSUB_D: return OperandValue(std::fma(-a, b, c));
+        case OpType::FNMADD_D: return OperandValue(std::fma(-a, b, -c));
+        default: throw std::runtime_error("Unsupported FP fma op");
+    }
+}
+
+static VecData splat_to_vec(const OperandValue& v) {
+    VecData d;
+    uint64_t bits = 0;
+    if (auto* f = std::get_if<double>(&v)) std::memcpy(&bits, f, sizeof(bits));
+    else bits = to_int(v);
+    d.e.fill(bits);
+    return d;
+}
+
+static OperandValue execute_vec_op(const ReservationStation& rs) {
+    // vd = vs2 op vs1（或标量），乘加为 vd = vs1 * vs2 + vd
+    const OperandValue& a = rs.Vj.value();
+    VecData src1 = std::holds_alternative<VecData>(a) ? to_vec(a) : splat_to_vec(a);
+    const VecData& src2 = to_vec(rs.Vk.value());
+    size_t vl = std::min<uint64_t>(to_int(rs.Vvl.value()), VLMAX);
+    VecData d = is_vec_macc_op(rs.op) ? to_vec(rs.Vr.value()) : VecData{};
+
+    auto run_fp = [&](void (*kernel)(double*, const double*, const double*, size_t)) {
+        double x[VLMAX], y[VLMAX], z[VLMAX];
+        std::memcpy(x, src1.e.data(), sizeof(x));
+        std::memcpy(y, src2.e.data(), sizeof(y));
+        std::memcpy(z, d.e.data(), sizeof(z));
+        kernel(z, x, y, vl);
+        std::memcpy(d.e.data(), z, sizeof(z));
+    };
+
+    switch (rs.op) {
+        case OpType::VADD_VV: case OpType::VADD_VX:
+            vec_add_u64(d.e.data(), src1.e.data(), src2.e.data(), vl); break;
+        case OpType::VMUL_VV: case OpType::VMUL_VX:
+            vec_mul_u64(d.e.data(), src1.e.data(), src2.e.data(), vl); break;
+        case OpType::VMACC_VV: case OpType::VMACC_VX:
+            vec_macc_u64(d.e.data(), src1.e.data(), src2.e.data(), vl); break;
+        case OpType::VFADD_VV: case OpType::VFADD_VF: run_fp(vec_fadd_f64); break;
+        case OpType::VFMUL_VV: case OpType::VFMUL_VF: run_fp(vec_fmul_f64); break;
+        case OpType::VFMACC_VV: case OpType::VFMACC_VF: run_fp(vec_fmacc_f64); break;
+        default: throw std::runtime_error("Unsupported vector op");
+    }
+    // 尾部元素按 tail-agnostic 处理，全部置 1
+    for (size_t i = vl; i < VLMAX; ++i) d.e[i] = ~0ULL;
+    return OperandValue(d);
+}
+
+// --- 内存：按 8 字节对齐的字存放 ---
+// 每个字只在一张表中：FSD 与落在浮点字上的整字向量元素写 memory_fp，其余写入（包括对任意字的
+// 部分写入）与原值合并后写 memory_int。访问按字节拆到所在的字上，跨字的访问拆成两段，
+// 所以不同宽度、相互重叠的访问看到的是同一份字节
+
+static uint64_t width_mask(int width) {
+    return width == 8 ? ~0ULL : (1ULL << (width * 8)) - 1;
+}
+
+// 字在内存中的位模式（不查 store buffer），没有写过为 0
+static uint64_t memory_word(uint64_t word) {
+    auto it = memory_int.find(word);
+    if (it != memory_int.end()) return it->second;
+    auto fp_it = memory_fp.find(word);
+    if (fp_it == memory_fp.end()) return 0;
+    uint64_t bits;
+    std::memcpy(&bits, &fp_it->second, sizeof(bits));
+    return bits;
+}
+
+// 读一个字：提交后 store buffer 中尚未写回的字节比内存新，覆盖内存中的值
+static uint64_t read_word(uint64_t word) {
+    uint64_t bits = memory_word(word);
+    uint64_t pending;
+    uint8_t mask;
+    if (sb_forward(word, pending, mask)) {
+        store_buffer_stats.forwarded++;
+        uint64_t m = expand_byte_mask(mask);
+        bits = (bits & ~m) | (pending & m);
+    }
+    return bits;
+}
+
+void write_mem_word(uint64_t word, uint64_t bits, uint8_t mask, bool fp) {
+    if (mask != 0xFF) {
+        uint64_t m = expand_byte_mask(mask);
+        bits = (memory_word(word) & ~m) | (bits & m);
+        fp = false;
+    }
+    if (fp) {
+        std::memcpy(&memory_fp[word], &bits, sizeof(bits));
+        memory_int.erase(word);
+    } else {
+        memory_int[word] = bits;
+        memory_fp.erase(word);
+    }
+}
+
+// 把从 addr 起 width 字节的访问拆到所在的字上：f(字地址, 字内字节偏移, 访问内字节偏移, 字节数)
+template <typename F>
+static void for_each_word(uint64_t addr, int width, F f) {
+    for (int done = 0; done < width;) {
+        uint64_t a = addr + done;
+        int off = static_cast<int>(a & 7);
+        int n = std::min(width - done, 8 - off);
+        f(a - off, off, done, n);
+        done += n;
+    }
+}
+
+// 按小端读 width 字节，不做扩展
+static uint64_t read_mem(uint64_t addr, int width) {
+    uint64_t v = 0;
+    for_each_word(addr, width, [&](uint64_t word, int off, int pos, int n) {
+        v |= ((read_word(word) >> (off * 8)) & width_mask(n)) << (pos * 8);
+    });
+    return v;
+}
+
+// 一次 store 拆成的按字写入；fp 只对整字写入保留
+static void append_store_writes(uint64_t addr, int width, uint64_t bits, bool fp, std::vector<StoreWrite>& out) {
+    for_each_word(addr, width, [&](uint64_t word, int off, int pos, int n) {
+        uint64_t piece = ((bits >> (pos * 8)) & width_mask(n)) << (off * 8);
+        uint8_t mask = static_cast<uint8_t>(((1u << n) - 1) << off);
+        out.push_back(StoreWrite{word, piece, mask, fp && n == 8});
+    });
+}
+
+static void write_mem(uint64_t addr, int width, uint64_t bits, bool fp) {
+    static std::vector<StoreWrite> writes;
+    writes.clear();
+    append_store_writes(addr, width, bits, fp, writes);
+    for (const StoreWrite& w : writes) write_mem_word(w.addr, w.bits, w.mask, w.fp);
+}
+
+// 向量元素写回时沿用所在字的类别：字已是浮点值（包括 store buffer 中待写的整字浮点写入）就按浮点写
+static bool word_is_fp(uint64_t addr) {
+    if (addr & 7) return false;
+    uint64_t pending;
+    uint8_t mask;
+    bool fp = false;
+    if (sb_forward(addr, pending, mask, &fp)) return fp;
+    return memory_fp.count(addr) > 0;
+}
+
+// load 读出的 width 字节转成结果：FLD 按位模式解释为 double，整数 load 按宽度扩展
+static OperandValue loaded_value(OpType op, uint64_t raw) {
+    if (op != OpType::FLD) return OperandValue(extend_loaded_value(op, raw));
+    double d;
+    std::memcpy(&d, &raw, sizeof(d));
+    return OperandValue(d);
+}
+
+// store 写入内存的位模式：FSD 写浮点数的位模式，整数 store 截断到访问宽度
+static uint64_t store_bits(OpType op, const OperandValue& data) {
+    if (op != OpType::FSD) return truncate_store_value(op, to_int(data));
+    uint64_t bits;
+    double d = to_fp(data);
+    std::memcpy(&bits, &d, sizeof(bits));
+    return bits;
+}
+
+std::string tag_name(int tag) {
+    if (tag >= ROB_SIZE) return "P" + std::to_string(tag - ROB_SIZE);
+    return "ROB" + std::to_string(tag);
+}
+
+// 读源操作数：无生产者直接读寄存器；生产者已执行完从 ROB 取值；否则记录标签等待 CDB
+static void capture_operand(int status, const OperandValue& reg_val, std::optional<OperandValue>& V, int& Q) {
+    if (status == NO_TAG) {
+        V = reg_val;
+        return;
+    }
+    if (rob[status].state == InstructionState::EXECUTED) {
+        V = rob[status].result;
+    } else {
+        Q = status;
+    }
+}
+
+// 读标量源寄存器：ROB 模式下捕获值或生产者的 ROB 标签；
+// PRF 模式下记录物理寄存器号，未就绪时等待其 prf_tag 标签
+static void read_int_source(int reg, std::optional<OperandValue>& V, int& Q, int& P) {
+    if (prf_mode()) {
+        P = rename_int[reg];
+        if (!prf_ready[P]) Q = prf_tag(P);
+        return;
+    }
+    capture_operand(regs_int_status[reg], OperandValue(regs_int[reg]), V, Q);
+}
+
+static void read_fp_source(int reg, std::optional<OperandValue>& V, int& Q, int& P) {
+    if (prf_mode()) {
+        P = rename_fp[reg];
+        if (!prf_ready[P]) Q = prf_tag(P);
+        return;
+    }
+    capture_operand(regs_fp_status[reg], OperandValue(regs_fp[reg]), V, Q);
+}
+
+// PRF 模式：已唤醒的源操作数在发往 FU 时读物理寄存器
+static void read_prf_operands(ReservationStation& rs) {
+    if (rs.Pj >= 0 && rs.Qj == NO_TAG) rs.Vj = prf[rs.Pj];
+    if (rs.Pk >= 0 && rs.Qk == NO_TAG) rs.Vk = prf[rs.Pk];
+    if (rs.Pr >= 0 && rs.Qr == NO_TAG) rs.Vr = prf[rs.Pr];
 }
 
 void ReservationStation::clear() {
     busy = false;
     op = OpType::UNKNOWN;
-    Qj = "";
-    Qk = "";
+    Qj = NO_TAG;
+    Vj.reset();
+    Qk = NO_TAG;
+    Vk.reset();
+    Qr = NO_TAG;
+    Vr.reset();
+    Qvl = NO_TAG;
+    Vvl.reset();
+    Qst = NO_TAG;
+    Pj = Pk = Pr = -1;
+    post_op = OpType::UNKNOWN;
     dest = std::monostate{};
     ROB_idx = -1;
     A = 0;
+    pc = 0;
+}
+
+int RsPool::acquire() {
+    int idx = busy.first_free(size);
+    if (idx < 0) return -1;
+    rs[idx].clear();
+    rs[idx].busy = true;
+    // 新条目比所有占用中的条目都年轻
+    older[idx] = busy;
+    for (int j = busy.next(0); j >= 0; j = busy.next(j + 1)) older[j].reset(idx);
+    busy.set(idx);
+    ready.reset(idx);
+    waiting.reset(idx);
+    return idx;
+}
+
+void RsPool::release(int idx) {
+    rs[idx].busy = false;
+    busy.reset(idx);
+    ready.reset(idx);
+    waiting.reset(idx);
+}
+
+void RsPool::update_ready(int idx) {
+    const ReservationStation& r = rs[idx];
+    bool waits = r.Qj != NO_TAG || r.Qk != NO_TAG || r.Qr != NO_TAG || r.Qvl != NO_TAG;
+    if (waits) {
+        waiting.set(idx);
+    } else {
+        waiting.reset(idx);
+    }
+    // load 的 Vk 不用；PRF 模式下已唤醒的源在发往 FU 时才读物理寄存器
+    bool k_ready = type == "LOAD" || (r.Qk == NO_TAG && (r.Vk || r.Pk >= 0));
+    if (!(r.busy && r.Qj == NO_TAG && k_ready && r.Qr == NO_TAG && r.Qvl == NO_TAG)) {
+        ready.reset(idx);
+    } else if (!ready.test(idx)) {
+        ready.set(idx);
+        ready_at[idx] = sim_now();
+    }
+}
+
+void RsPool::reset() {
+    for (int i = 0; i < size; ++i) rs[i] = ReservationStation{};
+    busy.clear();
+    ready.clear();
+    waiting.clear();
 }
 
 void FunctionalUnit::start(OpType _op, const OperandValue& a, const OperandValue& b, 
-               int _rob_idx, const std::string& _rs_type, int _rs_idx) {
+               int _rob_idx, const std::string& _rs_type, int _rs_idx,
+               const OperandValue& c, uint64_t _vl) {
         op = _op;
         v1 = a;
         v2 = b;
+        v3 = c;
+        vl = _vl;
         rob_idx = _rob_idx;
         rs_type = _rs_type;
         rs_idx = _rs_idx;
-        remaining_cycles = get_latency(_op);
+        remaining_cycles = is_vec_op(_op) ? get_vec_latency(_op, _vl) : get_latency(_op);
         busy = true;
     }
 
@@ -272,10 +786,14 @@ void FunctionalUnit::clear() {
     busy = false;
     remaining_cycles = 0;
     op = OpType::UNKNOWN;
-    v1 = OperandValue{}, v2 = OperandValue{};
+    v1 = OperandValue{}, v2 = OperandValue{}, v3 = OperandValue{};
+    vl = 0;
+    pc = 0;
     rob_idx = -1;
     rs_type.clear();
     rs_idx = -1;
+    mem_wait.clear();
+    wb_wait = false;
 }
 
 void ROBEntry::clear() {
@@ -295,136 +813,534 @@ OperandValue FunctionalUnit::compute_result() const {
         fake_rs.op = op;
         fake_rs.Vj = v1;
         fake_rs.Vk = v2;
+        fake_rs.Vr = v3;
+        fake_rs.Vvl = OperandValue(vl);
+        fake_rs.pc = pc;
 
         if (rs_type == "INTALU") return execute_alu_op(fake_rs);
         if (rs_type == "MULDIV") return execute_muldiv_op(fake_rs);
         if (rs_type == "FPADD") return execute_fp_add_op(fake_rs);
         if (rs_type == "FPMUL" || rs_type == "FPDIV") return execute_fp_mul_op(fake_rs);
+        if (rs_type == "FPFMA") return execute_fp_fma_op(fake_rs);
+        if (rs_type == "VEC") return execute_vec_op(fake_rs);
         // LOAD/STORE执行后计算
         return OperandValue(0ULL);
     }
 
+// --- 访存顺序：转发、推测执行与违例恢复 ---
+
+// 相对队头的年龄，越小越老
+static int rob_age(int idx) { return (idx - rob_head + ROB_SIZE) % ROB_SIZE; }
+static int lsq_age(int idx) { return (idx - lsq_head + LSQ_SIZE) % LSQ_SIZE; }
+
+// load 能否开始执行；越过了地址未知的更老 store 时 speculative 置真
+// 向量访存不做转发，与向量访存相关的 load/store 对都等更老的 store 提交后再执行
+static bool load_may_launch(ReservationStation& rs, bool& speculative) {
+    int my_lsq = rob[rs.ROB_idx].lsq_idx;
+    bool is_vector = is_vec_load_op(rs.op);
+    bool unknown_older_store = false;
+    for (int k = 0; k < lsq_age(my_lsq); ++k) {
+        const LSQEntry& e = lsq[(lsq_head + k) % LSQ_SIZE];
+        if (!e.valid || !e.is_store) continue;
+        if (is_vector || is_vec_store_op(e.op)) return false;
+        if (!e.addr_ready) unknown_older_store = true;
+    }
+    speculative = unknown_older_store;
+    if (!unknown_older_store) return true;
+    if (sim_config.mem_dep == "conservative") return false;
+
+    if (rs.Qst != NO_TAG) {
+        int st = rs.Qst;
+        if (rob[st].busy && rob[st].is_store && rob_age(st) < rob_age(rs.ROB_idx) &&
+            !lsq[rob[st].lsq_idx].addr_ready) {
+            return false;
+        }
+        rs.Qst = NO_TAG;
+    }
+    return true;
+}
+
+// trace 驱动模式下访存地址取自 trace 记录，寄存器值只决定何时能算出地址；
+// 记录只带一个地址，跨步向量访存按单位步长处理
+static uint64_t mem_address(int rob_idx, uint64_t base, int64_t offset) {
+    return trace_active() ? rob_instr[rob_idx].mem_addr : base + offset;
+}
+
+static int64_t vec_stride(const OperandValue& v2) {
+    return trace_active() ? static_cast<int64_t>(sizeof(uint64_t)) : static_cast<int64_t>(to_int(v2));
+}
+
+// 两个访问的字节区间是否重叠
+static bool mem_overlap(uint64_t a, int a_width, uint64_t b, int b_width) {
+    return a < b + b_width && b < a + a_width;
+}
+
+// 逐字节从更老的、地址已知的 store 中取最年轻的写入者的数据，不分整数与浮点，其余字节读内存。
+// 有字节来自 LSQ 时返回 true，raw 为拼好的 width 字节；只有一条 store 提供了全部字节时记入 fwd_lsq，
+// 字节来自多处时不记（违例检查按读了旧值处理，保守地冲刷）
+static bool forward_from_store(int load_lsq, int width, uint64_t addr, uint64_t& raw) {
+    unsigned need = (1u << width) - 1;
+    int source = -1;
+    bool single = true;
+    raw = 0;
+    for (int k = lsq_age(load_lsq) - 1; k >= 0 && need; --k) {
+        int i = (lsq_head + k) % LSQ_SIZE;
+        const LSQEntry& e = lsq[i];
+        if (!e.valid || !e.is_store || !e.addr_ready || is_vec_store_op(e.op)) continue;
+        int store_width = int_mem_width(e.op);
+        if (!mem_overlap(addr, width, e.address, store_width)) continue;
+        uint64_t bits = store_bits(e.op, *e.data);
+        for (int b = 0; b < width; ++b) {
+            uint64_t a = addr + b;
+            if (!((need >> b) & 1) || a < e.address || a >= e.address + store_width) continue;
+            raw |= ((bits >> ((a - e.address) * 8)) & 0xFF) << (b * 8);
+            need &= ~(1u << b);
+            if (source == -1) source = i;
+            else if (source != i) single = false;
+        }
+    }
+    if (source == -1) return false;
+    if (need) {
+        uint64_t mem = read_mem(addr, width);
+        for (int b = 0; b < width; ++b) {
+            if ((need >> b) & 1) raw |= mem & (0xFFULL << (b * 8));
+        }
+        single = false;
+    }
+    lsq[load_lsq].fwd_lsq = single ? source : -1;
+    return true;
+}
+
+// 非阻塞 L1D：缺失的 load 在 FU 中只占基本延迟，结果先写入 ROB，等数据返回后再经 CDB 广播
+struct MissReturn {
+    int rob_idx;
+    uint64_t launch;                 // 发往 FU 的周期
+    uint64_t arrive;                 // 数据到达 cache 的周期；DRAM 请求未返回时未知
+    std::vector<uint64_t> mem_wait;  // 未返回的 DRAM 请求
+    int latency;                     // load 基本延迟
+    bool fu_done = false;            // FU 已算出结果
+};
+static std::vector<MissReturn> miss_returns;
+
+// 与阻塞 cache 的完成周期一致：数据到达后再经过基本延迟
+static bool miss_return_ready(MissReturn& m, uint64_t now) {
+    for (auto it = m.mem_wait.begin(); it != m.mem_wait.end();) {
+        uint64_t done = dram_done_cycle(*it, now);
+        if (done == DRAM_PENDING) return false;
+        m.arrive = std::max(m.arrive, done);
+        it = m.mem_wait.erase(it);
+    }
+    return std::max(m.launch, m.arrive) + m.latency - 1 <= now;
+}
+
+// 结果总线申请：完成的 FU 或数据已返回的缺失 load
+struct CdbRequest {
+    int rob_idx;
+    int cls;                      // 按 FU 类别仲裁时的优先级，越小越先
+    FunctionalUnit* fu;           // 为空表示 miss_returns 中的 load
+    RsPool* pool;
+};
+static std::vector<CdbRequest> cdb_requests;
+
+// 按 FU 类别仲裁：长延迟单元优先（重新执行代价最大），其次访存，最后整数 ALU
+static const int cdb_class_rank[NUM_RS_POOLS] = {
+    /*INTALU*/ 8, /*MULDIV*/ 1, /*LOAD*/ 6, /*STORE*/ 9, /*FPADD*/ 4,
+    /*FPMUL*/ 3, /*FPDIV*/ 0, /*FPFMA*/ 2, /*VEC*/ 5, /*VMEM*/ 7};
+
+static void deliver_miss_returns() {
+    for (auto it = miss_returns.begin(); it != miss_returns.end();) {
+        if (it->fu_done && miss_return_ready(*it, sim_now())) {
+            if (sim_config.cdbs > 0) {
+                cdb_requests.push_back({it->rob_idx, cdb_class_rank[POOL_LOAD], nullptr, nullptr});
+                ++it;
+                continue;
+            }
+            cdb_list.push_back(CDB{it->rob_idx, *rob[it->rob_idx].result});
+            rob[it->rob_idx].state = InstructionState::EXECUTED;
+            it = miss_returns.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// 冲刷 ROB 中年龄（距队头的位置）不小于 age 的所有指令，从 refetch_idx 重新取指；
+// age 可以等于 rob_count，即不冲刷任何指令只重定向。返回冲刷的条数
+static int squash_from(int age, size_t refetch_idx) {
+    bool squashed[ROB_SIZE] = {false};
+    int first_lsq = -1;
+    int rob_idx = (rob_head + age) % ROB_SIZE;
+    int n = rob_count - age;
+    for (int k = 0; k < n; ++k) {
+        int i = (rob_idx + k) % ROB_SIZE;
+        squashed[i] = true;
+        if (first_lsq == -1 && rob[i].lsq_idx != -1) first_lsq = rob[i].lsq_idx;
+    }
+    for (auto& pool : rs_pools) {
+        for (int i = pool.busy.next(0); i >= 0; i = pool.busy.next(i + 1)) {
+            if (squashed[pool.rs[i].ROB_idx]) {
+                pool.rs[i].clear();
+                pool.release(i);
+            }
+        }
+    }
+
+    auto squash_fus = [&](auto& arr) {
+        for (auto& fu : arr) {
+            if (fu.busy && squashed[fu.rob_idx]) fu.clear();
+        }
+    };
+    squash_fus(int_alu_fus);
+    squash_fus(int_muldiv_fu);
+    squash_fus(load_fus);
+    squash_fus(store_fus);
+    squash_fus(fp_add_fus);
+    squash_fus(fp_mul_fus);
+    squash_fus(fp_div_fu);
+    squash_fus(fp_fma_fus);
+    squash_fus(vec_fus);
+    squash_fus(vec_mem_fus);
+
+    miss_returns.erase(std::remove_if(miss_returns.begin(), miss_returns.end(), [&](const MissReturn& m) {
+        return squashed[m.rob_idx];
+    }), miss_returns.end());
+    cdb_requests.erase(std::remove_if(cdb_requests.begin(), cdb_requests.end(), [&](const CdbRequest& r) {
+        return squashed[r.rob_idx];
+    }), cdb_requests.end());
+
+    // 本周期已产生但尚未广播的结果
+    cdb_list.erase(std::remove_if(cdb_list.begin(), cdb_list.end(), [&](const CDB& c) {
+        return squashed[c.producer];
+    }), cdb_list.end());
+
+    // LSQ 与 ROB 一样按程序序分配，直接回退队尾
+    if (first_lsq != -1) {
+        while (lsq_tail != first_lsq) {
+            lsq_tail = (lsq_tail - 1 + LSQ_SIZE) % LSQ_SIZE;
+            lsq[lsq_tail] = LSQEntry{};
+            lsq_count--;
+        }
+    }
+    if (prf_mode()) prf_recover(squashed);
+    for (int k = 0; k < n; ++k) {
+        rob[(rob_idx + k) % ROB_SIZE] = ROBEntry{};
+        rob_move_wait.reset((rob_idx + k) % ROB_SIZE);
+    }
+    rob_tail = rob_idx;
+    rob_count -= n;
+
+    // 按剩余 ROB 条目重建寄存器状态表（最年轻的写者生效）
+    for (int i = 0; i < 32; ++i) {
+        regs_int_status[i] = NO_TAG;
+        regs_fp_status[i] = NO_TAG;
+        regs_vec_status[i] = NO_TAG;
+    }
+    vec_vl_status = NO_TAG;
+    for (int k = 0; k < rob_count; ++k) {
+        int i = (rob_head + k) % ROB_SIZE;
+        std::visit([&](const auto& dest_reg) {
+            using T = std::decay_t<decltype(dest_reg)>;
+            if (prf_mode() && !std::is_same_v<T, VecReg>) return;
+            if constexpr (std::is_same_v<T, IntReg>) {
+                regs_int_status[dest_reg.idx] = i;
+            } else if constexpr (std::is_same_v<T, FpReg>) {
+                regs_fp_status[dest_reg.idx] = i;
+            } else if constexpr (std::is_same_v<T, VecReg>) {
+                regs_vec_status[dest_reg.idx] = i;
+            }
+        }, rob[i].dest);
+        if (rob[i].op == OpType::VSETVLI) vec_vl_status = i;
+    }
+
+    // 被冲刷的分支不再阻塞取指
+    fetch_barrier = false;
+    next_fetch_branch = refetch_idx;
+    fetch_redirect = true;
+    return n;
+}
+
+// store 地址解析后检查更年轻、已执行且读了旧值的重叠 load；有则冲刷最老的那条
+static void check_load_violation(int store_lsq) {
+    const LSQEntry& st = lsq[store_lsq];
+    for (int k = lsq_age(store_lsq) + 1; k < lsq_count; ++k) {
+        const LSQEntry& e = lsq[(lsq_head + k) % LSQ_SIZE];
+        if (!e.valid || e.is_store || !e.executed || is_vec_load_op(e.op)) continue;
+        if (!mem_overlap(e.address, int_mem_width(e.op), st.address, int_mem_width(st.op))) continue;
+        // 数据转发自比该 store 更年轻的 store，读到的值仍正确
+        if (e.fwd_lsq != -1 && lsq_age(e.fwd_lsq) > lsq_age(store_lsq)) continue;
+
+        mem_dep_stats.violations++;
+        mdp_train(rob_instr[e.rob_idx].pc, rob_instr[st.rob_idx].pc);
+        // trace 驱动模式按记录序号重新取指
+        size_t refetch_idx = trace_active() ? rob_instr[e.rob_idx].seq : rob_instr[e.rob_idx].pc / 4;
+        mem_dep_stats.squashed += squash_from(rob_age(e.rob_idx), refetch_idx);
+        return;
+    }
+}
+
+// 向量指令：算术进 vec_rs，访存进 vec_mem_rs 并占用一个 LSQ 条目
+static bool issue_vector_instruction(const Instruction& instr, int rob_idx) {
+    bool is_mem = is_vec_load_op(instr.op) || is_vec_store_op(instr.op);
+    RsPool& pool = rs_pools[is_mem ? POOL_VMEM : POOL_VEC];
+    if (is_mem && lsq_count >= LSQ_SIZE) return false;
+
+    int rs_idx = pool.acquire();
+    if (rs_idx == -1) return false;
+
+    auto& rs = pool.rs[rs_idx];
+    rs.op = instr.op;
+    rs.ROB_idx = rob_idx;
+    rs.A = instr.imm;
+    rs.pc = instr.pc;
+
+    // Vj: vs1 / 标量 rs1 / fs1（访存时为基址）
+    if (instr.vs1 >= 0) {
+        capture_operand(regs_vec_status[instr.vs1], OperandValue(regs_vec[instr.vs1]), rs.Vj, rs.Qj);
+    } else if (instr.rs1 >= 0) {
+        read_int_source(instr.rs1, rs.Vj, rs.Qj, rs.Pj);
+    } else if (instr.fs1 >= 0) {
+        read_fp_source(instr.fs1, rs.Vj, rs.Qj, rs.Pj);
+    }
+
+    // Vk: vs2 / 跨步 rs2（unit-stride 固定为 8 字节）
+    if (instr.vs2 >= 0) {
+        capture_operand(regs_vec_status[instr.vs2], OperandValue(regs_vec[instr.vs2]), rs.Vk, rs.Qk);
+    } else if (instr.rs2 >= 0) {
+        read_int_source(instr.rs2, rs.Vk, rs.Qk, rs.Pk);
+    } else {
+        rs.Vk = OperandValue(static_cast<uint64_t>(sizeof(uint64_t)));
+    }
+
+    // Vr: 乘加的累加源 vd / store 的数据 vs3
+    if (is_vec_macc_op(instr.op)) {
+        capture_operand(regs_vec_status[instr.vd], OperandValue(regs_vec[instr.vd]), rs.Vr, rs.Qr);
+    } else if (instr.vs3 >= 0) {
+        capture_operand(regs_vec_status[instr.vs3], OperandValue(regs_vec[instr.vs3]), rs.Vr, rs.Qr);
+    }
+
+    capture_operand(vec_vl_status, OperandValue(vec_vl), rs.Vvl, rs.Qvl);
+    pool.update_ready(rs_idx);
+
+    if (is_mem) {
+        int lsq_idx = lsq_tail;
+        lsq[lsq_idx] = LSQEntry{};
+        lsq[lsq_idx].valid = true;
+        lsq[lsq_idx].is_store = is_vec_store_op(instr.op);
+        lsq[lsq_idx].op = instr.op;
+        lsq[lsq_idx].rob_idx = rob_idx;
+        lsq[lsq_idx].dest = get_dest_reg_from_instruction(instr);
+        rob[rob_idx].lsq_idx = lsq_idx;
+        lsq_tail = (lsq_tail + 1) % LSQ_SIZE;
+        lsq_count++;
+    }
+    return true;
+}
+
+// --- 重命名时消除的习语 ---
+enum class Idiom { NONE, MOVE, FP_MOVE, ZERO, NOP };
+
+// 识别 move（结果等于某个源寄存器）、零习语（结果恒为 0）与写 x0 的 nop
+static Idiom classify_idiom(const Instruction& instr, int& src) {
+    if (instr.fusion != FusionKind::NONE) return Idiom::NONE;
+    Idiom kind = Idiom::NONE;
+    switch (instr.op) {
+        case OpType::ADDI:
+        case OpType::ORI:
+        case OpType::XORI:
+            if (instr.imm == 0) { kind = Idiom::MOVE; src = instr.rs1; }
+            break;
+        case OpType::ANDI:
+            if (instr.imm == 0) kind = Idiom::ZERO;
+            break;
+        case OpType::ADD:
+        case OpType::OR:
+        case OpType::XOR:
+            if (instr.op == OpType::XOR && instr.rs1 == instr.rs2) kind = Idiom::ZERO;
+            else if (instr.rs2 == 0) { kind = Idiom::MOVE; src = instr.rs1; }
+            else if (instr.rs1 == 0) { kind = Idiom::MOVE; src = instr.rs2; }
+            break;
+        case OpType::SUB:
+            if (instr.rs1 == instr.rs2) kind = Idiom::ZERO;
+            else if (instr.rs2 == 0) { kind = Idiom::MOVE; src = instr.rs1; }
+            break;
+        case OpType::AND:
+            if (instr.rs1 == 0 || instr.rs2 == 0) kind = Idiom::ZERO;
+            break;
+        case OpType::LUI:
+            if (instr.imm == 0) kind = Idiom::ZERO;
+            break;
+        case OpType::FSGNJ_D:
+            // fmv.d fd, fs = fsgnj.d fd, fs, fs
+            if (instr.fs1 == instr.fs2) { kind = Idiom::FP_MOVE; src = instr.fs1; }
+            break;
+        default:
+            break;
+    }
+    if (kind == Idiom::MOVE && src == 0) kind = Idiom::ZERO;
+    if (kind != Idiom::NONE && kind != Idiom::FP_MOVE && instr.rd <= 0) kind = Idiom::NOP;
+    return kind;
+}
+
+// 不占 RS / FU 完成习语：ROB 模式下直接写结果或等待源的生产者广播；PRF 模式下只改映射
+static void eliminate_idiom(Idiom kind, int src, int rob_idx) {
+    ROBEntry& entry = rob[rob_idx];
+    entry.eliminated = true;
+    entry.state = InstructionState::EXECUTED;
+
+    if (kind == Idiom::NOP) {
+        rename_stats.nops_eliminated++;
+        return;
+    }
+    if (kind == Idiom::ZERO) {
+        rename_stats.zeros_eliminated++;
+        if (prf_mode()) prf_alias(entry.dest, rename_int[0], entry.old_phys);
+        else entry.result = OperandValue(0ULL);
+        entry.phys_dest = prf_mode() ? rename_int[0] : -1;
+        return;
+    }
+
+    rename_stats.moves_eliminated++;
+    bool is_fp = (kind == Idiom::FP_MOVE);
+    if (prf_mode()) {
+        entry.phys_dest = is_fp ? rename_fp[src] : rename_int[src];
+        prf_alias(entry.dest, entry.phys_dest, entry.old_phys);
+        return;
+    }
+    std::optional<OperandValue> value;
+    int producer = NO_TAG;
+    if (is_fp) capture_operand(regs_fp_status[src], OperandValue(regs_fp[src]), value, producer);
+    else capture_operand(regs_int_status[src], OperandValue(regs_int[src]), value, producer);
+    if (value) {
+        entry.result = value;
+    } else {
+        entry.move_src = producer;
+        rob_move_wait.set(rob_idx);
+        entry.state = InstructionState::ISSUED;
+    }
+}
+
+// 宏融合指令的第二个操作及其另一个源（寄存器或立即数）放入 RS
+static void read_fused_source(const Instruction& instr, ReservationStation& rs) {
+    if (instr.fused_op == OpType::UNKNOWN) return;
+    rs.post_op = instr.fused_op;
+    if (instr.fused_rs >= 0) {
+        read_int_source(instr.fused_rs, rs.Vr, rs.Qr, rs.Pr);
+    } else {
+        rs.Vr = OperandValue(static_cast<uint64_t>(static_cast<int64_t>(instr.fused_imm)));
+    }
+}
+
 bool issue_instruction(const Instruction& instr) {
+    if (instr.op == OpType::UNKNOWN) {
+        throw std::runtime_error("Unsupported instruction at pc=" + std::to_string(instr.pc) +
+                                 " (raw=" + std::to_string(instr.raw) + ")");
+    }
     if (rob_count >= ROB_SIZE) return false;
+    // PRF 模式：目的寄存器没有空闲物理寄存器时停顿
+    int probe_src = -1;
+    bool needs_phys = !(sim_config.move_elim && classify_idiom(instr, probe_src) != Idiom::NONE);
+    if (prf_mode() && needs_phys && !prf_can_allocate(get_dest_reg_from_instruction(instr))) {
+        prf_stats.rename_stalls++;
+        return false;
+    }
 
     int rob_idx = rob_tail;
     rob[rob_idx] = ROBEntry{
         .busy = true,
         .op = instr.op,
         .dest = get_dest_reg_from_instruction(instr),
-        .is_load = is_load_op(instr.op),
-        .is_store = is_store_op(instr.op),
+        .is_load = is_load_op(instr.op) || is_vec_load_op(instr.op),
+        .is_store = is_store_op(instr.op) || is_vec_store_op(instr.op),
         .state = InstructionState::ISSUED,
-        .lsq_idx = -1,
-        .instr = instr
+        .lsq_idx = -1
     };
+    rob_instr[rob_idx] = instr;
 
     bool issued = false;
+    int idiom_src = -1;
+    Idiom idiom = sim_config.move_elim ? classify_idiom(instr, idiom_src) : Idiom::NONE;
 
+    // --- 重命名时消除的 move / 零习语 ---
+    if (idiom != Idiom::NONE) {
+        eliminate_idiom(idiom, idiom_src, rob_idx);
+        issued = true;
+    }
+    // --- 向量指令 ---
+    else if (is_vec_op(instr.op)) {
+        issued = issue_vector_instruction(instr, rob_idx);
+    }
     // --- ALU 指令 ---
-    if (!is_load_op(instr.op) && !is_store_op(instr.op)) {
-        ReservationStation* target_rs = nullptr;
-        int rs_size = 0;
+    else if (!is_load_op(instr.op) && !is_store_op(instr.op)) {
+        RsPool* pool = nullptr;
         if (is_alu_op(instr.op)) {
-            target_rs = intalu_rs;
-            rs_size = NUM_INTALU_RS;
+            pool = &rs_pools[POOL_INTALU];
         } else if (is_muldiv_op(instr.op)) {
-            target_rs = muldiv_rs;
-            rs_size = NUM_MULDIV_RS;
+            pool = &rs_pools[POOL_MULDIV];
         } else if (is_fp_add_op(instr.op)) {
-            target_rs = fpadd_rs;
-            rs_size = NUM_FPADD_RS;
+            pool = &rs_pools[POOL_FPADD];
         } else if (is_fp_mul_op(instr.op)) {
-            target_rs = fpmul_rs;
-            rs_size = NUM_FPMUL_RS;
+            pool = &rs_pools[POOL_FPMUL];
         } else if (is_fp_div_op(instr.op)) {
-            target_rs = fpdiv_rs;
-            rs_size = NUM_FPDIV_RS;
-        }
-
-        if (target_rs) {
-            for (int i = 0; i < rs_size; ++i) {
-                if (!target_rs[i].busy) {
-                    target_rs[i].clear();
-                    target_rs[i].busy = true;
-                    target_rs[i].op = instr.op;
-                    target_rs[i].ROB_idx = rob_idx;
-                    target_rs[i].A = instr.imm;
-
-                    // rs1 → Vj/Qj
-                    if (instr.rs1 >= 0) {
-                        IntReg src_reg(instr.rs1);
-                        if (regs_int_status[src_reg.idx] == "") {
-                            target_rs[i].Vj = OperandValue(regs_int[src_reg.idx]);
-                        } else {
-                            int dep_rob_idx = get_rob_index(regs_int_status[src_reg.idx]);
-                            if (dep_rob_idx >= 0 && rob[dep_rob_idx].state == InstructionState::EXECUTED) {
-                                target_rs[i].Vj = rob[dep_rob_idx].result;
-                            } else {
-                                target_rs[i].Qj = regs_int_status[src_reg.idx];
-                            }
-                        }
-                    } else if (instr.fs1 >= 0) {
-                        FpReg src_reg(instr.fs1);
-                        if (regs_fp_status[src_reg.idx] == "") {
-                            target_rs[i].Vj = OperandValue(regs_fp[src_reg.idx]);
-                        } else {
-                            int dep_rob_idx = get_rob_index(regs_fp_status[src_reg.idx]);
-                            if (dep_rob_idx >= 0 && rob[dep_rob_idx].state == InstructionState::EXECUTED) {
-                                target_rs[i].Vj = rob[dep_rob_idx].result;
-                            } else {
-                                target_rs[i].Qj = regs_fp_status[src_reg.idx];
-                            }
-                        }
-                    }
+            pool = &rs_pools[POOL_FPDIV];
+        } else if (is_fp_fma_op(instr.op)) {
+            pool = &rs_pools[POOL_FPFMA];
+        }
 
-                    // rs2 or imm → Vk/Qk
-                    if (instr.rs2 >= 0) {
-                        IntReg src_reg(instr.rs2);
-                        if (regs_int_status[src_reg.idx] == "") {
-                            target_rs[i].Vk = OperandValue(regs_int[src_reg.idx]);
-                        } else {
-                            int dep_rob_idx = get_rob_index(regs_int_status[src_reg.idx]);
-                            if (dep_rob_idx >= 0 && rob[dep_rob_idx].state == InstructionState::EXECUTED) {
-                                target_rs[i].Vk = rob[dep_rob_idx].result;
-                            } else {
-                                target_rs[i].Qk = regs_int_status[src_reg.idx];
-                            }
-                        }
-                    } else if (instr.fs2 >= 0) {
-                        FpReg src_reg(instr.fs2);
-                        if (regs_fp_status[src_reg.idx] == "") {
-                            target_rs[i].Vk = OperandValue(regs_fp[src_reg.idx]);
-                        } else {
-                            int dep_rob_idx = get_rob_index(regs_fp_status[src_reg.idx]);
-                            if (dep_rob_idx >= 0 && rob[dep_rob_idx].state == InstructionState::EXECUTED) {
-                                target_rs[i].Vk = rob[dep_rob_idx].result;
-                            } else {
-                                target_rs[i].Qk = regs_fp_status[src_reg.idx];
-                            }
-                        }
-                    } else {
-                        // I-type: use immediate
-                        target_rs[i].Vk = OperandValue(static_cast<uint64_t>(static_cast<int64_t>(instr.imm)));
-                    }
+        int i = pool ? pool->acquire() : -1;
+        if (i >= 0) {
+            ReservationStation* target_rs = pool->rs;
+            target_rs[i].op = instr.op;
+            target_rs[i].ROB_idx = rob_idx;
+            target_rs[i].A = instr.imm;
+            target_rs[i].pc = instr.pc;
+
+            // rs1 → Vj/Qj
+            if (instr.rs1 >= 0) {
+                read_int_source(instr.rs1, target_rs[i].Vj, target_rs[i].Qj, target_rs[i].Pj);
+            } else if (instr.fs1 >= 0) {
+                read_fp_source(instr.fs1, target_rs[i].Vj, target_rs[i].Qj, target_rs[i].Pj);
+            } else {
+                // LUI / AUIPC / JAL 没有 rs1
+                target_rs[i].Vj = OperandValue(0ULL);
+            }
 
-                    issued = true;
-                    break;
+            // rs2 or imm → Vk/Qk
+            if (instr.rs2 >= 0) {
+                read_int_source(instr.rs2, target_rs[i].Vk, target_rs[i].Qk, target_rs[i].Pk);
+            } else if (instr.fs2 >= 0) {
+                read_fp_source(instr.fs2, target_rs[i].Vk, target_rs[i].Qk, target_rs[i].Pk);
+            } else {
+                // I-type: use immediate
+                target_rs[i].Vk = OperandValue(static_cast<uint64_t>(static_cast<int64_t>(instr.imm)));
+            }
+
+            // fs3 → Vr/Qr（融合乘加的加数）
+            if (instr.fs3 >= 0) {
+                read_fp_source(instr.fs3, target_rs[i].Vr, target_rs[i].Qr, target_rs[i].Pr);
+            }
+            read_fused_source(instr, target_rs[i]);
+
+            // vsetvli rs1=x0：rd!=x0 时 AVL 取 VLMAX，rd=x0 时保持当前 vl
+            if (instr.op == OpType::VSETVLI && instr.rs1 == 0) {
+                target_rs[i].Qj = NO_TAG;
+                target_rs[i].Pj = -1;
+                if (instr.rd != 0) {
+                    target_rs[i].Vj = OperandValue(static_cast<uint64_t>(VLMAX));
+                } else {
+                    capture_operand(vec_vl_status, OperandValue(vec_vl), target_rs[i].Vj, target_rs[i].Qj);
                 }
             }
+
+            pool->update_ready(i);
+            issued = true;
         }
     }
     // --- Load 指令 ---
     else if (is_load_op(instr.op)) {
         if (lsq_count >= LSQ_SIZE) return false;
 
-        int rs_idx = -1;
-        for (int i = 0; i < NUM_LOAD_RS; ++i) {
-            if (!load_rs[i].busy) {
-                rs_idx = i;
-                break;
-            }
-        }
+        RsPool& pool = rs_pools[POOL_LOAD];
+        int rs_idx = pool.acquire();
         if (rs_idx == -1) return false;
 
         int lsq_idx = lsq_tail;
@@ -438,36 +1354,26 @@ bool issue_instruction(const Instruction& instr) {
         rob[rob_idx].lsq_idx = lsq_idx;
 
         auto& rs = load_rs[rs_idx];
-        rs.busy = true;
         rs.op = instr.op;
         rs.ROB_idx = rob_idx;
         rs.A = instr.imm;
+        rs.pc = instr.pc;
+        if (sim_config.mem_dep == "store_set") {
+            int st = mdp_lookup_load(instr.pc);
+            if (st >= 0 && rob[st].busy && rob[st].is_store && st != rob_idx &&
+                !lsq[rob[st].lsq_idx].addr_ready) {
+                rs.Qst = st;
+                mem_dep_stats.predicted_waits++;
+            }
+        }
 
         if (instr.rs1 >= 0) {
-            IntReg src_reg(instr.rs1);
-            if (regs_int_status[src_reg.idx] == "") {
-                rs.Vj = OperandValue(regs_int[src_reg.idx]);
-            } else {
-                int dep_rob_idx = get_rob_index(regs_int_status[src_reg.idx]);
-                if (dep_rob_idx >= 0 && rob[dep_rob_idx].state == InstructionState::EXECUTED) {
-                    rs.Vj = rob[dep_rob_idx].result;
-                } else {
-                    rs.Qj = regs_int_status[src_reg.idx];
-                }
-            }
+            read_int_source(instr.rs1, rs.Vj, rs.Qj, rs.Pj);
         } else if (instr.fs1 >= 0) {
-            FpReg src_reg(instr.fs1);
-            if (regs_fp_status[src_reg.idx] == "") {
-                rs.Vj = OperandValue(regs_fp[src_reg.idx]);
-            } else {
-                int dep_rob_idx = get_rob_index(regs_fp_status[src_reg.idx]);
-                if (dep_rob_idx >= 0 && rob[dep_rob_idx].state == InstructionState::EXECUTED) {
-                    rs.Vj = rob[dep_rob_idx].result;
-                } else {
-                    rs.Qj = regs_fp_status[src_reg.idx];
-                }
-            }
+            read_fp_source(instr.fs1, rs.Vj, rs.Qj, rs.Pj);
         }
+        read_fused_source(instr, rs);
+        pool.update_ready(rs_idx);
 
         lsq_tail = (lsq_tail + 1) % LSQ_SIZE;
         lsq_count++;
@@ -477,13 +1383,8 @@ bool issue_instruction(const Instruction& instr) {
     else if (is_store_op(instr.op)) {
         if (lsq_count >= LSQ_SIZE) return false;
 
-        int rs_idx = -1;
-        for (int i = 0; i < NUM_STORE_RS; ++i) {
-            if (!store_rs[i].busy) {
-                rs_idx = i;
-                break;
-            }
-        }
+        RsPool& pool = rs_pools[POOL_STORE];
+        int rs_idx = pool.acquire();
         if (rs_idx == -1) return false;
 
         int lsq_idx = lsq_tail;
@@ -496,221 +1397,461 @@ bool issue_instruction(const Instruction& instr) {
         rob[rob_idx].lsq_idx = lsq_idx;
 
         auto& rs = store_rs[rs_idx];
-        rs.busy = true;
         rs.op = instr.op;
         rs.ROB_idx = rob_idx;
         rs.A = instr.imm;
+        rs.pc = instr.pc;
+        if (sim_config.mem_dep == "store_set") mdp_record_store(instr.pc, rob_idx);
 
         if (instr.rs1 >= 0) {
-            IntReg src_reg(instr.rs1);
-            if (regs_int_status[src_reg.idx] == "") {
-                rs.Vj = OperandValue(regs_int[src_reg.idx]);
-            } else {
-                int dep_rob_idx = get_rob_index(regs_int_status[src_reg.idx]);
-                if (dep_rob_idx >= 0 && rob[dep_rob_idx].state == InstructionState::EXECUTED) {
-                    rs.Vj = rob[dep_rob_idx].result;
-                } else {
-                    rs.Qj = regs_int_status[src_reg.idx];
-                }
-            }
+            read_int_source(instr.rs1, rs.Vj, rs.Qj, rs.Pj);
         } else if (instr.fs1 >= 0) {
-            FpReg src_reg(instr.fs1);
-            if (regs_fp_status[src_reg.idx] == "") {
-                rs.Vj = OperandValue(regs_fp[src_reg.idx]);
-            } else {
-                int dep_rob_idx = get_rob_index(regs_fp_status[src_reg.idx]);
-                if (dep_rob_idx >= 0 && rob[dep_rob_idx].state == InstructionState::EXECUTED) {
-                    rs.Vj = rob[dep_rob_idx].result;
-                } else {
-                    rs.Qj = regs_fp_status[src_reg.idx];
-                }
-            }
+            read_fp_source(instr.fs1, rs.Vj, rs.Qj, rs.Pj);
         }
 
         if (instr.rs2 >= 0) {
-            IntReg data_reg(instr.rs2);
-            if (regs_int_status[data_reg.idx] == "") {
-                rs.Vk = OperandValue(regs_int[data_reg.idx]);
-            } else {
-                int dep_rob_idx = get_rob_index(regs_int_status[data_reg.idx]);
-                if (dep_rob_idx >= 0 && rob[dep_rob_idx].state == InstructionState::EXECUTED) {
-                    rs.Vk = rob[dep_rob_idx].result;
-                } else {
-                    rs.Qk = regs_int_status[data_reg.idx];
-                }
-            }
+            read_int_source(instr.rs2, rs.Vk, rs.Qk, rs.Pk);
         } else if (instr.fs2 >= 0) {
-            FpReg data_reg(instr.fs2);
-            if (regs_fp_status[data_reg.idx] == "") {
-                rs.Vk = OperandValue(regs_fp[data_reg.idx]);
-            } else {
-                int dep_rob_idx = get_rob_index(regs_fp_status[data_reg.idx]);
-                if (dep_rob_idx >= 0 && rob[dep_rob_idx].state == InstructionState::EXECUTED) {
-                    rs.Vk = rob[dep_rob_idx].result;
-                } else {
-                    rs.Qk = regs_fp_status[data_reg.idx];
-                }
-            }
+            read_fp_source(instr.fs2, rs.Vk, rs.Qk, rs.Pk);
         }
+        pool.update_ready(rs_idx);
 
         lsq_tail = (lsq_tail + 1) % LSQ_SIZE;
         lsq_count++;
         issued = true;
     }
 
+    if (!issued) return false;
+
+    // PRF 模式下整数 / 浮点目的寄存器改为分配物理寄存器，不写 ROB 标签
+    if (prf_mode() && !rob[rob_idx].eliminated) {
+        rob[rob_idx].phys_dest = prf_allocate(rob[rob_idx].dest, rob[rob_idx].old_phys);
+    }
     std::visit([&](const auto& dest_reg) {
         using T = std::decay_t<decltype(dest_reg)>;
+        if (prf_mode() && !std::is_same_v<T, VecReg>) return;
         if constexpr (std::is_same_v<T, IntReg>) {
-            regs_int_status[dest_reg.idx] = "ROB" + std::to_string(rob_idx);
+            regs_int_status[dest_reg.idx] = rob_idx;
         } else if constexpr (std::is_same_v<T, FpReg>) {
-            regs_fp_status[dest_reg.idx] = "ROB" + std::to_string(rob_idx);
+            regs_fp_status[dest_reg.idx] = rob_idx;
+        } else if constexpr (std::is_same_v<T, VecReg>) {
+            regs_vec_status[dest_reg.idx] = rob_idx;
         }
     }, rob[rob_idx].dest);
+    if (instr.op == OpType::VSETVLI) {
+        vec_vl_status = rob_idx;
+    }
+    energy_stats.rob_writes++;
+    if (!rob[rob_idx].eliminated) energy_stats.rs_writes++;
+    critpath_on_issue(rob_idx, instr);
+    rob_tail = (rob_tail + 1) % ROB_SIZE;
+    rob_count++;
+    return true;
+}
+
+// FU 算完后的收尾：写 ROB / LSQ、产生 CDB 广播、分支重定向，释放 RS 与 FU
+static void complete_fu(FunctionalUnit& fu, RsPool& pool) {
+    const std::string& rs_type_base = pool.type;
+    // 执行完成！
+    bool is_store = (rs_type_base == "STORE");
+    bool is_load  = (rs_type_base == "LOAD");
+
+    // 获取对应的 RS
+    ReservationStation* rs = fu.rs_idx >= 0 ? &pool.rs[fu.rs_idx] : nullptr;
+
+    if (is_load) {
+        // Load: 地址 = v1 + A（但 A 存在 RS 中！）
+        // 所以我们仍需从 RS 读取 A
+        if (rs && rs->busy) {
+            uint64_t addr = mem_address(fu.rob_idx, to_int(fu.v1), rs->A);
+            int lsq_idx = rob[fu.rob_idx].lsq_idx;
+            int width = int_mem_width(rs->op);
+            uint64_t raw;
+            // 更老的重叠 store 尚未提交时直接转发其数据
+            if (forward_from_store(lsq_idx, width, addr, raw)) {
+                mem_dep_stats.forwarded++;
+            } else {
+                raw = read_mem(addr, width);
+            }
+            OperandValue result = loaded_value(rs->op, raw);
+            if (rs->post_op != OpType::UNKNOWN) result = execute_post_op(rs->post_op, result, fu.v3);
+            rob[fu.rob_idx].result = result;
+
+            lsq[lsq_idx].address = addr;
+            lsq[lsq_idx].addr_ready = true;
+            lsq[lsq_idx].executed = true;
+            auto miss = std::find_if(miss_returns.begin(), miss_returns.end(),
+                                     [&](const MissReturn& m) { return m.rob_idx == fu.rob_idx; });
+            if (miss != miss_returns.end() && !miss_return_ready(*miss, sim_now())) {
+                // 缺失未返回：释放 load 单元，由 deliver_miss_returns 广播
+                miss->fu_done = true;
+            } else {
+                if (miss != miss_returns.end()) miss_returns.erase(miss);
+                cdb_list.push_back(CDB{fu.rob_idx, result});
+                rob[fu.rob_idx].state = InstructionState::EXECUTED;
+            }
+        }
+    } else if (is_store) {
+        if (rs && rs->busy) {
+            uint64_t addr = mem_address(fu.rob_idx, to_int(fu.v1), rs->A);
+            int lsq_idx = rob[fu.rob_idx].lsq_idx;
+            lsq[lsq_idx].address = addr;
+            lsq[lsq_idx].addr_ready = true;
+            lsq[lsq_idx].data = fu.v2;
+            rob[fu.rob_idx].state = InstructionState::EXECUTED;
+            // 地址解析：检查推测执行的更年轻 load
+            pool.release(fu.rs_idx);
+            fu.busy = false;
+            check_load_violation(lsq_idx);
+            return;
+        }
+    } else if (rs_type_base == "VMEM") {
+        // 向量访存：地址 = rs1 + i * stride，load 在此读完所有元素，store 等提交时写
+        if (rs && rs->busy) {
+            uint64_t base = mem_address(fu.rob_idx, to_int(fu.v1), rs->A);
+            int64_t stride = vec_stride(fu.v2);
+            uint64_t vl = std::min<uint64_t>(fu.vl, VLMAX);
+            LSQEntry& lsq_entry = lsq[rob[fu.rob_idx].lsq_idx];
+            lsq_entry.address = base;
+            lsq_entry.addr_ready = true;
+            lsq_entry.stride = stride;
+            lsq_entry.vl = vl;
+            if (is_vec_load_op(rs->op)) {
+                VecData v;
+                v.e.fill(~0ULL);
+                for (uint64_t e = 0; e < vl; ++e) {
+                    v.e[e] = read_mem(base + e * stride, 8);
+                }
+                OperandValue result(v);
+                rob[fu.rob_idx].result = result;
+                cdb_list.push_back(CDB{fu.rob_idx, result});
+            } else {
+                lsq_entry.data = fu.v3;
+            }
+            rob[fu.rob_idx].state = InstructionState::EXECUTED;
+        }
+    } else {
+        // ALU / MUL / FP / VEC
+        OperandValue result = fu.compute_result();
+        if (rs->post_op != OpType::UNKNOWN) result = execute_post_op(rs->post_op, result, fu.v3);
+        rob[fu.rob_idx].result = result;
+        cdb_list.push_back(CDB{fu.rob_idx, result});
+        rob[fu.rob_idx].state = InstructionState::EXECUTED;
+
+        if (is_branch_op(rs->op) && rob_instr[fu.rob_idx].lb_predicted) {
+            // 循环缓冲已按跳转继续供指：预测正确无需动作，否则冲刷其后的指令，从下一条重新取指
+            if (to_int(result) != 1) {
+                frontend_stats.lb_exits++;
+                squash_from(rob_age(fu.rob_idx) + 1, rs->pc / 4 + 1);
+            }
+        }
+        else if (is_branch_op(rs->op)) {
+            // 条件分支：目标 = 分支自身 pc + imm；trace 驱动模式下取指已沿 trace 走，只解除阻塞
+            if (to_int(result) == 1 && !trace_active()) {
+                next_fetch_branch = (rs->pc + rs->A) / 4;
+                fetch_redirect = true;
+                loop_buffer_observe(rs->pc / 4, next_fetch_branch);
+            }
+            fetch_barrier = false;
+        }
+        else if (rs->op == OpType::JALR) {
+            // JALR: 目标地址 = (rs1 + imm) & ~1
+            uint64_t target_addr = (to_int(fu.v1) + rs->A) & ~1ULL;
+            next_fetch_branch = target_addr / 4; // 转换为指令索引
+            fetch_redirect = !trace_active();
+            fetch_barrier = false;
+        }
+    }
+
+    // 释放 RS
+    if (rs) {
+        pool.release(fu.rs_idx);
+    }
+
+    // 释放 FU
+    fu.busy = false;
+}
+
+static void cdb_request(FunctionalUnit& fu, RsPool& pool) {
+    cdb_requests.push_back({fu.rob_idx, cdb_class_rank[&pool - rs_pools], &fu, &pool});
+}
+
+// store 与向量 store 不写回；缺失未返回的 load 由 deliver_miss_returns 稍后广播
+static bool needs_cdb(const FunctionalUnit& fu, const RsPool& pool) {
+    if (pool.type == "STORE") return false;
+    if (pool.type == "VMEM") return is_vec_load_op(fu.op);
+    if (pool.type == "LOAD") {
+        auto miss = std::find_if(miss_returns.begin(), miss_returns.end(),
+                                 [&](const MissReturn& m) { return m.rob_idx == fu.rob_idx; });
+        return miss == miss_returns.end() || miss_return_ready(*miss, sim_now());
+    }
+    return true;
+}
+
+// 本周期最多 cdbs 个结果获得总线，其余保持等待到下一周期
+static void arbitrate_cdb() {
+    if (cdb_requests.empty()) return;
+    if (sim_config.cdb_priority == "oldest") {
+        std::sort(cdb_requests.begin(), cdb_requests.end(), [](const CdbRequest& a, const CdbRequest& b) {
+            return rob_age(a.rob_idx) < rob_age(b.rob_idx);
+        });
+    } else {
+        std::sort(cdb_requests.begin(), cdb_requests.end(), [](const CdbRequest& a, const CdbRequest& b) {
+            return a.cls != b.cls ? a.cls < b.cls : rob_age(a.rob_idx) < rob_age(b.rob_idx);
+        });
+    }
+    size_t granted = std::min(cdb_requests.size(), static_cast<size_t>(sim_config.cdbs));
+    for (size_t k = 0; k < granted; ++k) {
+        const CdbRequest& r = cdb_requests[k];
+        if (r.fu) {
+            r.fu->wb_wait = false;
+            complete_fu(*r.fu, *r.pool);
+        } else {
+            cdb_list.push_back(CDB{r.rob_idx, *rob[r.rob_idx].result});
+            rob[r.rob_idx].state = InstructionState::EXECUTED;
+            miss_returns.erase(std::find_if(miss_returns.begin(), miss_returns.end(),
+                                            [&](const MissReturn& m) { return m.rob_idx == r.rob_idx; }));
+        }
+    }
+    CdbStats& c = cdb_stats;
+    c.granted += granted;
+    c.denied += cdb_requests.size() - granted;
+    if (cdb_requests.size() > granted) c.saturated_cycles++;
+    c.requests_max = std::max<uint64_t>(c.requests_max, cdb_requests.size());
+    cdb_requests.clear();
+}
 
-    if (issued) {
-        rob_tail = (rob_tail + 1) % ROB_SIZE;
-        rob_count++;
-        return true;
+// 随机选择策略用的发生器，sim_init 时以固定种子复位，结果可复现
+static std::mt19937 select_rng;
+
+// 按池的选择策略排列就绪条目，返回条目数。最老优先：就绪条目中比 i 更老的个数即 i 的名次
+static int select_order(const RsPool& pool, int* order) {
+    int n = 0;
+    if (pool.select == SelectPolicy::OLDEST) {
+        n = pool.ready.count();
+        for (int i = pool.ready.next(0); i >= 0; i = pool.ready.next(i + 1)) {
+            order[(pool.older[i] & pool.ready).count()] = i;
+        }
+        return n;
     }
-    return false;
+    for (int i = pool.ready.next(0); i >= 0; i = pool.ready.next(i + 1)) order[n++] = i;
+    if (pool.select == SelectPolicy::RANDOM) std::shuffle(order, order + n, select_rng);
+    return n;
+}
+
+// 从就绪（最后一个源操作数到达）到发往 FU 的等待周期；就绪后的下一周期发出记为 0
+static void count_dispatch(const RsPool& pool, int idx) {
+    uint64_t now = sim_now();
+    uint64_t delay = now > pool.ready_at[idx] + 1 ? now - pool.ready_at[idx] - 1 : 0;
+    select_stats.dispatched++;
+    select_stats.delay_sum += delay;
+    if (delay > 0) select_stats.delayed++;
+    select_stats.delay_max = std::max(select_stats.delay_max, delay);
 }
 
 void executeFU() {
     cdb_list.clear();
+    deliver_miss_returns();
     // --- 启动新操作 ---
-    auto try_launch_to_fu = [&](auto& fu_array, const std::string& rs_type,
-                                int rs_size, ReservationStation* rs_array) {
-        for (int i = 0; i < rs_size; ++i) {
-            auto& rs = rs_array[i];
-            if (!rs.busy) continue;
-            if (!rs.Qj.empty()) continue;
-            if (rs_type != "LOAD" && (!rs.Qk.empty() || !rs.Vk)) continue;
+    // 只考虑就绪位图中的条目，按池的选择策略排序后依次尝试
+    auto try_launch_to_fu = [&](auto& fu_array, RsPool& pool) {
+        const std::string& rs_type = pool.type;
+        if (prf_mode()) {
+            for (int i = pool.busy.next(0); i >= 0; i = pool.busy.next(i + 1)) read_prf_operands(pool.rs[i]);
+        }
+        int order[RS_POOL_MAX];
+        int n = select_order(pool, order);
+        for (int k = 0; k < n; ++k) {
+            int i = order[k];
+            auto& rs = pool.rs[i];
 
-            if (rob[rs.ROB_idx].state >= InstructionState::EXECUTING) continue;
+            // load 相对更老 store 的顺序约束
+            bool speculative = false;
+            bool is_load_rs = rs_type == "LOAD" || (rs_type == "VMEM" && is_vec_load_op(rs.op));
+            if (is_load_rs && !load_may_launch(rs, speculative)) continue;
 
             // 找一个空闲 FU
             for (auto& fu : fu_array) {
                 if (!fu.busy) {
+                    // 非阻塞 L1D：缺失需要 MSHR，没有可用项时留在 RS 中
+                    if (rs_type == "LOAD" && !dcache_mshr_available(mem_address(rs.ROB_idx, to_int(*rs.Vj), rs.A), sim_now())) break;
                     OperandValue v1 = *rs.Vj;
                     OperandValue v2 = (rs_type == "LOAD") ? OperandValue(0.0) : *rs.Vk;
+                    OperandValue v3 = rs.Vr ? *rs.Vr : OperandValue{};
+                    uint64_t vl = rs.Vvl ? to_int(*rs.Vvl) : 0;
                     fu.clear();
-                    fu.start(rs.op, v1, v2, rs.ROB_idx, rs_type, i);
+                    fu.start(rs.op, v1, v2, rs.ROB_idx, rs_type, i, v3, vl);
+                    fu.pc = rs.pc;
+                    energy_count_fu_op(rs_type);
+                    if (speculative) mem_dep_stats.speculative++;
+                    // 地址在发往 FU 时已知：访问 L1D，缺失则延长访存延迟
+                    if (rs_type == "LOAD") {
+                        uint64_t addr = mem_address(rs.ROB_idx, to_int(v1), rs.A);
+                        uint64_t req = 0;
+                        int extra = dcache_load_access(rs.pc, addr, sim_now(), &req);
+                        if ((extra > 0 || req) && dcache_nonblocking()) {
+                            dcache_mshr_allocate(addr);
+                            MissReturn m{rs.ROB_idx, sim_now(), sim_now() + extra, {}, fu.remaining_cycles};
+                            if (req) m.mem_wait.push_back(req);
+                            miss_returns.push_back(std::move(m));
+                        } else {
+                            fu.remaining_cycles += extra;
+                            if (req) fu.mem_wait.push_back(req);
+                        }
+                    } else if (rs_type == "VMEM" && is_vec_load_op(rs.op)) {
+                        uint64_t base = mem_address(rs.ROB_idx, to_int(v1), rs.A);
+                        int64_t stride = vec_stride(v2);
+                        int extra = 0;
+                        for (uint64_t e = 0; e < std::min<uint64_t>(vl, VLMAX); ++e) {
+                            uint64_t req = 0;
+                            extra = std::max(extra, dcache_load_access(rs.pc, base + e * stride, sim_now(), &req));
+                            if (req) fu.mem_wait.push_back(req);
+                        }
+                        fu.remaining_cycles += extra;
+                    }
                     rob[rs.ROB_idx].state = InstructionState::EXECUTING;
+                    count_dispatch(pool, i);
+                    pool.ready.reset(i);
                     break;
                 }
             }
         }
     };
 
-    try_launch_to_fu(int_alu_fus, "INTALU", NUM_INTALU_RS, intalu_rs);
-    try_launch_to_fu(int_muldiv_fu, "MULDIV", NUM_MULDIV_RS, muldiv_rs);
-    try_launch_to_fu(load_fus, "LOAD", NUM_LOAD_RS, load_rs);
-    try_launch_to_fu(store_fus, "STORE", NUM_STORE_RS, store_rs);
-    try_launch_to_fu(fp_add_fus, "FPADD", NUM_FPADD_RS, fpadd_rs);
-    try_launch_to_fu(fp_mul_fus, "FPMUL", NUM_FPMUL_RS, fpmul_rs);
-    try_launch_to_fu(fp_div_fu, "FPDIV", NUM_FPDIV_RS, fpdiv_rs);
-
-    auto process_fu_array = [&](auto& fu_array, const std::string& rs_type_base) {
+    try_launch_to_fu(int_alu_fus, rs_pools[POOL_INTALU]);
+    try_launch_to_fu(int_muldiv_fu, rs_pools[POOL_MULDIV]);
+    try_launch_to_fu(load_fus, rs_pools[POOL_LOAD]);
+    try_launch_to_fu(store_fus, rs_pools[POOL_STORE]);
+    try_launch_to_fu(fp_add_fus, rs_pools[POOL_FPADD]);
+    try_launch_to_fu(fp_mul_fus, rs_pools[POOL_FPMUL]);
+    try_launch_to_fu(fp_div_fu, rs_pools[POOL_FPDIV]);
+    try_launch_to_fu(fp_fma_fus, rs_pools[POOL_FPFMA]);
+    try_launch_to_fu(vec_fus, rs_pools[POOL_VEC]);
+    try_launch_to_fu(vec_mem_fus, rs_pools[POOL_VMEM]);
+
+    auto process_fu_array = [&](auto& fu_array, RsPool& pool) {
         for (auto& fu : fu_array) {
             if (!fu.busy) continue;
+            if (fu.wb_wait) {
+                cdb_request(fu, pool);
+                continue;
+            }
+            if (!fu.mem_wait.empty()) {
+                // 数据还在 DRAM 中：返回后才开始计基本访存延迟
+                if (!dram_ready(fu.mem_wait, sim_now())) continue;
+                fu.mem_wait.clear();
+            }
 
             fu.remaining_cycles--;
             if (fu.remaining_cycles == 0) {
-                // 执行完成！
-                bool is_store = (rs_type_base == "STORE");
-                bool is_load  = (rs_type_base == "LOAD");
-
-                // 获取对应的 RS
-                auto get_rs_ptr = [&](int idx) -> ReservationStation* {
-                    if (rs_type_base == "INTALU") return &intalu_rs[idx];
-                    if (rs_type_base == "MULDIV") return &muldiv_rs[idx];
-                    if (rs_type_base == "LOAD") return &load_rs[idx];
-                    if (rs_type_base == "STORE") return &store_rs[idx];
-                    if (rs_type_base == "FPADD") return &fpadd_rs[idx];
-                    if (rs_type_base == "FPMUL") return &fpmul_rs[idx];
-                    if (rs_type_base == "FPDIV") return &fpdiv_rs[idx];
-                    return nullptr;
-                };
-
-                ReservationStation* rs = get_rs_ptr(fu.rs_idx);
-
-                if (is_load) {
-                    // Load: 地址 = v1 + A（但 A 存在 RS 中！）
-                    // 所以我们仍需从 RS 读取 A
-                    if (rs && rs->busy) {
-                        uint64_t addr = to_int(fu.v1) + rs->A;
-                        OperandValue result;
-                        if (rs->op == OpType::LW || rs->op == OpType::LD) {
-                            result = OperandValue(memory_int.count(addr) ? memory_int[addr] : 0ULL);
-                        } else {
-                            result = OperandValue(memory_fp.count(addr) ? memory_fp[addr] : 0.0);
-                        }
-                        rob[fu.rob_idx].result = result;
-
-                        if (rob[fu.rob_idx].lsq_idx != -1) {
-                            lsq[rob[fu.rob_idx].lsq_idx].address = addr;
-                            lsq[rob[fu.rob_idx].lsq_idx].addr_ready = true;
-                        }
-                        std::string rob_tag = "ROB" + std::to_string(fu.rob_idx);
-                        cdb_list.push_back(CDB{rob_tag, result});
-                        rob[fu.rob_idx].state = InstructionState::EXECUTED;
-                    }
-                } else if (is_store) {
-                    if (rs && rs->busy) {
-                        uint64_t addr = to_int(fu.v1) + rs->A;
-                        if (rob[fu.rob_idx].lsq_idx != -1) {
-                            lsq[rob[fu.rob_idx].lsq_idx].address = addr;
-                            lsq[rob[fu.rob_idx].lsq_idx].addr_ready = true;
-                            lsq[rob[fu.rob_idx].lsq_idx].data = fu.v2;
-                        }
-                        rob[fu.rob_idx].state = InstructionState::EXECUTED;
-                    }
-                } else {
-                    // ALU / MUL / FP
-                    OperandValue result = fu.compute_result();
-                    rob[fu.rob_idx].result = result;
-                    std::string rob_tag = "ROB" + std::to_string(fu.rob_idx);
-                    cdb_list.push_back(CDB{rob_tag, result});
-                    rob[fu.rob_idx].state = InstructionState::EXECUTED;
-
-                    if (rs->op == OpType::BNE) {
-                        // BNE: 跳转偏移 = imm / 2 (RISC-V 规范)
-                        uint64_t sign = to_int(result);
-                        if(sign == 1)
-                            next_fetch_branch = next_fetch_idx - 1 + int64_t(rs->A / 4);
-                    }
-                    else if (rs->op == OpType::JALR) {
-                        // JALR: 目标地址 = rs1 + imm
-                        uint64_t rs1_val = to_int(result);
-                        uint64_t target_addr = rs1_val + rs->A;
-                        next_fetch_branch = target_addr / 4; // 转换为指令索引
-                    }
+                // 总线数有限时，要广播结果的操作先申请 CDB，未获授权的结果留在 FU 中
+                if (sim_config.cdbs > 0 && needs_cdb(fu, pool)) {
+                    fu.wb_wait = true;
+                    cdb_request(fu, pool);
+                    continue;
                 }
-
-                // 释放 RS
-                if (rs) {
-                    rs->busy = false;
-                }
-
-                // 释放 FU
-                fu.busy = false;
+                complete_fu(fu, pool);
             }
         }
     };
 
     // 推进所有功能单元
-    process_fu_array(int_alu_fus, "INTALU");
-    process_fu_array(int_muldiv_fu, "MULDIV");
-    process_fu_array(load_fus, "LOAD");
-    process_fu_array(store_fus, "STORE");
-    process_fu_array(fp_add_fus, "FPADD");
-    process_fu_array(fp_mul_fus, "FPMUL");
-    process_fu_array(fp_div_fu, "FPDIV");
+    process_fu_array(int_alu_fus, rs_pools[POOL_INTALU]);
+    process_fu_array(int_muldiv_fu, rs_pools[POOL_MULDIV]);
+    process_fu_array(load_fus, rs_pools[POOL_LOAD]);
+    process_fu_array(store_fus, rs_pools[POOL_STORE]);
+    process_fu_array(fp_add_fus, rs_pools[POOL_FPADD]);
+    process_fu_array(fp_mul_fus, rs_pools[POOL_FPMUL]);
+    process_fu_array(fp_div_fu, rs_pools[POOL_FPDIV]);
+    process_fu_array(fp_fma_fus, rs_pools[POOL_FPFMA]);
+    process_fu_array(vec_fus, rs_pools[POOL_VEC]);
+    process_fu_array(vec_mem_fus, rs_pools[POOL_VMEM]);
+    arbitrate_cdb();
 }
 
 int times = 0;
 
-void commit_head_of_rob() {
+// 把一条提交的 store 的写入放进 store buffer；向量元素与直接写内存时一样，地址已有浮点值就按浮点写
+static bool commit_to_store_buffer(OpType op, const LSQEntry& lsq_entry, const OperandValue& data) {
+    static std::vector<StoreWrite> writes;
+    writes.clear();
+    uint64_t addr = lsq_entry.address;
+    if (is_store_op(op)) {
+        append_store_writes(addr, int_mem_width(op), store_bits(op, data), op == OpType::FSD, writes);
+    } else if (is_vec_store_op(op)) {
+        const VecData& v = to_vec(data);
+        for (uint64_t e = 0; e < lsq_entry.vl; ++e) {
+            uint64_t a = addr + e * lsq_entry.stride;
+            append_store_writes(a, 8, v.e[e], word_is_fp(a), writes);
+        }
+    }
+    return sb_insert(writes.data(), static_cast<int>(writes.size()));
+}
+
+// --trace_out：提交的指令写一条 trace 记录；融合条目按原来的两条指令各写一条，
+// 访存地址属于第一条（load），目的寄存器值属于第二条。向量寄存器的值与向量 store 数据不记录
+static void capture_commit(int idx) {
+    const ROBEntry& entry = rob[idx];
+    const Instruction& instr = rob_instr[idx];
+    TraceRecord r;
+    r.pc = instr.pc;
+    r.raw = instr.raw;
+    if (entry.is_load || entry.is_store) {
+        if (entry.lsq_idx != -1) {
+            const LSQEntry& lsq_entry = lsq[entry.lsq_idx];
+            r.has_addr = true;
+            r.addr = lsq_entry.address;
+            if (entry.is_store && lsq_entry.data.has_value()) {
+                if (is_store_op(entry.op) && entry.op != OpType::FSD) {
+                    r.has_data = true;
+                    r.data = truncate_store_value(entry.op, to_int(*lsq_entry.data));
+                } else if (entry.op == OpType::FSD) {
+                    double d = to_fp(*lsq_entry.data);
+                    r.has_data = true;
+                    std::memcpy(&r.data, &d, sizeof(r.data));
+                }
+            }
+        }
+    } else if (entry.op == OpType::JAL || entry.op == OpType::JALR) {
+        r.taken = true;
+    } else if (is_branch_op(entry.op)) {
+        // trace 驱动模式下分支的计算结果只是令牌，以记录为准
+        r.taken = trace_active() ? instr.taken : entry.result.has_value() && to_int(*entry.result) == 1;
+    }
+    if (entry.result.has_value()) {
+        if (const IntReg* reg = std::get_if<IntReg>(&entry.dest)) {
+            r.has_value = true;
+            r.dest = static_cast<uint8_t>(reg->idx);
+            r.value = to_int(*entry.result);
+        } else if (const FpReg* reg = std::get_if<FpReg>(&entry.dest)) {
+            double d = to_fp(*entry.result);
+            r.has_value = true;
+            r.dest = static_cast<uint8_t>(32 + reg->idx);
+            std::memcpy(&r.value, &d, sizeof(r.value));
+        }
+    }
+    if (instr.fusion == FusionKind::NONE) {
+        trace_write(r);
+        return;
+    }
+    TraceRecord first = r, second = r;
+    if (instr.fusion == FusionKind::AUIPC_JALR) {
+        // 融合条目保留的是 jalr 的 pc
+        first.pc = instr.pc - 4;
+        first.raw = instr.fused_raw;
+    } else {
+        second.pc = instr.pc + 4;
+        second.raw = instr.fused_raw;
+    }
+    first.taken = false;
+    first.has_value = false;
+    second.has_addr = false;
+    trace_write(first);
+    trace_write(second);
+}
+
+// print 为 false（--quiet、Python 绑定、服务器）时不打印 fsd 提交的值
+void commit_head_of_rob(bool print) {
     if (rob_count == 0) return;
     int idx = rob_head;
     ROBEntry& entry = rob[idx];
@@ -732,35 +1873,61 @@ void commit_head_of_rob() {
         uint64_t addr = lsq_entry.address;
         const OperandValue& data = *lsq_entry.data;
 
-        if (entry.op == OpType::SW || entry.op == OpType::SD) {
-            memory_int[addr] = to_int(data);
-        } else if (entry.op == OpType::FSD) {
-            memory_fp[addr] = to_fp(data);
-            std::cout << " { " << addr << " : " << memory_fp[addr] << " }\t";
+        if (sb_enabled()) {
+            // 写入进入提交后 store buffer，由它按自己的带宽写内存；缓冲满时本周期不提交
+            if (!commit_to_store_buffer(entry.op, lsq_entry, data)) return;
+            if (entry.op == OpType::FSD && print && !trace_active()) std::cout << " { " << addr << " : " << to_fp(data) << " }\t";
+        } else if (is_store_op(entry.op)) {
+            write_mem(addr, int_mem_width(entry.op), store_bits(entry.op, data), entry.op == OpType::FSD);
+            dcache_store_access(addr, sim_now());
+            // trace 驱动模式下写入的值没有意义，不打印
+            if (entry.op == OpType::FSD && print && !trace_active()) {
+                std::cout << " { " << addr << " : " << to_fp(data) << " }\t";
+            }
+        } else if (is_vec_store_op(entry.op)) {
+            const VecData& v = to_vec(data);
+            for (uint64_t e = 0; e < lsq_entry.vl; ++e) {
+                uint64_t a = addr + e * lsq_entry.stride;
+                write_mem(a, 8, v.e[e], word_is_fp(a));
+                dcache_store_access(a, sim_now());
+            }
         }
 
         // 标记 LSQ 条目为无效
         lsq_entry.valid = false;
         lsq_count--;
+        lsq_head = (lsq_head + 1) % LSQ_SIZE;
     }
     // Load 或 ALU 指令：写回寄存器文件
     else if (entry.is_load || (!entry.is_store)) {
+        if (entry.op == OpType::VSETVLI && entry.result.has_value()) {
+            vec_vl = to_int(*entry.result);
+            if (vec_vl_status == rob_head) {
+                vec_vl_status = NO_TAG;
+            }
+        }
+        if (entry.phys_dest >= 0) {
+            // 被消除的指令没有经过 FU，体系结构值直接取自共享的物理寄存器
+            if (entry.eliminated) entry.result = prf[entry.phys_dest];
+            prf_commit(entry.dest, entry.phys_dest, entry.old_phys);
+        }
         if (entry.result.has_value()) {
             std::visit([&](const auto& dest_reg) {
                 using T = std::decay_t<decltype(dest_reg)>;
                 if constexpr (std::is_same_v<T, IntReg>) {
                     regs_int[dest_reg.idx] = to_int(*entry.result);
-                    std::string current_tag = regs_int_status[dest_reg.idx];
-                    std::string my_tag = "ROB" + std::to_string(rob_head);
-                    if (current_tag == my_tag) {
-                        regs_int_status[dest_reg.idx] = "";
+                    if (regs_int_status[dest_reg.idx] == rob_head) {
+                        regs_int_status[dest_reg.idx] = NO_TAG;
                     }
                 } else if constexpr (std::is_same_v<T, FpReg>) {
                     regs_fp[dest_reg.idx] = to_fp(*entry.result);
-                    std::string current_tag = regs_fp_status[dest_reg.idx];
-                    std::string my_tag = "ROB" + std::to_string(rob_head);
-                    if (current_tag == my_tag) {
-                        regs_fp_status[dest_reg.idx] = "";
+                    if (regs_fp_status[dest_reg.idx] == rob_head) {
+                        regs_fp_status[dest_reg.idx] = NO_TAG;
+                    }
+                } else if constexpr (std::is_same_v<T, VecReg>) {
+                    regs_vec[dest_reg.idx] = to_vec(*entry.result);
+                    if (regs_vec_status[dest_reg.idx] == rob_head) {
+                        regs_vec_status[dest_reg.idx] = NO_TAG;
                     }
                 }
             }, entry.dest);
@@ -768,6 +1935,15 @@ void commit_head_of_rob() {
     }
 
 release_rob:
+    if (trace_writer_active()) capture_commit(idx);
+    core_stats.committed++;
+    energy_stats.rob_reads++;
+    critpath_on_commit(idx);
+    if (rob_instr[idx].fusion != FusionKind::NONE) {
+        // 融合条目代表两条体系结构指令
+        core_stats.committed++;
+        fusion_count_commit(rob_instr[idx].fusion);
+    }
     // 提交完成，释放 ROB 条目
     entry.busy = false;
     entry.state = InstructionState::COMMITTED;
@@ -778,37 +1954,84 @@ release_rob:
     if (entry.is_load && entry.lsq_idx != -1) {
         lsq[entry.lsq_idx].valid = false;
         lsq_count--;
+        lsq_head = (lsq_head + 1) % LSQ_SIZE;
     }
 }
 
 // --- CDB 广播 ---
-void CDB_broadcast() {
-    for (const auto& cdb : cdb_list) {
-        auto broadcast_to_rs = [&](ReservationStation& rs) {
-            if (rs.Qj == cdb.producer_id) {
-                rs.Vj = cdb.value;
-                rs.Qj.clear();
-            }
-            if (rs.Qk == cdb.producer_id) {
-                rs.Vk = cdb.value;
-                rs.Qk.clear();
-            }
+
+// 把 producer 的结果送给等待它的被消除 move、PRF 与保留站。move 与生产者共用这次广播：
+// 它的结果直接写入 ROB，再以它的标签唤醒等待者，不占用结果总线
+static void wake_consumers(int producer, const OperandValue& value) {
+    for (int i = rob_move_wait.next(0); i >= 0; i = rob_move_wait.next(i + 1)) {
+        if (rob[i].move_src == producer) {
+            critpath_on_wakeup(i, producer);
+            rob[i].result = value;
+            rob[i].state = InstructionState::EXECUTED;
+            rob[i].move_src = NO_TAG;
+            rob_move_wait.reset(i);
+            energy_stats.rob_writes++;
+            wake_consumers(i, value);
+        }
+    }
+
+    // PRF 模式：结果写入目的物理寄存器，只唤醒等待该物理寄存器的保留站，值在发往 FU 时读取
+    int phys_tag = NO_TAG;
+    int phys = rob[producer].phys_dest;
+    if (phys >= 0) {
+        prf[phys] = value;
+        prf_ready[phys] = true;
+        phys_tag = prf_tag(phys);
+    }
+    // 只比较有源在等待的保留站；被唤醒的条目重新判断是否就绪
+    auto broadcast_to_rs = [&](RsPool& pool, int idx) {
+        ReservationStation& rs = pool.rs[idx];
+        energy_stats.wakeup_compares += (rs.Qj != NO_TAG) + (rs.Qk != NO_TAG) + (rs.Qr != NO_TAG) + (rs.Qvl != NO_TAG);
+        auto waits = [&](int t) {
+            return t != NO_TAG && (t == producer || t == phys_tag);
         };
+        if (!(waits(rs.Qj) || waits(rs.Qk) || waits(rs.Qr) || waits(rs.Qvl))) return;
+        critpath_on_wakeup(rs.ROB_idx, producer);
+        if (phys_tag != NO_TAG) {
+            if (rs.Qj == phys_tag) rs.Qj = NO_TAG;
+            if (rs.Qk == phys_tag) rs.Qk = NO_TAG;
+            if (rs.Qr == phys_tag) rs.Qr = NO_TAG;
+        }
+        if (rs.Qj == producer) {
+            rs.Vj = value;
+            rs.Qj = NO_TAG;
+        }
+        if (rs.Qk == producer) {
+            rs.Vk = value;
+            rs.Qk = NO_TAG;
+        }
+        if (rs.Qr == producer) {
+            rs.Vr = value;
+            rs.Qr = NO_TAG;
+        }
+        if (rs.Qvl == producer) {
+            rs.Vvl = value;
+            rs.Qvl = NO_TAG;
+        }
+        pool.update_ready(idx);
+    };
 
-        for (int i = 0; i < NUM_INTALU_RS; ++i) broadcast_to_rs(intalu_rs[i]);
-        for (int i = 0; i < NUM_MULDIV_RS; ++i) broadcast_to_rs(muldiv_rs[i]);
-        for (int i = 0; i < NUM_LOAD_RS; ++i) broadcast_to_rs(load_rs[i]);
-        for (int i = 0; i < NUM_STORE_RS; ++i) broadcast_to_rs(store_rs[i]);
-        for (int i = 0; i < NUM_FPADD_RS; ++i) broadcast_to_rs(fpadd_rs[i]);
-        for (int i = 0; i < NUM_FPMUL_RS; ++i) broadcast_to_rs(fpmul_rs[i]);
-        for (int i = 0; i < NUM_FPDIV_RS; ++i) broadcast_to_rs(fpdiv_rs[i]);
+    for (auto& pool : rs_pools) {
+        for (int i = pool.waiting.next(0); i >= 0; i = pool.waiting.next(i + 1)) broadcast_to_rs(pool, i);
+    }
+}
+
+// cdb_list 中的每一项占用一条结果总线（--cdbs 限制的正是这些项）
+void CDB_broadcast() {
+    for (const CDB& cdb : cdb_list) {
+        energy_stats.cdb_broadcasts++;
+        energy_stats.rob_writes++;
+        wake_consumers(cdb.producer, cdb.value);
     }
 }
 
 void print_cycle_state(int cycle) {
     std::cout << "\n========== CYCLE " << cycle << " ==========\n";
-    if(cycle == 7)
-        std::cout<<"\n";
 
     // --- Print ROB (only non-COMMITTED or busy entries) ---
     bool rob_printed_header = false;
@@ -835,11 +2058,12 @@ void print_cycle_state(int cycle) {
             using T = std::decay_t<decltype(r)>;
             if constexpr (std::is_same_v<T, IntReg>) return "x" + std::to_string(r.idx);
             else if constexpr (std::is_same_v<T, FpReg>) return "f" + std::to_string(r.idx);
+            else if constexpr (std::is_same_v<T, VecReg>) return "v" + std::to_string(r.idx);
             else return "-";
         }, rob[i].dest);
 
         std::cout << "  ROB" << i << " : op=" << static_cast<int>(rob[i].op)
-                  << " instr="<< rob[i].instr.toString()
+                  << " instr="<< rob_instr[i].toString()
                   << " dest=" << dest_str
                   << " state=" << state_str
                   << " lsq_idx=" << rob[i].lsq_idx
@@ -850,16 +2074,39 @@ void print_cycle_state(int cycle) {
     // --- Print Register Status ---
     std::cout << "\nInteger Register Status:\n";
     for (int i = 0; i < 32; ++i) {
-        if (!regs_int_status[i].empty()) {
-            std::cout << "  x" << i << " <- " << regs_int_status[i] << "\n";
+        if (regs_int_status[i] != NO_TAG) {
+            std::cout << "  x" << i << " <- " << tag_name(regs_int_status[i]) << "\n";
+        }
+    }
+    if (prf_mode()) {
+        // 推测映射与退休映射不同的寄存器（有在途的写者）
+        for (int i = 1; i < 32; ++i) {
+            if (rename_int[i] != retire_int[i])
+                std::cout << "  x" << i << " -> " << tag_name(prf_tag(rename_int[i]))
+                          << (prf_ready[rename_int[i]] ? " (ready)" : "") << "\n";
         }
     }
     std::cout << "FP Register Status:\n";
+    if (prf_mode()) {
+        for (int i = 0; i < 32; ++i) {
+            if (rename_fp[i] != retire_fp[i])
+                std::cout << "  f" << i << " -> " << tag_name(prf_tag(rename_fp[i]))
+                          << (prf_ready[rename_fp[i]] ? " (ready)" : "") << "\n";
+        }
+    }
     for (int i = 0; i < 32; ++i) {
-        if (!regs_fp_status[i].empty()) {
-            std::cout << "  f" << i << " <- " << regs_fp_status[i] << "\n";
+        if (regs_fp_status[i] != NO_TAG) {
+            std::cout << "  f" << i << " <- " << tag_name(regs_fp_status[i]) << "\n";
         }
     }
+    for (int i = 0; i < 32; ++i) {
+        if (regs_vec_status[i] != NO_TAG) {
+            std::cout << "  v" << i << " <- " << tag_name(regs_vec_status[i]) << "\n";
+        }
+    }
+    if (vec_vl_status != NO_TAG) {
+        std::cout << "  vl <- " << tag_name(vec_vl_status) << "\n";
+    }
     std::cout << "\nInteger Register value:\n";
     for (int i = 0; i < 32; ++i) {
         if (regs_int[i] != 0) {
@@ -872,6 +2119,16 @@ void print_cycle_state(int cycle) {
             std::cout << "  f" << i << " <- " << static_cast<double>(regs_fp[i]) <<  "\t";
         }
     }
+    if (vec_vl != 0) {
+        std::cout << "\nVector Register value (vl=" << vec_vl << "):\n";
+        for (int i = 0; i < 32; ++i) {
+            bool nonzero = false;
+            for (uint64_t e : regs_vec[i].e) nonzero |= (e != 0);
+            if (nonzero) {
+                std::cout << "  v" << i << " <- " << format_operand_value(OperandValue(regs_vec[i])) << "\n";
+            }
+        }
+    }
     std::cout<<std::endl;
 
     // --- Print Reservation Stations ---
@@ -886,10 +2143,13 @@ void print_cycle_state(int cycle) {
                 }
                 std::cout << "  " << name << i << ": op=" << static_cast<int>(rs[i].op)
                           << " ROB" << rs[i].ROB_idx
-                          << " Qj=" << (rs[i].Qj.empty() ? "-" : rs[i].Qj)
-                          << " Qk=" << (rs[i].Qk.empty() ? "-" : rs[i].Qk);
+                          << " Qj=" << (rs[i].Qj == NO_TAG ? "-" : tag_name(rs[i].Qj))
+                          << " Qk=" << (rs[i].Qk == NO_TAG ? "-" : tag_name(rs[i].Qk));
                 if (rs[i].Vj) std::cout << " Vj=" << format_operand_value(*rs[i].Vj);
                 if (rs[i].Vk) std::cout << " Vk=" << format_operand_value(*rs[i].Vk);
+                if (rs[i].Qr != NO_TAG) std::cout << " Qr=" << tag_name(rs[i].Qr);
+                if (rs[i].Vr) std::cout << " Vr=" << format_operand_value(*rs[i].Vr);
+                if (rs[i].Qvl != NO_TAG) std::cout << " Qvl=" << tag_name(rs[i].Qvl);
                 std::cout << " A=" << rs[i].A << "\n";
             }
         }
@@ -903,37 +2163,214 @@ void print_cycle_state(int cycle) {
     print_rs_array("FPADD_RS", fpadd_rs, NUM_FPADD_RS);
     print_rs_array("FPMUL_RS", fpmul_rs, NUM_FPMUL_RS);
     print_rs_array("FPDIV_RS", fpdiv_rs, NUM_FPDIV_RS);
+    print_rs_array("FPFMA_RS", fpfma_rs, NUM_FPFMA_RS);
+    print_rs_array("VEC_RS", vec_rs, NUM_VEC_RS);
+    print_rs_array("VMEM_RS", vec_mem_rs, NUM_VEC_MEM_RS);
 
     // --- Print CDB broadcasts this cycle ---
     if (!cdb_list.empty()) {
         std::cout << "\nCDB Broadcasts:\n";
         for (const auto& cdb : cdb_list) {
-            std::cout << "  " << cdb.producer_id << " -> ";
-            try {
-                uint64_t iv = to_int(cdb.value);
-                std::cout << iv;
-            } catch (...) {
-                double dv = to_fp(cdb.value);
-                std::cout << dv;
-            }
-            std::cout << "\n";
+            std::cout << "  " << tag_name(cdb.producer) << " -> " << format_operand_value(cdb.value) << "\n";
         }
     }
 
     std::cout << "========================================\n\n";
 }
 
-void simulate(const std::vector<Instruction>& instructions,
+// 发射失败的原因（关键路径分析用）
+static CpEdge issue_stall_reason(const Instruction& instr) {
+    if (rob_count >= ROB_SIZE) return CpEdge::ROB_FULL;
+    bool uses_lsq = is_load_op(instr.op) || is_store_op(instr.op) ||
+                    is_vec_load_op(instr.op) || is_vec_store_op(instr.op);
+    if (uses_lsq && lsq_count >= LSQ_SIZE) return CpEdge::LSQ_FULL;
+    if (prf_mode() && !prf_can_allocate(get_dest_reg_from_instruction(instr))) return CpEdge::PRF_FULL;
+    return CpEdge::RS_FULL;
+}
+
+// 推进一个周期；enable_fetch 为 false 时只排空已取的指令（采样模式退出详细模拟前使用）
+void simulate_cycle(bool enable_fetch, bool print) {
+    // 提交后 store buffer 先排空，本周期提交的 store 最早下一周期写内存
+    sb_drain(sim_now());
+    // 3. Commit 阶段：提交 ROB 头部（按序提交）
+    commit_head_of_rob(print);
+    // 2. Execute & Broadcast 阶段
+    if (dcache_nonblocking()) dcache_mshr_tick(sim_now());
+    executeFU();
+
+    // 无分支延迟槽（执行后立即重定向取指）
+    frontend_apply_redirect();
+    // 0. Fetch 阶段：填充取指队列
+    if (enable_fetch) fetch_stage();
+    // 1. Issue 阶段：从取指队列按序发射（这里简化为每周期 1 条，融合对算 1 条）
+    if (!fetch_queue.empty()) {
+        Instruction fused;
+        if (fetch_queue.size() >= 2 && fuse_pair(fetch_queue[0], fetch_queue[1], sim_config, fused)) {
+            fused.fetch_cycle = fetch_queue[1].fetch_cycle;
+            if (issue_instruction(fused)) {
+                fetch_queue.pop_front();
+                fetch_queue.pop_front();
+            } else {
+                critpath_issue_stall(issue_stall_reason(fused));
+            }
+        } else if (issue_instruction(fetch_queue.front())) {
+            fetch_queue.pop_front();
+        } else {
+            critpath_issue_stall(issue_stall_reason(fetch_queue.front()));
+        }
+    } else if (enable_fetch && !frontend_drained()) {
+        frontend_stats.issue_starved_cycles++;
+    }
+
+    CDB_broadcast();
+    if (prf_mode()) prf_sample_occupancy();
+    critpath_end_cycle();
+    history_record(core_stats.cycles);
+
+    if (print)
+        print_cycle_state(static_cast<int>(core_stats.cycles));
+    core_stats.cycles++;
+}
+
+// 源寄存器按发射时的约定放入 Vj / Vk / Vr，直接读体系结构寄存器
+static void read_functional_operands(const Instruction& instr, ReservationStation& rs) {
+    if (is_vec_op(instr.op)) {
+        if (instr.vs1 >= 0) rs.Vj = OperandValue(regs_vec[instr.vs1]);
+        else if (instr.rs1 >= 0) rs.Vj = OperandValue(regs_int[instr.rs1]);
+        else if (instr.fs1 >= 0) rs.Vj = OperandValue(regs_fp[instr.fs1]);
+        if (instr.vs2 >= 0) rs.Vk = OperandValue(regs_vec[instr.vs2]);
+        else if (instr.rs2 >= 0) rs.Vk = OperandValue(regs_int[instr.rs2]);
+        else rs.Vk = OperandValue(static_cast<uint64_t>(sizeof(uint64_t)));
+        if (is_vec_macc_op(instr.op)) rs.Vr = OperandValue(regs_vec[instr.vd]);
+        else if (instr.vs3 >= 0) rs.Vr = OperandValue(regs_vec[instr.vs3]);
+        rs.Vvl = OperandValue(vec_vl);
+        return;
+    }
+    if (instr.rs1 >= 0) rs.Vj = OperandValue(regs_int[instr.rs1]);
+    else if (instr.fs1 >= 0) rs.Vj = OperandValue(regs_fp[instr.fs1]);
+    else rs.Vj = OperandValue(0ULL);
+    if (instr.rs2 >= 0) rs.Vk = OperandValue(regs_int[instr.rs2]);
+    else if (instr.fs2 >= 0) rs.Vk = OperandValue(regs_fp[instr.fs2]);
+    else rs.Vk = OperandValue(static_cast<uint64_t>(static_cast<int64_t>(instr.imm)));
+    if (instr.fs3 >= 0) rs.Vr = OperandValue(regs_fp[instr.fs3]);
+    if (instr.op == OpType::VSETVLI && instr.rs1 == 0) {
+        rs.Vj = OperandValue(instr.rd != 0 ? static_cast<uint64_t>(VLMAX) : vec_vl);
+    }
+}
+
+static std::string functional_rs_type(OpType op) {
+    if (is_alu_op(op)) return "INTALU";
+    if (is_muldiv_op(op)) return "MULDIV";
+    if (is_fp_add_op(op)) return "FPADD";
+    if (is_fp_mul_op(op)) return "FPMUL";
+    if (is_fp_div_op(op)) return "FPDIV";
+    if (is_fp_fma_op(op)) return "FPFMA";
+    return "VEC";
+}
+
+// 功能快进上一次访问的 L1I 行，sim_init 复位
+static uint64_t ff_fetch_line = ~0ULL;
+
+// 功能模拟：流水线为空时按体系结构语义执行 next_fetch_idx 处的一条指令，
+// 同时用它的取指与访存预热 L1I / L1D 及预取器。遇到 ebreak 或程序结束返回 false
+bool functional_step() {
+    if (next_fetch_idx >= instruction_queue.size()) return false;
+    const Instruction& instr = instruction_queue[next_fetch_idx];
+    if (instr.op == OpType::UNKNOWN) {
+        throw std::runtime_error("Unsupported instruction at pc=" + std::to_string(instr.pc) +
+                                 " (raw=" + std::to_string(instr.raw) + ")");
+    }
+    if (instr.op == OpType::EBREAK) {
+        next_fetch_idx = instruction_queue.size();
+        return false;
+    }
+    uint64_t now = sim_now();
+    // 只在跨入新的 L1I 行时访问，近似取指组
+    if (icache_line_of(instr.pc) != ff_fetch_line) {
+        ff_fetch_line = icache_line_of(instr.pc);
+        icache_fetch_access(instr.pc, now);
+    }
+
+    ReservationStation rs;
+    rs.op = instr.op;
+    rs.pc = instr.pc;
+    rs.A = instr.imm;
+    read_functional_operands(instr, rs);
+
+    std::optional<OperandValue> result;
+    size_t next_idx = next_fetch_idx + 1;
+    if (is_load_op(instr.op)) {
+        uint64_t addr = to_int(*rs.Vj) + rs.A;
+        dcache_load_access(instr.pc, addr, now);
+        result = loaded_value(instr.op, read_mem(addr, int_mem_width(instr.op)));
+    } else if (is_store_op(instr.op)) {
+        uint64_t addr = to_int(*rs.Vj) + rs.A;
+        write_mem(addr, int_mem_width(instr.op), store_bits(instr.op, *rs.Vk), instr.op == OpType::FSD);
+        dcache_store_access(addr, now);
+    } else if (is_vec_load_op(instr.op) || is_vec_store_op(instr.op)) {
+        uint64_t base = to_int(*rs.Vj) + rs.A;
+        int64_t stride = static_cast<int64_t>(to_int(*rs.Vk));
+        uint64_t vl = std::min<uint64_t>(vec_vl, VLMAX);
+        if (is_vec_load_op(instr.op)) {
+            VecData v;
+            v.e.fill(~0ULL);
+            for (uint64_t e = 0; e < vl; ++e) {
+                dcache_load_access(instr.pc, base + e * stride, now);
+                v.e[e] = read_mem(base + e * stride, 8);
+            }
+            result = OperandValue(v);
+        } else {
+            const VecData& v = to_vec(*rs.Vr);
+            for (uint64_t e = 0; e < vl; ++e) {
+                write_mem(base + e * stride, 8, v.e[e], word_is_fp(base + e * stride));
+                dcache_store_access(base + e * stride, now);
+            }
+        }
+    } else {
+        FunctionalUnit fu;
+        fu.start(instr.op, *rs.Vj, *rs.Vk, -1, functional_rs_type(instr.op), -1,
+                 rs.Vr ? *rs.Vr : OperandValue{}, rs.Vvl ? to_int(*rs.Vvl) : 0);
+        fu.pc = instr.pc;
+        result = fu.compute_result();
+        if (is_branch_op(instr.op)) {
+            if (to_int(*result) == 1) next_idx = (instr.pc + instr.imm) / 4;
+            result.reset();
+        } else if (instr.op == OpType::JAL) {
+            next_idx = (instr.pc + instr.imm) / 4;
+        } else if (instr.op == OpType::JALR) {
+            next_idx = ((to_int(*rs.Vj) + rs.A) & ~1ULL) / 4;
+        } else if (instr.op == OpType::VSETVLI) {
+            vec_vl = to_int(*result);
+        }
+    }
+
+    if (result) {
+        std::visit([&](const auto& dest_reg) {
+            using T = std::decay_t<decltype(dest_reg)>;
+            if constexpr (std::is_same_v<T, IntReg>) regs_int[dest_reg.idx] = to_int(*result);
+            else if constexpr (std::is_same_v<T, FpReg>) regs_fp[dest_reg.idx] = to_fp(*result);
+            else if constexpr (std::is_same_v<T, VecReg>) regs_vec[dest_reg.idx] = to_vec(*result);
+        }, get_dest_reg_from_instruction(instr));
+    }
+    next_fetch_idx = next_idx;
+    sampling_stats.fast_forwarded++;
+    return true;
+}
+
+void sim_init(const std::vector<Instruction>& instructions,
     const MemoryInitData& mem_init,
-    const RegisterInitData& reg_init, 
-    bool ENABLE_CYCLE_PRINT) {
+    const RegisterInitData& reg_init) {
     // 初始化全局状态
     for (int i = 0; i < 32; ++i) {
         regs_int[i] = 0;
         regs_fp[i] = 0.0;
-        regs_int_status[i] = "";
-        regs_fp_status[i] = "";
+        regs_int_status[i] = NO_TAG;
+        regs_fp_status[i] = NO_TAG;
+        regs_vec[i] = VecData{};
+        regs_vec_status[i] = NO_TAG;
     }
+    vec_vl = 0;
+    vec_vl_status = NO_TAG;
     for (const auto& [idx, val] : reg_init.int_regs) {
         if (idx >= 0 && idx < 32) {
             if (idx == 0) continue;   // x0 is hardwired to 0
@@ -950,25 +2387,20 @@ void simulate(const std::vector<Instruction>& instructions,
     memory_fp.clear();
 
     for (const auto& [addr, val] : mem_init.int_data) {
-        memory_int[addr] = val;
+        write_mem(addr, 8, val, false);
     }
     for (const auto& [addr, val] : mem_init.fp_data) {
-        memory_fp[addr] = val;
+        uint64_t bits;
+        std::memcpy(&bits, &val, sizeof(bits));
+        write_mem(addr, 8, bits, true);
     }
 
     // 清空保留站
-    auto clear_rs_array = [](ReservationStation* arr, int size) {
-        for (int i = 0; i < size; ++i) {
-            arr[i] = ReservationStation{};
-        }
-    };
-    clear_rs_array(intalu_rs, NUM_INTALU_RS);
-    clear_rs_array(muldiv_rs, NUM_MULDIV_RS);
-    clear_rs_array(load_rs, NUM_LOAD_RS);
-    clear_rs_array(store_rs, NUM_STORE_RS);
-    clear_rs_array(fpadd_rs, NUM_FPADD_RS);
-    clear_rs_array(fpmul_rs, NUM_FPMUL_RS);
-    clear_rs_array(fpdiv_rs, NUM_FPDIV_RS);
+    for (auto& pool : rs_pools) {
+        pool.reset();
+        pool.select = select_policy(sim_config, pool.type);
+    }
+    select_rng.seed(1);
 
     // 清空功能单元
     auto clear_fu_array = [](auto& arr) {
@@ -983,11 +2415,16 @@ void simulate(const std::vector<Instruction>& instructions,
     clear_fu_array(fp_mul_fus);
     clear_fu_array(int_muldiv_fu);
     clear_fu_array(fp_div_fu);
+    clear_fu_array(fp_fma_fus);
+    clear_fu_array(vec_fus);
+    clear_fu_array(vec_mem_fus);
 
     // 清空 ROB 和 LSQ
     for (int i = 0; i < ROB_SIZE; ++i) {
         rob[i] = ROBEntry{};
+        rob_instr[i] = Instruction{};
     }
+    rob_move_wait.clear();
     for (int i = 0; i < LSQ_SIZE; ++i) {
         lsq[i] = LSQEntry{};
     }
@@ -996,41 +2433,69 @@ void simulate(const std::vector<Instruction>& instructions,
 
     instruction_queue = instructions;
     next_fetch_idx = 0;
+    next_fetch_branch = 0;
+    fetch_redirect = false;
+    fetch_barrier = false;
+    ff_fetch_line = ~0ULL;
+
+    miss_returns.clear();
+    cdb_requests.clear();
+
+    reset_stats();
+    critpath_reset();
+    prf_reset(sim_config);
+    dcache_reset(sim_config);
+    dram_reset(sim_config);
+    sb_reset(sim_config);
+    mdp_reset(sim_config);
+    frontend_reset(sim_config);
+    history_reset();
+}
 
-    int cycle = 0;
-    // 模拟直到所有指令都取完且 ROB 为空
-    while (next_fetch_idx < instruction_queue.size() || rob_count > 0) {
-        // 3. Commit 阶段：提交 ROB 头部（按序提交）
-        commit_head_of_rob();
-        // 2. Execute & Broadcast 阶段
-        executeFU();
-
-        // 无分支延迟槽（执行后立即更新）
-        if(next_fetch_branch != next_fetch_idx) {
-            next_fetch_idx = next_fetch_branch;
-        }
-        // 1. Issue 阶段：按序发射（这里简化为每周期 1 条）
-        if (next_fetch_idx < instruction_queue.size()) {
-            if(issue_instruction(instruction_queue[next_fetch_idx]))
-                next_fetch_idx++;
-        }
+void print_memory(std::ostream& os) {
+    os << " {addr : val}\n";
+    os<<"===================  memory int data =====================\n";
+    for (const auto& [addr, val] : memory_int) {
+        os << " { " << addr << " : " << val << " }\t";
+    }
+    os<<"\n===================  memory fp data =====================\n";
+    for (const auto& [addr, val] : memory_fp) {
+        os << " { " << addr << " : " << val << " }\t";
+    }
+    os<<std::endl;
+}
 
-        CDB_broadcast();
-        next_fetch_branch = next_fetch_idx;
+void simulate(const std::vector<Instruction>& instructions,
+    const MemoryInitData& mem_init,
+    const RegisterInitData& reg_init, 
+    bool ENABLE_CYCLE_PRINT) {
+    sim_init(instructions, mem_init, reg_init);
 
-        if(ENABLE_CYCLE_PRINT)
-            print_cycle_state(cycle);
-        cycle++;
+    // 模拟直到所有指令都取完、ROB 为空且 store buffer 排空
+    if (sim_config.sample) {
+        run_sampled(ENABLE_CYCLE_PRINT);
+    } else {
+        while (!frontend_drained() || rob_count > 0 || !sb_empty()) {
+            simulate_cycle(true, ENABLE_CYCLE_PRINT);
+        }
     }
 
-    std::cout << " {addr : val}\n";
-    std::cout<<"===================  memory int data =====================\n";
-    for (const auto& [addr, val] : memory_int) {
-        std::cout << " { " << addr << " : " << val << " }\t";
-    }
-    std::cout<<"\n===================  memory fp data =====================\n";
-    for (const auto& [addr, val] : memory_fp) {
-        std::cout << " { " << addr << " : " << val << " }\t";
+    print_memory(std::cout);
+    print_stats(std::cout);
+}
+
+void simulate_trace(const std::string& path, bool ENABLE_CYCLE_PRINT) {
+    sim_init({});
+    trace_open(path);
+    try {
+        while (!frontend_drained() || rob_count > 0 || !sb_empty()) {
+            simulate_cycle(true, ENABLE_CYCLE_PRINT);
+        }
+    } catch (...) {
+        trace_close();
+        throw;
     }
-    std::cout<<std::endl;
-}
\ No newline at end of file
+    trace_close();
+    // 寄存器值不反映真实执行，内存内容没有意义，只输出统计
+    print_stats(std::cout);
+}
@@ -10,11 +10,19 @@
 # include <variant>
 # include <optional>
 # include <queue>
+# include <array>
+# include <sstream>
+# include <stdexcept>
 # include "instruction.h"
+# include "sim_config.h"
+# include "sim_stats.h"
+# include "slot_mask.h"
 
 // 全局模拟器状态
 
-// 各种保留站数目
+// 各种保留站数目：每个池按 RS_POOL_MAX 位的位图跟踪条目，所以每个池最多 RS_POOL_MAX 个条目
+// （编译期检查）；要更大的池需同时调大 RS_POOL_MAX
+const int RS_POOL_MAX = 64;
 const int NUM_INTALU_RS = 6;
 const int NUM_MULDIV_RS = 2;
 const int NUM_LOAD_RS   = 8;
@@ -22,12 +30,14 @@ const int NUM_STORE_RS  = 6;
 const int NUM_FPADD_RS  = 4;
 const int NUM_FPMUL_RS  = 4;
 const int NUM_FPDIV_RS  = 2;
+const int NUM_FPFMA_RS  = 4;
 
 // 功能单元数量
 const int NUM_INT_ALUS = 2;
 const int NUM_LOAD_UNITS = 2;
 const int NUM_FP_ADDERS = 2;
 const int NUM_FP_MULTIPLIERS = 2;
+const int NUM_FP_FMA_UNITS = 1;
 
 // ROB条目数
 const int ROB_SIZE = 32;
@@ -35,8 +45,22 @@ const int ROB_SIZE = 32;
 // LSQ
 const int LSQ_SIZE = 16; 
 
+// 向量扩展（RVV 子集，只支持 SEW=64、LMUL=1）
+const int VLEN = 256;                // 向量寄存器位宽
+const int VLMAX = VLEN / 64;         // 每个寄存器的最大元素数
+const int NUM_VEC_LANES = 2;         // 向量功能单元每周期处理的元素数
+const int NUM_VEC_RS = 4;
+const int NUM_VEC_MEM_RS = 4;
+const int NUM_VEC_UNITS = 1;
+const int NUM_VEC_MEM_UNITS = 1;
+
+// 向量寄存器内容，浮点元素按位存放
+struct VecData {
+    alignas(32) std::array<uint64_t, VLMAX> e{};
+};
+
 // 支持类型
-using OperandValue = std::variant<uint64_t, double>;
+using OperandValue = std::variant<uint64_t, double, VecData>;
 
 // 目的寄存器标签类型
 struct IntReg {
@@ -47,9 +71,13 @@ struct FpReg {
     int idx;
     FpReg(int i) : idx(i) { assert(i >= 0 && i < 32); }
 };
+struct VecReg {
+    int idx;
+    VecReg(int i) : idx(i) { assert(i >= 0 && i < 32); }
+};
 
-// 目的寄存器：无 / 整数 / 浮点
-using DestReg = std::variant<std::monostate, IntReg, FpReg>;
+// 目的寄存器：无 / 整数 / 浮点 / 向量
+using DestReg = std::variant<std::monostate, IntReg, FpReg, VecReg>;
 
 enum class InstructionState {
     ISSUED,
@@ -61,29 +89,55 @@ enum class InstructionState {
 // 寄存器
 extern uint64_t regs_int[32];
 extern double regs_fp[32];
+extern VecData regs_vec[32];
+extern uint64_t vec_vl;          // vl CSR，由 vsetvli 写入
+
+// 生产者标签：ROB 模式为生产者的 ROB 下标，PRF 模式下物理寄存器 p 为 ROB_SIZE + p（见 prf_tag），
+// NO_TAG 表示没有生产者。保留站、状态表与 CDB 只保存整数标签
+const int NO_TAG = -1;
+// 标签的显示形式 "ROB<n>" / "P<n>"，只用于打印与历史记录
+std::string tag_name(int tag);
 
-// 寄存器状态表
-extern std::string regs_int_status[32];
-extern std::string regs_fp_status[32];
+// 寄存器状态表：写该寄存器的最年轻在飞指令的标签
+extern int regs_int_status[32];
+extern int regs_fp_status[32];
+extern int regs_vec_status[32];
+extern int vec_vl_status;
 
 // 内存模型
 extern std::unordered_map<uint64_t, uint64_t> memory_int;
 extern std::unordered_map<uint64_t, double> memory_fp;
+// 内存按 8 字节对齐的字存放，每个字只在一张表中。写字 word 中 mask 标出的字节：
+// 整字浮点写入存 memory_fp，其余与原值合并后存 memory_int，并删掉另一张表中的同一字
+void write_mem_word(uint64_t word, uint64_t bits, uint8_t mask, bool fp);
 
 // 保留站
 struct ReservationStation {
     bool busy = false;
     OpType op = OpType::UNKNOWN;
 
-    std::string Qj = "";
+    int Qj = NO_TAG;
     std::optional<OperandValue> Vj;
-    std::string Qk = "";
+    int Qk = NO_TAG;
     std::optional<OperandValue> Vk;
+    // 第三个源操作数：融合乘加的加数 (fs3 / 向量 vd) / 向量 store 的数据
+    int Qr = NO_TAG;
+    std::optional<OperandValue> Vr;
+    // 向量指令使用的 vl
+    int Qvl = NO_TAG;
+    std::optional<OperandValue> Vvl;
+    // load 预测依赖的 store 的 ROB 下标（store set），该 store 地址解析前 load 不执行
+    int Qst = NO_TAG;
+    // PRF 模式下源操作数的物理寄存器号（-1 表示无），发往 FU 时读取
+    int Pj = -1, Pk = -1, Pr = -1;
+    // 宏融合的第二个操作：主操作结果作为其第一个源，Vr/Qr 为另一个源
+    OpType post_op = OpType::UNKNOWN;
 
     DestReg dest = std::monostate{};
 
     int ROB_idx = -1;
     int64_t A = 0;
+    uint64_t pc = 0;     // 指令地址：AUIPC / JAL(R) 链接地址 / 分支目标
 
     void clear();
 };
@@ -95,19 +149,58 @@ extern ReservationStation store_rs[NUM_STORE_RS];
 extern ReservationStation fpadd_rs[NUM_FPADD_RS];
 extern ReservationStation fpmul_rs[NUM_FPMUL_RS];
 extern ReservationStation fpdiv_rs[NUM_FPDIV_RS];
+extern ReservationStation fpfma_rs[NUM_FPFMA_RS];
+extern ReservationStation vec_rs[NUM_VEC_RS];
+extern ReservationStation vec_mem_rs[NUM_VEC_MEM_RS];
+
+// 保留站池：busy 位图与各条目的 busy 标志同步，用于分配空位；
+// ready 位图标记操作数已齐、尚未发往 FU 的条目，发射选择只看这些条目；
+// waiting 位图标记至少有一个 Q 标签在等待广播的条目，CDB 唤醒只比较这些条目的标签
+struct RsPool {
+    std::string type;     // "INTALU", "FPADD" ...
+    ReservationStation* rs;
+    int size;
+    SlotMask<RS_POOL_MAX> busy;
+    SlotMask<RS_POOL_MAX> ready;
+    SelectPolicy select = SelectPolicy::POSITION;
+    // 年龄矩阵：older[i] 为比条目 i 先分配、仍占用的条目
+    SlotMask<RS_POOL_MAX> older[RS_POOL_MAX];
+    uint64_t ready_at[RS_POOL_MAX] = {};   // 最近一次变为就绪的周期
+    SlotMask<RS_POOL_MAX> waiting;         // 至少有一个源在等待广播
+
+    RsPool(const char* t, ReservationStation* r, int n) : type(t), rs(r), size(n) {}
+
+    // 取一个空闲条目并清空、置 busy；没有空位返回 -1
+    int acquire();
+    void release(int idx);
+    // 操作数变化后（发射、唤醒）重新判断是否就绪，并按 Q 标签刷新 waiting 位图
+    void update_ready(int idx);
+    void reset();
+};
+
+enum RsPoolId {
+    POOL_INTALU, POOL_MULDIV, POOL_LOAD, POOL_STORE, POOL_FPADD,
+    POOL_FPMUL, POOL_FPDIV, POOL_FPFMA, POOL_VEC, POOL_VMEM, NUM_RS_POOLS
+};
+extern RsPool rs_pools[NUM_RS_POOLS];
 
 // 功能单元
 struct FunctionalUnit {
     bool busy = false;
     int remaining_cycles = 0;
     OpType op = OpType::UNKNOWN;
-    OperandValue v1{}, v2{};
+    OperandValue v1{}, v2{}, v3{};
+    uint64_t vl = 0;
+    uint64_t pc = 0;
     int rob_idx = -1;
     std::string rs_type; // "INTALU", "FPADD", etc.
     int rs_idx = -1;
+    std::vector<uint64_t> mem_wait;   // 等待中的 DRAM 请求，全部返回后才开始倒计时
+    bool wb_wait = false;             // 已算完，等待 CDB 授权后才写回并释放
 
     void start(OpType _op, const OperandValue& a, const OperandValue& b,
-               int _rob_idx, const std:: string& _rs_type, int _rs_idx);
+               int _rob_idx, const std:: string& _rs_type, int _rs_idx,
+               const OperandValue& c = OperandValue{}, uint64_t _vl = 0);
     void clear();
     OperandValue compute_result() const;
 };
@@ -119,6 +212,9 @@ extern std::array<FunctionalUnit, NUM_FP_MULTIPLIERS> fp_mul_fus;
 extern std::array<FunctionalUnit, 1> store_fus;
 extern std::array<FunctionalUnit, 1> int_muldiv_fu;
 extern std::array<FunctionalUnit, 1> fp_div_fu;
+extern std::array<FunctionalUnit, NUM_FP_FMA_UNITS> fp_fma_fus;
+extern std::array<FunctionalUnit, NUM_VEC_UNITS> vec_fus;
+extern std::array<FunctionalUnit, NUM_VEC_MEM_UNITS> vec_mem_fus;
 
 // ROB
 struct ROBEntry {
@@ -131,23 +227,33 @@ struct ROBEntry {
     InstructionState state = InstructionState::ISSUED;
 
     int lsq_idx = -1;
-    // debug
-    Instruction instr;
+    // PRF 模式：分配的物理寄存器与被覆盖的旧映射
+    int phys_dest = -1;
+    int old_phys = -1;
+    // 在重命名时被消除（不占 RS / FU）；ROB 模式下源未就绪的 move 等待 move_src 的广播
+    bool eliminated = false;
+    int move_src = NO_TAG;
 
     void clear();
 };
 
 extern ROBEntry rob[ROB_SIZE];
+// 与 ROB 同下标的指令副本，不放在 ROBEntry 中。提交、冲刷重取和打印读取它，
+// 分支完成（循环缓冲预测）、trace 模式的访存地址与访存违例的训练和重取也读取它
+extern Instruction rob_instr[ROB_SIZE];
+// 等待 move_src 广播的被消除 move
+extern SlotMask<ROB_SIZE> rob_move_wait;
 extern int rob_head;
 extern int rob_tail;
 extern int rob_count;
 
 // CDB
 struct CDB {
-    std::string producer_id = "";
+    int producer = NO_TAG;     // 生产者的 ROB 下标
     OperandValue value;
 };
 extern CDB cdb;
+extern std::vector<CDB> cdb_list;   // 本周期的全部广播
 
 // LSQ
 struct LSQEntry {
@@ -160,6 +266,14 @@ struct LSQEntry {
 
     std::optional<OperandValue> data; // for store: data to write; for load: result
 
+    // 向量访存：元素间跨步（字节）与元素个数
+    int64_t stride = 0;
+    uint64_t vl = 0;
+
+    // load：已读出数据；数据转发自哪个 LSQ 条目（-1 表示读自内存）
+    bool executed = false;
+    int fwd_lsq = -1;
+
     int rob_idx = -1;
     DestReg dest = std::monostate{};
     bool committed = false;
@@ -171,17 +285,28 @@ extern int lsq_tail;
 extern int lsq_count;
 
 extern std::vector<Instruction> instruction_queue;
-extern size_t next_fetch_idx;
+extern size_t next_fetch_idx;    // 取指位置（指令下标）
+extern size_t next_fetch_branch; // 重定向目标
+extern bool fetch_redirect;      // 本周期需要重定向取指
+extern bool fetch_barrier;       // 分支 / JALR 未解析前停止取指
 
 std::string get_rs_id(const std::string& type, int idx);
 bool is_alu_op(OpType op);
 bool is_muldiv_op(OpType op);
 bool is_load_op(OpType op);
 bool is_store_op(OpType op);
+bool is_branch_op(OpType op);
 bool is_fp_add_op(OpType op);
 bool is_fp_mul_op(OpType op);
 bool is_fp_div_op(OpType op);
+bool is_fp_fma_op(OpType op);
+bool is_vec_arith_op(OpType op);
+bool is_vec_load_op(OpType op);
+bool is_vec_store_op(OpType op);
+bool is_vec_op(OpType op);
 int get_latency(OpType op);
+int get_vec_latency(OpType op, uint64_t vl);
+std::string format_operand_value(const OperandValue& val);
 
 inline uint64_t to_int(const OperandValue& v) {
     if (auto* i = std::get_if<uint64_t>(&v)) return *i;
@@ -191,6 +316,10 @@ inline double to_fp(const OperandValue& v) {
     if (auto* f = std::get_if<double>(&v)) return *f;
     throw std::runtime_error("Expected double in OperandValue");
 }
+inline const VecData& to_vec(const OperandValue& v) {
+    if (auto* d = std::get_if<VecData>(&v)) return *d;
+    throw std::runtime_error("Expected vector in OperandValue");
+}
 
 // memory and regs
 struct RegisterInitData {
@@ -203,6 +332,17 @@ struct MemoryInitData {
     std::vector<std::pair<uint64_t, double>> fp_data;
 };
 
+// 详细模拟推进一个周期；enable_fetch 为 false 时不再取指，只排空流水线
+void simulate_cycle(bool enable_fetch, bool print);
+// 功能模拟一条指令（流水线须为空），程序结束返回 false
+bool functional_step();
+
+// 复位全部模拟器状态并装入程序与初值
+void sim_init(const std::vector<Instruction>& instructions, const MemoryInitData& mem_init = {}, const RegisterInitData& reg_init = {});
+// 打印非零内存内容
+void print_memory(std::ostream& os);
 
 void simulate(const std::vector<Instruction>& instructions, const MemoryInitData& mem_init = {}, const RegisterInitData& reg_init = {}, bool ENABLE_CYCLE_PRINT = false);
+// trace 驱动模拟：前端消费提交指令 trace（见 trace.h），只报告时序统计
+void simulate_trace(const std::string& path, bool ENABLE_CYCLE_PRINT = false);
 #endif
\ No newline at end of file
@@ -0,0 +1,338 @@
+// src/trace.cpp
+#include "trace.h"
+#include "sim_stats.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+const char TRACE_MAGIC[5] = {'T', 'M', 'T', 'R', 1};
+
+enum : uint8_t {
+    TR_ADDR = 1,
+    TR_TAKEN = 2,
+    TR_JUMP = 4,
+    TR_RAW = 8,
+    TR_VALUE = 16,
+    TR_DATA = 32,
+};
+
+static void put_varint(std::string& out, uint64_t v) {
+    while (v >= 0x80) {
+        out += static_cast<char>((v & 0x7F) | 0x80);
+        v >>= 7;
+    }
+    out += static_cast<char>(v);
+}
+
+static uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+// 读一个 varint；数据不完整返回 false
+static bool get_varint(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (p == end) return false;
+        uint8_t b = *p++;
+        v |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    throw std::runtime_error("corrupt trace: varint too long");
+}
+
+void TraceCodec::encode(const TraceRecord& r, std::string& out) {
+    uint64_t expect = started ? prev_pc + 4 : 0;
+    int slot = static_cast<int>((r.pc >> 2) % RAW_CACHE);
+    uint8_t flags = 0;
+    if (r.has_addr) flags |= TR_ADDR;
+    if (r.taken) flags |= TR_TAKEN;
+    if (r.pc != expect) flags |= TR_JUMP;
+    if (cache_pc[slot] != r.pc || cache_raw[slot] != r.raw) flags |= TR_RAW;
+    if (r.has_value) flags |= TR_VALUE;
+    if (r.has_data) flags |= TR_DATA;
+    out += static_cast<char>(flags);
+    if (flags & TR_JUMP) put_varint(out, zigzag(static_cast<int64_t>(r.pc - expect)));
+    if (flags & TR_RAW) put_varint(out, r.raw);
+    if (flags & TR_ADDR) put_varint(out, zigzag(static_cast<int64_t>(r.addr - prev_addr)));
+    if (flags & TR_VALUE) {
+        out += static_cast<char>(r.dest);
+        put_varint(out, zigzag(static_cast<int64_t>(r.value - last_value[r.dest])));
+        last_value[r.dest] = r.value;
+    }
+    if (flags & TR_DATA) put_varint(out, zigzag(static_cast<int64_t>(r.data - prev_data)));
+
+    prev_pc = r.pc;
+    if (r.has_addr) prev_addr = r.addr;
+    if (r.has_data) prev_data = r.data;
+    started = true;
+    cache_pc[slot] = r.pc;
+    cache_raw[slot] = r.raw;
+}
+
+size_t TraceCodec::decode(const uint8_t* p, const uint8_t* end, TraceRecord& r) {
+    const uint8_t* start = p;
+    if (p == end) return 0;
+    uint8_t flags = *p++;
+    if (flags & ~(TR_ADDR | TR_TAKEN | TR_JUMP | TR_RAW | TR_VALUE | TR_DATA)) {
+        throw std::runtime_error("corrupt trace: bad flags");
+    }
+    uint64_t pc_delta = 0, raw = 0, addr_delta = 0, value_delta = 0, data_delta = 0;
+    uint8_t dest = 0;
+    if ((flags & TR_JUMP) && !get_varint(p, end, pc_delta)) return 0;
+    if ((flags & TR_RAW) && !get_varint(p, end, raw)) return 0;
+    if ((flags & TR_ADDR) && !get_varint(p, end, addr_delta)) return 0;
+    if (flags & TR_VALUE) {
+        if (p == end) return 0;
+        dest = *p++;
+        if (dest >= 64) throw std::runtime_error("corrupt trace: bad register");
+        if (!get_varint(p, end, value_delta)) return 0;
+    }
+    if ((flags & TR_DATA) && !get_varint(p, end, data_delta)) return 0;
+
+    r.pc = (started ? prev_pc + 4 : 0) + static_cast<uint64_t>(unzigzag(pc_delta));
+    int slot = static_cast<int>((r.pc >> 2) % RAW_CACHE);
+    r.raw = (flags & TR_RAW) ? static_cast<uint32_t>(raw) : cache_raw[slot];
+    r.has_addr = flags & TR_ADDR;
+    r.taken = flags & TR_TAKEN;
+    r.addr = r.has_addr ? prev_addr + static_cast<uint64_t>(unzigzag(addr_delta)) : 0;
+    r.has_value = flags & TR_VALUE;
+    r.dest = dest;
+    r.value = r.has_value ? last_value[dest] + static_cast<uint64_t>(unzigzag(value_delta)) : 0;
+    r.has_data = flags & TR_DATA;
+    r.data = r.has_data ? prev_data + static_cast<uint64_t>(unzigzag(data_delta)) : 0;
+
+    prev_pc = r.pc;
+    if (r.has_addr) prev_addr = r.addr;
+    if (r.has_value) last_value[dest] = r.value;
+    if (r.has_data) prev_data = r.data;
+    started = true;
+    cache_pc[slot] = r.pc;
+    cache_raw[slot] = r.raw;
+    return static_cast<size_t>(p - start);
+}
+
+// --- 后台解压线程与有界批次队列 ---
+static constexpr size_t TRACE_BATCH = 4096;       // 每批记录数
+static constexpr size_t TRACE_QUEUE_BATCHES = 4;  // 队列中最多的批数
+static constexpr size_t TRACE_READ_BLOCK = 1 << 16;
+
+static std::thread reader;
+static std::mutex mu;
+static std::condition_variable cv;
+static std::deque<std::vector<TraceRecord>> batches;
+static bool reader_done = false;
+static bool reader_stop = false;
+static std::string reader_error;
+static uint64_t reader_bytes = 0;
+static bool active = false;
+
+// 前端一侧：当前批次与可重新取指的记录窗口
+static std::vector<TraceRecord> cur;
+static size_t cur_pos = 0;
+static std::deque<TraceRecord> window;
+static uint64_t window_base = 0;
+
+static bool push_batch(std::vector<TraceRecord>& batch) {
+    std::unique_lock<std::mutex> lock(mu);
+    cv.wait(lock, [] { return reader_stop || batches.size() < TRACE_QUEUE_BATCHES; });
+    if (reader_stop) return false;
+    batches.push_back(std::move(batch));
+    cv.notify_all();
+    batch.clear();
+    batch.reserve(TRACE_BATCH);
+    return true;
+}
+
+static void reader_main(std::string path) {
+    try {
+        std::ifstream in(path, std::ios::binary);
+        char magic[sizeof(TRACE_MAGIC)];
+        if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), TRACE_MAGIC)) {
+            throw std::runtime_error("not a trace file: " + path);
+        }
+        uint64_t bytes = sizeof(magic);
+        TraceCodec codec;
+        std::vector<uint8_t> buf;
+        size_t pos = 0;
+        std::vector<TraceRecord> batch;
+        batch.reserve(TRACE_BATCH);
+        bool eof = false;
+        while (true) {
+            TraceRecord r;
+            size_t n = codec.decode(buf.data() + pos, buf.data() + buf.size(), r);
+            if (n == 0) {
+                if (eof) {
+                    if (pos != buf.size()) throw std::runtime_error("truncated trace: " + path);
+                    break;
+                }
+                // 剩余的不完整记录移到缓冲开头，再读一块
+                buf.erase(buf.begin(), buf.begin() + pos);
+                pos = 0;
+                size_t old = buf.size();
+                buf.resize(old + TRACE_READ_BLOCK);
+                in.read(reinterpret_cast<char*>(buf.data() + old), TRACE_READ_BLOCK);
+                buf.resize(old + static_cast<size_t>(in.gcount()));
+                bytes += static_cast<uint64_t>(in.gcount());
+                eof = in.gcount() == 0;
+                continue;
+            }
+            pos += n;
+            batch.push_back(r);
+            if (batch.size() == TRACE_BATCH && !push_batch(batch)) return;
+        }
+        if (!batch.empty() && !push_batch(batch)) return;
+        std::lock_guard<std::mutex> lock(mu);
+        reader_bytes = bytes;
+    } catch (const std::exception& e) {
+        std::lock_guard<std::mutex> lock(mu);
+        reader_error = e.what();
+    }
+    std::lock_guard<std::mutex> lock(mu);
+    reader_done = true;
+    cv.notify_all();
+}
+
+void trace_open(const std::string& path) {
+    trace_close();
+    std::ifstream probe(path, std::ios::binary);
+    if (!probe) throw std::runtime_error("Cannot open file: " + path);
+    reader_done = reader_stop = false;
+    reader_error.clear();
+    reader_bytes = 0;
+    cur.clear();
+    cur_pos = 0;
+    window.clear();
+    window_base = 0;
+    active = true;
+    reader = std::thread(reader_main, path);
+}
+
+void trace_close() {
+    if (reader.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            reader_stop = true;
+        }
+        cv.notify_all();
+        reader.join();
+        trace_stats.bytes = reader_bytes;
+    }
+    batches.clear();
+    window.clear();
+    cur.clear();
+    active = false;
+}
+
+bool trace_active() {
+    return active;
+}
+
+// 从队列取下一批；trace 已读完返回 false
+static bool next_batch() {
+    std::unique_lock<std::mutex> lock(mu);
+    cv.wait(lock, [] { return !batches.empty() || reader_done; });
+    if (!reader_error.empty()) throw std::runtime_error(reader_error);
+    if (batches.empty()) return false;
+    cur = std::move(batches.front());
+    batches.pop_front();
+    cur_pos = 0;
+    cv.notify_all();
+    return true;
+}
+
+const TraceRecord* trace_record(uint64_t seq) {
+    while (seq >= window_base + window.size()) {
+        if (cur_pos == cur.size() && !next_batch()) return nullptr;
+        const TraceRecord& r = cur[cur_pos++];
+        window.push_back(r);
+        trace_stats.records++;
+        if (r.taken) trace_stats.taken++;
+    }
+    return &window[seq - window_base];
+}
+
+void trace_retire(uint64_t seq) {
+    while (window_base < seq && !window.empty()) {
+        window.pop_front();
+        window_base++;
+    }
+}
+
+// --- trace 捕获：单生产者（模拟线程）/ 单消费者（写线程）无锁环形队列 ---
+static constexpr size_t WRITER_RING = 1 << 16;      // 2 的幂
+static constexpr size_t WRITER_FLUSH = 1 << 16;     // 编码缓冲达到该大小时写文件
+
+static std::vector<TraceRecord> ring(WRITER_RING);
+static std::atomic<size_t> ring_head{0};            // 写线程下一个要取的位置
+static std::atomic<size_t> ring_tail{0};            // 模拟线程下一个要放的位置
+static std::atomic<bool> writer_stop{false};
+static std::thread writer;
+static std::FILE* writer_file = nullptr;
+
+static void writer_main() {
+    TraceCodec codec;
+    std::string out;
+    out.reserve(WRITER_FLUSH * 2);
+    while (true) {
+        size_t h = ring_head.load(std::memory_order_relaxed);
+        size_t t = ring_tail.load(std::memory_order_acquire);
+        if (h == t) {
+            // 先看停止标志再确认队列为空，保证停止前放入的记录都被写出
+            if (writer_stop.load(std::memory_order_acquire) && t == ring_tail.load(std::memory_order_acquire)) break;
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            continue;
+        }
+        for (; h != t; ++h) codec.encode(ring[h & (WRITER_RING - 1)], out);
+        ring_head.store(h, std::memory_order_release);
+        if (out.size() >= WRITER_FLUSH) {
+            std::fwrite(out.data(), 1, out.size(), writer_file);
+            out.clear();
+        }
+    }
+    std::fwrite(out.data(), 1, out.size(), writer_file);
+}
+
+void trace_writer_open(const std::string& path) {
+    trace_writer_close();
+    writer_file = std::fopen(path.c_str(), "wb");
+    if (!writer_file) throw std::runtime_error("Cannot open file: " + path);
+    std::fwrite(TRACE_MAGIC, 1, sizeof(TRACE_MAGIC), writer_file);
+    ring_head.store(0);
+    ring_tail.store(0);
+    writer_stop.store(false);
+    writer = std::thread(writer_main);
+}
+
+void trace_writer_close() {
+    if (!writer.joinable()) return;
+    writer_stop.store(true, std::memory_order_release);
+    writer.join();
+    std::fclose(writer_file);
+    writer_file = nullptr;
+}
+
+bool trace_writer_active() {
+    return writer.joinable();
+}
+
+void trace_write(const TraceRecord& r) {
+    size_t t = ring_tail.load(std::memory_order_relaxed);
+    if (t - ring_head.load(std::memory_order_acquire) == WRITER_RING) {
+        trace_stats.queue_full++;
+        while (t - ring_head.load(std::memory_order_acquire) == WRITER_RING) std::this_thread::yield();
+    }
+    ring[t & (WRITER_RING - 1)] = r;
+    ring_tail.store(t + 1, std::memory_order_release);
+    trace_stats.written++;
+}
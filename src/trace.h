@@ -0,0 +1,71 @@
+// src/trace.h
+#ifndef TRACE_H
+#define TRACE_H
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 提交指令 trace：捕获（--trace_out=FILE）与 trace 驱动模拟（--trace=FILE）。
+// 捕获时每条提交的指令写一条记录，由后台线程经无锁单生产者 / 单消费者环形队列取走、编码并写文件。
+// trace 驱动模式下前端不再从 instruction_queue 取指，而是按序消费记录：PC、指令字、访存地址、分支结果。
+// 控制流与访存地址取自记录，寄存器值只作为数据流的令牌，不决定时序。
+//
+// 文件格式：4 字节魔数 "TMTR"、1 字节版本，之后每条记录：
+//   flags (1 字节)  bit0 有访存地址  bit1 分支 / 跳转发生  bit2 PC 不连续  bit3 指令字与上次同 PC 不同
+//                   bit4 有目的寄存器值  bit5 有 store 数据
+//   [bit2] zigzag varint：pc - (上一条 pc + 4)
+//   [bit3] varint：指令字
+//   [bit0] zigzag varint：addr - 上一个访存地址
+//   [bit4] 1 字节目的寄存器（0~31 整数，32~63 浮点）+ zigzag varint：值 - 该寄存器上次记录的值
+//   [bit5] zigzag varint：data - 上一个 store 数据
+// 指令字按 PC 缓存在编码器和解码器共有的直接映射表中，循环体的记录通常只有 1~2 字节（不计值）
+
+struct TraceRecord {
+    uint64_t pc = 0;
+    uint32_t raw = 0;
+    bool has_addr = false;
+    bool taken = false;
+    uint64_t addr = 0;
+    bool has_value = false;
+    uint8_t dest = 0;     // 0~31 整数寄存器，32~63 浮点寄存器（值为位模式）
+    uint64_t value = 0;
+    bool has_data = false;
+    uint64_t data = 0;    // store 写入的数据（按访存宽度截断后的值 / 浮点位模式）
+};
+
+// 编码 / 解码两端共有的状态
+struct TraceCodec {
+    static constexpr int RAW_CACHE = 4096;
+    uint64_t prev_pc = 0;
+    uint64_t prev_addr = 0;
+    uint64_t prev_data = 0;
+    uint64_t last_value[64] = {};
+    bool started = false;
+    uint64_t cache_pc[RAW_CACHE] = {};
+    uint32_t cache_raw[RAW_CACHE] = {};
+
+    void encode(const TraceRecord& r, std::string& out);
+    // 从 [p, end) 解码一条记录，返回读过的字节数；数据不完整返回 0
+    size_t decode(const uint8_t* p, const uint8_t* end, TraceRecord& r);
+};
+
+extern const char TRACE_MAGIC[5];
+
+// trace 驱动模式：打开文件并启动后台解压线程，记录经有界队列交给前端
+void trace_open(const std::string& path);
+void trace_close();
+bool trace_active();
+// 序号为 seq 的记录；trace 已结束返回 nullptr。违例冲刷后前端从更早的序号重新取指，
+// 因此保留最老在途指令之后的记录
+const TraceRecord* trace_record(uint64_t seq);
+// 序号小于 seq 的记录不会再被取指，可以丢弃
+void trace_retire(uint64_t seq);
+
+// trace 捕获：打开文件并启动后台写线程；trace_write 只把记录放进环形队列，队列满时等待写线程
+void trace_writer_open(const std::string& path);
+// 写完队列中剩余的记录并关闭文件
+void trace_writer_close();
+bool trace_writer_active();
+void trace_write(const TraceRecord& r);
+
+#endif
@@ -1,29 +1,223 @@
-// src/main.cpp
+// src/translator.cpp
 #include "instruction.h"
-#include <vector>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
-#include <iomanip>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern Instruction decode_instruction(uint32_t inst_word);
+
+// 流式反汇编：文件经 mmap 映射，按 chunk 条指令分块，由多个线程并行译码并格式化到预分配的缓冲中，
+// 主线程按块顺序输出。缓冲槽数固定（线程数的两倍），已输出部分的映射页随即归还，
+// 内存占用与文件大小无关
+
+static void print_usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [options] <program.bin>\n"
+              << "  --range=START:END   只输出地址在 [START, END) 内的指令（字节地址，可用 0x 前缀，END 可省略）\n"
+              << "  --threads=N         译码线程数（默认按 CPU 数）\n"
+              << "  --chunk=N           每块指令数（默认 65536）\n";
+}
+
+// 只读映射整个文件
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open file: " + path);
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw std::runtime_error("Cannot stat file: " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0) {
+            void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("Cannot map file: " + path);
+            }
+            data_ = static_cast<const uint8_t*>(p);
+            madvise(p, size_, MADV_SEQUENTIAL);
+        }
+        close(fd);
+    }
+    ~MappedFile() {
+        if (data_) munmap(const_cast<uint8_t*>(data_), size_);
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    // 归还 [from, to) 内整页的物理内存；之后再访问会重新从文件读入
+    void release(size_t from, size_t to) const {
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t begin = (from + page - 1) / page * page;
+        size_t end = to / page * page;
+        if (data_ && end > begin) madvise(const_cast<uint8_t*>(data_) + begin, end - begin, MADV_DONTNEED);
+    }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+static void append_hex(std::string& out, uint64_t v, int width) {
+    static const char digits[] = "0123456789abcdef";
+    char buf[16];
+    int n = 0;
+    do {
+        buf[n++] = digits[v & 0xF];
+        v >>= 4;
+    } while (v);
+    for (int i = n; i < width; ++i) out += '0';
+    while (n > 0) out += buf[--n];
+}
+
+// 一行："[idx] 0xRAW : asm"。与原先逐条 iostream 输出逐字节一致：
+// 第一行在切换到十六进制之前打印，序号是十进制、空格补齐，之后各行序号为十六进制、补 0
+static void format_line(std::string& out, size_t idx, uint32_t word, bool first_line) {
+    out += '[';
+    if (first_line) {
+        std::string dec = std::to_string(idx);
+        if (dec.size() < 2) out += ' ';
+        out += dec;
+    } else {
+        append_hex(out, idx, 2);
+    }
+    out += "] 0x";
+    append_hex(out, word, 8);
+    out += " : ";
+    Instruction inst = decode_instruction(word);
+    inst.pc = idx * 4;
+    out += inst.toString();
+    out += '\n';
+}
 
-std::vector<Instruction> load_instructions_from_bin(const std::string& filename);
+struct Slot {
+    std::string text;
+    bool ready = false;
+};
+
+static void translate(const MappedFile& file, size_t first, size_t last, size_t chunk, int threads) {
+    const uint8_t* bytes = file.data();
+    size_t nchunks = (last - first + chunk - 1) / chunk;
+    std::vector<Slot> slots(static_cast<size_t>(threads) * 2);
+    for (auto& s : slots) s.text.reserve(chunk * 48);
+
+    std::mutex mu;
+    std::condition_variable cv;
+    size_t next_chunk = 0;   // 下一个待领取的块
+    size_t written = 0;      // 已输出的块
+
+    auto worker = [&]() {
+        while (true) {
+            std::unique_lock<std::mutex> lock(mu);
+            size_t c = next_chunk++;
+            if (c >= nchunks) return;
+            // 槽位被 c - slots.size() 占用时等它输出
+            cv.wait(lock, [&] { return c < written + slots.size(); });
+            lock.unlock();
+
+            Slot& slot = slots[c % slots.size()];
+            slot.text.clear();
+            size_t begin = first + c * chunk;
+            size_t end = std::min(last, begin + chunk);
+            for (size_t i = begin; i < end; ++i) {
+                const uint8_t* p = bytes + i * 4;
+                uint32_t word = static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+                                (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+                format_line(slot.text, i, word, i == first);
+            }
+
+            lock.lock();
+            slot.ready = true;
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) pool.emplace_back(worker);
+
+    size_t released = first * 4;
+    for (size_t c = 0; c < nchunks; ++c) {
+        Slot& slot = slots[c % slots.size()];
+        {
+            std::unique_lock<std::mutex> lock(mu);
+            cv.wait(lock, [&] { return slot.ready; });
+        }
+        std::fwrite(slot.text.data(), 1, slot.text.size(), stdout);
+        size_t done = std::min(last, first + (c + 1) * chunk) * 4;
+        file.release(released, done);
+        released = done;
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            slot.ready = false;
+            written++;
+        }
+        cv.notify_all();
+    }
+    for (auto& t : pool) t.join();
+}
 
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <program.bin>\n";
+    std::string program;
+    uint64_t range_start = 0, range_end = UINT64_MAX;
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+    size_t chunk = 65536;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.rfind("--range=", 0) == 0) {
+                std::string r = arg.substr(8);
+                size_t colon = r.find(':');
+                if (colon == std::string::npos) throw std::invalid_argument(arg);
+                range_start = std::stoull(r.substr(0, colon), nullptr, 0);
+                if (colon + 1 < r.size()) range_end = std::stoull(r.substr(colon + 1), nullptr, 0);
+            } else if (arg.rfind("--threads=", 0) == 0) {
+                threads = std::stoi(arg.substr(10));
+            } else if (arg.rfind("--chunk=", 0) == 0) {
+                chunk = std::stoull(arg.substr(8));
+                if (chunk == 0) throw std::invalid_argument(arg);
+            } else if (arg.rfind("--", 0) != 0 && program.empty()) {
+                program = arg;
+            } else {
+                throw std::invalid_argument(arg);
+            }
+        }
+    } catch (const std::exception&) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (program.empty()) {
+        print_usage(argv[0]);
         return 1;
     }
+    threads = std::max(threads, 1);
 
     try {
-        auto instructions = load_instructions_from_bin(argv[1]);
-        std::cout << "Loaded " << instructions.size() << " instructions:\n";
-        for (size_t i = 0; i < instructions.size(); ++i) {
-            std::cout << "[" << std::setw(2) << i << "] "
-                      << "0x" << std::hex << std::setfill('0') << std::setw(8) << instructions[i].raw
-                      << " : " << instructions[i].toString() << "\n";
-        }
+        MappedFile file(program);
+        size_t count = file.size() / 4;
+        // START 向下、END 向上对齐到指令边界
+        size_t first = static_cast<size_t>(std::min<uint64_t>(range_start / 4, count));
+        size_t last = static_cast<size_t>(std::min<uint64_t>(range_end / 4 + (range_end % 4 != 0), count));
+        last = std::max(first, last);
+        std::cout << "Loaded " << last - first << " instructions:\n";
+        translate(file, first, last, chunk, threads);
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << "\n";
         return 1;
     }
 
     return 0;
-}
\ No newline at end of file
+}
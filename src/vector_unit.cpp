@@ -0,0 +1,62 @@
+// src/vector_unit.cpp
+#include "vector_unit.h"
+#include <cmath>
+#include <experimental/simd>
+
+namespace stdx = std::experimental;
+
+// 主体按宿主机原生 SIMD 宽度处理，剩余不足一组的元素走标量
+template <typename T, typename Fn>
+static void apply_binary(T* d, const T* a, const T* b, size_t n, Fn fn) {
+    using V = stdx::native_simd<T>;
+    size_t i = 0;
+    for (; i + V::size() <= n; i += V::size()) {
+        V x(a + i, stdx::element_aligned);
+        V y(b + i, stdx::element_aligned);
+        V r = fn(x, y);
+        r.copy_to(d + i, stdx::element_aligned);
+    }
+    for (; i < n; ++i) d[i] = fn(a[i], b[i]);
+}
+
+template <typename T, typename Fn>
+static void apply_ternary(T* d, const T* a, const T* b, size_t n, Fn fn) {
+    using V = stdx::native_simd<T>;
+    size_t i = 0;
+    for (; i + V::size() <= n; i += V::size()) {
+        V x(a + i, stdx::element_aligned);
+        V y(b + i, stdx::element_aligned);
+        V z(d + i, stdx::element_aligned);
+        V r = fn(x, y, z);
+        r.copy_to(d + i, stdx::element_aligned);
+    }
+    for (; i < n; ++i) d[i] = fn(a[i], b[i], d[i]);
+}
+
+void vec_add_u64(uint64_t* d, const uint64_t* a, const uint64_t* b, size_t n) {
+    apply_binary(d, a, b, n, [](auto x, auto y) { return x + y; });
+}
+
+void vec_mul_u64(uint64_t* d, const uint64_t* a, const uint64_t* b, size_t n) {
+    apply_binary(d, a, b, n, [](auto x, auto y) { return x * y; });
+}
+
+void vec_macc_u64(uint64_t* d, const uint64_t* a, const uint64_t* b, size_t n) {
+    apply_ternary(d, a, b, n, [](auto x, auto y, auto z) { return x * y + z; });
+}
+
+void vec_fadd_f64(double* d, const double* a, const double* b, size_t n) {
+    apply_binary(d, a, b, n, [](auto x, auto y) { return x + y; });
+}
+
+void vec_fmul_f64(double* d, const double* a, const double* b, size_t n) {
+    apply_binary(d, a, b, n, [](auto x, auto y) { return x * y; });
+}
+
+// vfmacc 是融合乘加（只舍入一次），必须用 fma 而不是 x * y + z
+void vec_fmacc_f64(double* d, const double* a, const double* b, size_t n) {
+    apply_ternary(d, a, b, n, [](auto x, auto y, auto z) {
+        using std::fma;
+        return fma(x, y, z);
+    });
+}
@@ -0,0 +1,17 @@
+// src/vector_unit.h
+#ifndef VECTOR_UNIT_H
+#define VECTOR_UNIT_H
+#include <cstddef>
+#include <cstdint>
+
+// 向量元素运算内核：在宿主机上用 SIMD 一次处理多个元素，n 为当前 vl
+// 乘加形式统一为 d[i] = a[i] * b[i] + d[i]
+void vec_add_u64(uint64_t* d, const uint64_t* a, const uint64_t* b, size_t n);
+void vec_mul_u64(uint64_t* d, const uint64_t* a, const uint64_t* b, size_t n);
+void vec_macc_u64(uint64_t* d, const uint64_t* a, const uint64_t* b, size_t n);
+
+void vec_fadd_f64(double* d, const double* a, const double* b, size_t n);
+void vec_fmul_f64(double* d, const double* a, const double* b, size_t n);
+void vec_fmacc_f64(double* d, const double* a, const double* b, size_t n);
+
+#endif
@@ -3,6 +3,7 @@
 # Build all C test cases in src/ into:
 #   - .bin : raw binary instruction stream (for your simulator)
 #   - .dis : human-readable disassembly (for debugging)
+#   - .sym : symbol addresses from nm (batch mode), to find globals in the final memory
 #
 # Usage:
 #   ./build.sh                    # batch build all .c in src/
@@ -98,6 +99,7 @@ for cfile in "$SRC_DIR"/*.c; do
     elf_file="$OUT_DIR/$base.elf"
     bin_file="$OUT_DIR/$base.bin"
     dis_file="$OUT_DIR/$base.dis"
+    sym_file="$OUT_DIR/$base.sym"
 
     echo "  Processing $base.c"
 
@@ -117,6 +119,8 @@ for cfile in "$SRC_DIR"/*.c; do
 
     "${TOOLCHAIN_PREFIX}-objcopy" -O binary --only-section=.text "$elf_file" "$bin_file"
     "${TOOLCHAIN_PREFIX}-objdump" -d "$elf_file" > "$dis_file"
+    # Global variable addresses, to locate expected results in the final memory dump
+    "${TOOLCHAIN_PREFIX}-nm" -n "$elf_file" > "$sym_file"
 
     rm -f "$obj_file" "$elf_file"
 done
@@ -129,5 +133,6 @@ echo
 echo "   Done. Outputs in $OUT_DIR/:"
 echo "   .bin  → raw instruction bytes (little-endian, 32-bit words)"
 echo "   .dis  → disassembled instructions (human readable)"
+echo "   .sym  → symbol addresses (where each global lands in memory)"
 echo
 ls -l "$OUT_DIR"/*.bin "$OUT_DIR"/*.dis 2>/dev/null || echo "No output files."
\ No newline at end of file
@@ -0,0 +1,21 @@
+// tests/src/loop_sum.c
+// .data is not loaded into simulator memory, so the input array is filled in code.
+// Expected final memory: data[0..7] = 1..8, sum = 36, count_big = 4
+// Variable addresses depend on the build; build.sh lists them in tests/bin/loop_sum.sym
+long data[8];
+long sum;
+long count_big;
+
+void _start(void) {
+    for (long i = 0; i < 8; i++)
+        data[i] = i + 1;
+    long s = 0;
+    long big = 0;
+    for (long i = 0; i < 8; i++) {   // backward BLT/BGE loop branch
+        s += data[i];
+        if (data[i] > 4)             // forward conditional branch
+            big++;
+    }
+    sum = s;
+    count_big = big;
+}
@@ -0,0 +1,31 @@
+// tests/src/word_ops.c
+// .data is not loaded into simulator memory, so the inputs are stored in code.
+// mix() is defined after _start because execution starts at the first instruction.
+// Expected final memory: wq = -22 (stored as 4294967274), wr = 536870911, bsum = 384
+// Variable addresses depend on the build; build.sh lists them in tests/bin/word_ops.sym
+int wa;
+int wb;
+unsigned char bytes[4];
+int wq, wr;
+long bsum;
+
+static int mix(int x, int y);
+
+void _start(void) {
+    wa = -7;
+    wb = 3;
+    bytes[0] = 250;                  // SB
+    bytes[1] = 5;
+    bytes[2] = 128;
+    bytes[3] = 1;
+    wq = mix(wa, wb);                // MULW / DIVW / REMW / ADDW / SUBW
+    wr = (unsigned)wa >> 3;          // SRLIW
+    long s = 0;
+    for (int i = 0; i < 4; i++)
+        s += bytes[i];               // LBU in a loop
+    bsum = s;
+}
+
+static int mix(int x, int y) {       // JAL / JALR call and return
+    return (x * y) + (x / y) - (x % y);
+}